@@ -0,0 +1,85 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+// 统计operator new的次数与内存，给性能测试用
+// 替换全局的operator new / delete: 每块内存前放一个头记录大小，计数是原子的，多个线程可以同时分配
+// 替换函数不能是inline的，一个程序只能有一份定义，所以只能被一个源文件(性能测试的main所在文件)包含
+//
+// ******************PUBLIC OPERATIONS*********************
+// void reset( )              --> Zero the allocation count, restart the peak from the bytes in use
+// size_t allocations( )      --> Return the calls to operator new since reset
+// size_t liveBytes( )        --> Return the bytes currently allocated
+// size_t peakBytes( )        --> Return the peak of liveBytes since reset
+
+namespace DS
+{
+    class AllocCounter
+    {
+    public:
+        static void reset()
+        {
+            n_allocs_.store(0);
+            peak_bytes_.store(live_bytes_.load());
+        }
+
+        static std::size_t allocations()
+        { return n_allocs_.load(); }
+
+        static std::size_t liveBytes()
+        { return live_bytes_.load(); }
+
+        static std::size_t peakBytes()
+        { return peak_bytes_.load(); }
+
+        // 只由operator new / delete调用
+        static void* allocate(std::size_t size)
+        {
+            char* p = static_cast<char*>(malloc(size + HEADER));
+            if(p == nullptr)
+                throw std::bad_alloc();
+            *reinterpret_cast<std::size_t*>(p) = size;
+            n_allocs_.fetch_add(1, std::memory_order_relaxed);
+            std::size_t live = live_bytes_.fetch_add(size) + size;
+            std::size_t peak = peak_bytes_.load();
+            while(live > peak && !peak_bytes_.compare_exchange_weak(peak, live))
+                ;
+            return p + HEADER;
+        }
+
+        static void release(void* ptr)
+        {
+            if(ptr == nullptr)
+                return;
+            char* p = static_cast<char*>(ptr) - HEADER;
+            live_bytes_.fetch_sub(*reinterpret_cast<std::size_t*>(p));
+            free(p);
+        }
+
+    private:
+        static const std::size_t HEADER = 16; // 保持malloc返回的16字节对齐
+
+        static std::atomic<std::size_t> n_allocs_;
+        static std::atomic<std::size_t> live_bytes_;
+        static std::atomic<std::size_t> peak_bytes_;
+    };
+
+    std::atomic<std::size_t> AllocCounter::n_allocs_(0);
+    std::atomic<std::size_t> AllocCounter::live_bytes_(0);
+    std::atomic<std::size_t> AllocCounter::peak_bytes_(0);
+}
+
+void* operator new(std::size_t size)
+{ return DS::AllocCounter::allocate(size); }
+
+void operator delete(void* ptr) noexcept
+{ DS::AllocCounter::release(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept
+{ DS::AllocCounter::release(ptr); }
+
+#endif //ALLOC_COUNTER_H
@@ -0,0 +1,168 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 基于纪元(epoch)的内存回收，用于无锁数据结构
+// 线程访问共享节点前用Epoch::Guard登记当前的全局纪元，离开时注销
+// 从结构中摘下的节点用Epoch::retire延迟释放:
+// 节点在纪元e被摘下，之后开始访问的线程都看不到它；
+// 全局纪元只有在所有登记中的线程都已看到当前纪元时才能前进，
+// 因此全局纪元到达e + 2时，可能持有该节点的线程都已离开，可以释放
+//
+// 每个线程有自己的记录(登记的纪元和待释放列表)，记录放在全局链表中，线程退出后由新线程复用
+
+namespace DS
+{
+    class Epoch
+    {
+    private:
+        static const uint64_t ACTIVE = 1;
+        static const std::size_t COLLECT_THRESHOLD = 128;
+
+        struct Retired
+        {
+            void* p_;
+            void (*deleter_)(void*);
+            uint64_t epoch_;
+        };
+
+        struct Record
+        {
+            std::atomic<uint64_t> local_; // (纪元 << 1) | ACTIVE，未登记时为0
+            char pad_[64 - sizeof(std::atomic<uint64_t>)]; // 避免与其它线程的记录共享缓存行
+            std::atomic<bool> in_use_;
+            Record* next_;
+            int nesting_;
+            std::vector<Retired> retired_; // 按纪元递增
+
+            Record()
+            : local_{0}, in_use_{true}, next_{nullptr}, nesting_{0}
+            {}
+        };
+
+    public:
+        // 作用域内当前线程处于登记状态，可以嵌套
+        class Guard
+        {
+        public:
+            Guard()
+            : record_{localRecord()}
+            {
+                if(record_->nesting_++ == 0)
+                    record_->local_.store(globalEpoch().load() << 1 | ACTIVE);
+            }
+
+            ~Guard()
+            {
+                if(--record_->nesting_ == 0)
+                    record_->local_.store(0, std::memory_order_release);
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+        private:
+            Record* record_;
+        };
+
+        // p已经从结构中摘下，等到没有线程能访问时调用deleter(p)
+        static void retire(void* p, void (*deleter)(void*))
+        {
+            Record* record = localRecord();
+            record->retired_.push_back(Retired{p, deleter, globalEpoch().load()});
+            if(record->retired_.size() >= COLLECT_THRESHOLD)
+                collect(record);
+        }
+
+        // 尽量推进纪元并释放当前线程可以释放的节点
+        static void collect()
+        { collect(localRecord()); }
+
+        // 当前线程retire之后还没有释放的节点数
+        static std::size_t pending()
+        { return localRecord()->retired_.size(); }
+
+    private:
+        static std::atomic<uint64_t>& globalEpoch()
+        {
+            static std::atomic<uint64_t> epoch{0};
+            return epoch;
+        }
+
+        static std::atomic<Record*>& records()
+        {
+            static std::atomic<Record*> head{nullptr};
+            return head;
+        }
+
+        // 复用已退出线程的记录，没有则新建并加入链表
+        static Record* acquireRecord()
+        {
+            for(Record* r = records().load(); r != nullptr; r = r->next_)
+            {
+                bool expected = false;
+                if(!r->in_use_.load(std::memory_order_relaxed) && r->in_use_.compare_exchange_strong(expected, true))
+                    return r;
+            }
+            Record* r = new Record;
+            Record* head = records().load();
+            do
+                r->next_ = head;
+            while(!records().compare_exchange_weak(head, r));
+            return r;
+        }
+
+        // 线程退出时归还记录，未释放的节点留给下一个使用者
+        struct LocalHolder
+        {
+            Record* record_;
+
+            LocalHolder()
+            : record_{acquireRecord()}
+            {}
+
+            ~LocalHolder()
+            {
+                collect(record_);
+                record_->in_use_.store(false, std::memory_order_release);
+            }
+        };
+
+        static Record* localRecord()
+        {
+            static thread_local LocalHolder holder;
+            return holder.record_;
+        }
+
+        // 所有登记中的线程都已看到当前纪元时，纪元加一
+        static void tryAdvance()
+        {
+            uint64_t epoch = globalEpoch().load();
+            for(Record* r = records().load(); r != nullptr; r = r->next_)
+            {
+                uint64_t local = r->local_.load();
+                if((local & ACTIVE) && (local >> 1) != epoch)
+                    return;
+            }
+            globalEpoch().compare_exchange_strong(epoch, epoch + 1);
+        }
+
+        static void collect(Record* record)
+        {
+            tryAdvance();
+            uint64_t epoch = globalEpoch().load();
+            std::size_t n = 0;
+            while(n < record->retired_.size() && record->retired_[n].epoch_ + 2 <= epoch)
+                ++n;
+            for(std::size_t i = 0; i < n; ++i)
+                record->retired_[i].deleter_(record->retired_[i].p_);
+            record->retired_.erase(record->retired_.begin(), record->retired_.begin() + n);
+        }
+    };
+}
+
+#endif //EPOCH_H
@@ -0,0 +1,185 @@
+#ifndef FORK_JOIN_H
+#define FORK_JOIN_H
+
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// 简单的fork-join递归并行
+// 递归的前depth层把两个子问题中的一个交给新线程，depth层以下串行执行
+// depth = forkDepth(n_threads) 时最多同时有约n_threads个线程
+//
+// parallelFor( n_threads, total, body )
+// [0, total)平均分成n_threads段，第id段调用body(id, begin, end)，当前线程执行第0段
+//
+// grainThreads( n_threads, total, grain )
+// 每个线程至少分到grain个元素时的线程数(1 ~ n_threads)，元素少时不值得唤醒其他线程
+//
+// WorkerTeam
+// 常驻的一组线程，用于一轮接一轮的并行循环(BFS的每一层、delta-stepping的每个桶)，
+// 每轮不再创建和销毁线程；team.parallelFor与上面的parallelFor相同，返回时所有段都已完成，相当于一次屏障
+
+namespace DS
+{
+    // 不小于log2(n_threads)的最小整数
+    inline int forkDepth(unsigned n_threads)
+    {
+        int depth = 0;
+        while((1u << depth) < n_threads)
+            ++depth;
+        return depth;
+    }
+
+    template <typename Left, typename Right>
+    void forkJoin(int depth, Left left, Right right)
+    {
+        if(depth <= 0)
+        {
+            left();
+            right();
+            return;
+        }
+        std::thread worker(left);
+        right();
+        worker.join();
+    }
+
+    template <typename Body>
+    void parallelFor(unsigned n_threads, std::size_t total, Body body)
+    {
+        if(n_threads <= 1)
+        {
+            body(0u, std::size_t(0), total);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for(unsigned id = 1; id < n_threads; ++id)
+            threads.emplace_back([&body, id, n_threads, total]() {
+                body(id, total * id / n_threads, total * (id + 1) / n_threads);
+            });
+        body(0u, std::size_t(0), total / n_threads);
+        for(auto& th : threads)
+            th.join();
+    }
+
+    inline unsigned grainThreads(unsigned n_threads, std::size_t total, std::size_t grain)
+    { return static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(n_threads, total / grain))); }
+
+    // 成员0是调用parallelFor的线程，其余size() - 1个线程在两轮之间阻塞在条件变量上
+    // 同一时刻只能有一个线程调用parallelFor
+    class WorkerTeam
+    {
+    public:
+        explicit WorkerTeam(unsigned n_threads)
+        : size_{std::max(1u, n_threads)}
+        {
+            for(unsigned id = 1; id < size_; ++id)
+                workers_.emplace_back(&WorkerTeam::work, this, id);
+        }
+
+        WorkerTeam(const WorkerTeam&) = delete;
+        WorkerTeam& operator=(const WorkerTeam&) = delete;
+
+        ~WorkerTeam()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            start_.notify_all();
+            for(auto& th : workers_)
+                th.join();
+        }
+
+        unsigned size() const
+        { return size_; }
+
+        // 只用前n_threads个成员(不超过size())，n_threads <= 1时直接在当前线程执行
+        template <typename Body>
+        void parallelFor(unsigned n_threads, std::size_t total, Body body)
+        {
+            n_threads = std::min(n_threads, size_);
+            if(n_threads <= 1)
+            {
+                body(0u, std::size_t(0), total);
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                task_ = &invoke<Body>;
+                context_ = &body;
+                active_ = n_threads;
+                total_ = total;
+                pending_ = n_threads - 1;
+                ++round_;
+            }
+            start_.notify_all();
+            // body在当前线程的栈上，异常也要等其他成员做完再离开
+            try
+            {
+                body(0u, std::size_t(0), total / n_threads);
+            }
+            catch(...)
+            {
+                wait();
+                throw;
+            }
+            wait();
+        }
+
+    private:
+        typedef void (*Task)(void*, unsigned, std::size_t, std::size_t);
+
+        template <typename Body>
+        static void invoke(void* context, unsigned id, std::size_t begin, std::size_t end)
+        { (*static_cast<Body*>(context))(id, begin, end); }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this]() { return pending_ == 0; });
+        }
+
+        void work(unsigned id)
+        {
+            uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex_);
+            while(true)
+            {
+                start_.wait(lock, [this, seen]() { return stop_ || round_ != seen; });
+                if(stop_)
+                    return;
+                seen = round_;
+                if(id >= active_) // 这一轮用不到
+                    continue;
+                Task task = task_;
+                void* context = context_;
+                std::size_t begin = total_ * id / active_, end = total_ * (id + 1) / active_;
+                lock.unlock();
+                task(context, id, begin, end);
+                lock.lock();
+                if(--pending_ == 0)
+                    done_.notify_one();
+            }
+        }
+
+        unsigned size_;
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable start_; // 新的一轮或结束
+        std::condition_variable done_;  // pending_变为0
+        Task task_ = nullptr;
+        void* context_ = nullptr;
+        unsigned active_ = 0;
+        std::size_t total_ = 0;
+        unsigned pending_ = 0;          // 这一轮还没做完的其他成员
+        uint64_t round_ = 0;
+        bool stop_ = false;
+    };
+}
+
+#endif //FORK_JOIN_H
@@ -2,6 +2,11 @@
 #define SPLAY_TREE_HPP
 
 #include <iostream>
+#include <vector>
+#include <utility>
+#include <new>
+#include <type_traits>
+#include <cstddef>
 #include "../lib/dsexceptions.h"
 
 // 区别于二叉搜索树BST和平衡二叉树AVL，伸展树本质在BST基础上还规定类每次访问之后将访问的节点变成根节点，
@@ -12,9 +17,14 @@
 
 // 变换形式，相比AVL增加一字型旋转
 
+// 节点从树自己的节点池中分配(每次申请一块BLOCK_SIZE个节点)，删除的节点进入空闲链表
+// clear()逐个析构元素后整块释放，O(n)
+// 条件伸展: setSplayDepth(d)之后，只有访问深度超过d时才伸展，浅处的查找不修改树
+// 读多写少时大部分查找不再写内存，热点元素仍然会被伸展到根附近
+
 // SplayTree class
 //
-// CONSTRUCTION: with no parameters
+// CONSTRUCTION: with no parameters, or the splay depth threshold
 //
 // ******************PUBLIC OPERATIONS*********************
 // void insert( x )       --> Insert x
@@ -25,6 +35,7 @@
 // bool empty( )        --> Return true if empty; else false
 // void clear( )      --> Remove all items
 // void print( )      --> Print tree in sorted order
+// void setSplayDepth( d ) --> Only splay on accesses deeper than d, 0: always splay
 // ******************ERRORS********************************
 // Throws UnderflowException as warranted
 
@@ -34,30 +45,39 @@ namespace DS
     class SplayTree
     {
     public:
-        SplayTree()
+        explicit SplayTree(int splay_depth = 0)
+        : used_in_last_{BLOCK_SIZE}, free_list_{nullptr}, splay_depth_{splay_depth}
         {
             null_node_ = new TreeNode{};
             null_node_->left_ = null_node_->right_ = null_node_;
             root_ = null_node_;
         }
 
+        // 按中序复制后建成平衡的树
         SplayTree(const SplayTree& rhs)
+        : used_in_last_{BLOCK_SIZE}, free_list_{nullptr}, splay_depth_{rhs.splay_depth_}
         {
             null_node_ = new TreeNode{};
             null_node_->left_ = null_node_->right_ = null_node_;
-            clone(root_, rhs.root_);
+            std::vector<const Object*> items;
+            rhs.inorder([&items](const Object& x) { items.push_back(&x); });
+            root_ = buildBalanced(items.data(), items.size());
         }
 
         SplayTree(SplayTree&& rhs) noexcept
-        : root_{rhs.root_}, null_node_{rhs.null_node_}
+        : root_{rhs.root_}, null_node_{rhs.null_node_}, blocks_{std::move(rhs.blocks_)},
+          used_in_last_{rhs.used_in_last_}, free_list_{rhs.free_list_}, splay_depth_{rhs.splay_depth_}
         {
             rhs.root_ = nullptr;
             rhs.null_node_ = nullptr;
+            rhs.blocks_.clear();
+            rhs.free_list_ = nullptr;
         }
 
         ~SplayTree()
         {
-            clear();
+            if(null_node_ != nullptr)
+                clear();
             delete null_node_;
             null_node_ = nullptr;
         }
@@ -73,9 +93,18 @@ namespace DS
         {
             std::swap(root_, rhs.root_);
             std::swap(null_node_, rhs.null_node_);
+            blocks_.swap(rhs.blocks_);
+            std::swap(used_in_last_, rhs.used_in_last_);
+            std::swap(free_list_, rhs.free_list_);
+            std::swap(splay_depth_, rhs.splay_depth_);
             return *this;
         }
 
+        void setSplayDepth(int depth)
+        {
+            splay_depth_ = depth;
+        }
+
         bool empty() const
         {
             return root_ == null_node_;
@@ -85,8 +114,23 @@ namespace DS
         {
             if(empty())
                 return false;
+            if(splay_depth_ > 0) // 先不修改树地查找，足够浅时直接返回
+            {
+                TreeNode* node = root_;
+                for(int depth = 0; node != null_node_ && depth <= splay_depth_; ++depth)
+                {
+                    if(x < node->element_)
+                        node = node->left_;
+                    else if(node->element_ < x)
+                        node = node->right_;
+                    else
+                        return true;
+                }
+                if(node == null_node_)
+                    return false;
+            }
             splay(x, root_);
-            return root_->element_ == x;
+            return !(x < root_->element_) && !(root_->element_ < x);
         }
 
         void print() const
@@ -94,7 +138,7 @@ namespace DS
             if(empty())
                 std::cout << "Empty tree" << std::endl;
             else
-                print(root_);
+                inorder([](const Object& x) { std::cout << x << std::endl; });
         }
 
         /* Not the most efficient implementation (uses two passes),
@@ -108,10 +152,12 @@ namespace DS
             if(empty())
                 throw UnderflowException{};
             TreeNode* ptr = root_;
-            while(ptr->left_ != null_node_)
+            int depth = 0;
+            for(; ptr->left_ != null_node_; ++depth)
                 ptr = ptr->left_;
 
-            splay(ptr->element_, root_);
+            if(depth > splay_depth_)
+                splay(ptr->element_, root_);
             return ptr->element_;
         }
 
@@ -120,53 +166,63 @@ namespace DS
             if(empty())
                 throw UnderflowException{};
             TreeNode* ptr = root_;
-            while(ptr->right_ != null_node_)
+            int depth = 0;
+            for(; ptr->right_ != null_node_; ++depth)
                 ptr = ptr->right_;
 
-            splay(ptr->element_, root_);
+            if(depth > splay_depth_)
+                splay(ptr->element_, root_);
             return ptr->element_;
         }
 
+        // 元素需要析构时逐个析构，然后整块释放节点池，O(n)
         void clear()
         {
-            while(!empty())
+            if(!std::is_trivially_destructible<Object>::value)
             {
-                findMax(); // splay max item to root
-                remove(root_->element_);
+                // 不递归: 有左儿子时右旋，把树变成一条向右的链，边走边析构
+                TreeNode* node = root_;
+                while(node != null_node_)
+                {
+                    if(node->left_ != null_node_)
+                    {
+                        TreeNode* left = node->left_;
+                        node->left_ = left->right_;
+                        left->right_ = node;
+                        node = left;
+                    } else
+                    {
+                        TreeNode* right = node->right_;
+                        node->~TreeNode();
+                        node = right;
+                    }
+                }
             }
+            for(TreeNode* block : blocks_)
+                ::operator delete(block);
+            blocks_.clear();
+            used_in_last_ = BLOCK_SIZE;
+            free_list_ = nullptr;
+            root_ = null_node_;
         }
 
+        // 先伸展，确定x不存在之后才分配节点
         void insert(const Object& x)
         {
-            TreeNode* new_node = nullptr;
-            new_node = new TreeNode{x};
+            insertProcess(x);
+        }
 
-            if(root_ == null_node_)
-            {
-                new_node->left_ = new_node->right_ = null_node_;
-                root_ = new_node;
-            } else{
-                splay(x, root_);
-                if(x < root_->element_)
-                {
-                    new_node->left_ = root_->left_;
-                    new_node->right_ = root_;
-                    root_->left_ = null_node_;
-                    root_ = new_node;
-                } else if(root_->element_ < x){
-                    new_node->right_ = root_->right_;
-                    new_node->left_ = root_;
-                    root_->right_ = null_node_;
-                    root_ = new_node;
-                } else{
-                    return;
-                }
-            }
+        void insert(Object&& x)
+        {
+            insertProcess(std::move(x));
         }
 
         void remove(const Object& x)
         {
-            if(!contains(x)) // 调用contain的同时，如果x存在，会被放在root节点
+            if(empty())
+                return;
+            splay(x, root_); // 如果x存在，会被放在root节点
+            if(x < root_->element_ || root_->element_ < x)
                 return;
 
             TreeNode* new_tree; // 保存root的子树
@@ -181,7 +237,7 @@ namespace DS
                 splay(x, new_tree);
                 new_tree->right_ = root_->right_;
             }
-            delete root_; // 删除旧根
+            deleteNode(root_); // 删除旧根
             root_ = new_tree;
         }
 
@@ -200,33 +256,98 @@ namespace DS
             explicit TreeNode(const Object& element, TreeNode* lt = nullptr, TreeNode* rt = nullptr)
             : element_{element}, left_{lt}, right_{rt}
             {}
+
+            explicit TreeNode(Object&& element, TreeNode* lt = nullptr, TreeNode* rt = nullptr)
+            : element_{std::move(element)}, left_{lt}, right_{rt}
+            {}
         };
 
+        static const std::size_t BLOCK_SIZE = 256; // 节点池每块的节点数
+
         TreeNode* root_;
         TreeNode* null_node_; // 空节点指示标志
+        std::vector<TreeNode*> blocks_; // 节点池，每块BLOCK_SIZE个节点的原始内存
+        std::size_t used_in_last_; // 最后一块中已分配的节点数
+        void* free_list_; // 删除的节点，节点的前几个字节存放下一个空闲节点
+        int splay_depth_; // 访问深度超过此值才伸展，0表示总是伸展
 
-        TreeNode* clone(TreeNode*& node, TreeNode* new_node) const
+        template <typename X>
+        TreeNode* newNode(X&& x, TreeNode* lt, TreeNode* rt)
         {
-            if(new_node == new_node->left_)
-                node = null_node_;
-            else
+            void* memory;
+            if(free_list_ != nullptr)
             {
-                node = new TreeNode(new_node->element_, new_node->left_, new_node->right_);
-                clone(node->left_, new_node->left_);
-                clone(node->right_, new_node->right_);
+                memory = free_list_;
+                free_list_ = *static_cast<void**>(free_list_);
+            } else
+            {
+                if(used_in_last_ == BLOCK_SIZE)
+                {
+                    blocks_.push_back(static_cast<TreeNode*>(::operator new(BLOCK_SIZE * sizeof(TreeNode))));
+                    used_in_last_ = 0;
+                }
+                memory = blocks_.back() + used_in_last_++;
+            }
+            return new (memory) TreeNode(std::forward<X>(x), lt, rt);
+        }
+
+        void deleteNode(TreeNode* node)
+        {
+            node->~TreeNode();
+            *reinterpret_cast<void**>(node) = free_list_;
+            free_list_ = node;
+        }
+
+        template <typename X>
+        void insertProcess(X&& x)
+        {
+            if(root_ == null_node_)
+            {
+                root_ = newNode(std::forward<X>(x), null_node_, null_node_);
+                return;
+            }
+            splay(x, root_);
+            if(x < root_->element_)
+            {
+                TreeNode* new_node = newNode(std::forward<X>(x), root_->left_, root_);
+                root_->left_ = null_node_;
+                root_ = new_node;
+            } else if(root_->element_ < x)
+            {
+                TreeNode* new_node = newNode(std::forward<X>(x), root_, root_->right_);
+                root_->right_ = null_node_;
+                root_ = new_node;
             }
         }
 
-        void print(TreeNode* node) const
+        // 中序遍历，不递归(伸展树可能退化成很长的链)
+        template <typename Function>
+        void inorder(Function fn) const
         {
-            if(node != node->left_)
+            std::vector<const TreeNode*> stack;
+            const TreeNode* node = root_;
+            while(node != null_node_ || !stack.empty())
             {
-                print(node->left_);
-                std::cout << node->element_ << std::endl;
-                print(node->right_);
+                for(; node != null_node_; node = node->left_)
+                    stack.push_back(node);
+                node = stack.back();
+                stack.pop_back();
+                fn(node->element_);
+                node = node->right_;
             }
         }
 
+        TreeNode* buildBalanced(const Object* const* items, std::size_t n)
+        {
+            if(n == 0)
+                return null_node_;
+            std::size_t mid = n / 2;
+            TreeNode* node = newNode(*items[mid], null_node_, null_node_);
+            node->left_ = buildBalanced(items, mid);
+            node->right_ = buildBalanced(items + mid + 1, n - mid - 1);
+            return node;
+        }
+
         void rotateWithLeftChild(TreeNode*& k2)
         {
             TreeNode* k1 = k2->left_;
@@ -295,5 +416,8 @@ namespace DS
             node->right_ = header.left_;
         }
     };
+
+    template <typename Object>
+    const std::size_t SplayTree<Object>::BLOCK_SIZE;
 }
 #endif //SPLAY_TREE_HPP
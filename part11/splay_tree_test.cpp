@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include "splay_tree.hpp"
 
 using namespace std;
@@ -48,6 +49,32 @@ int main()
             cout << "Find error2!" << endl;
     }
 
+    // 条件伸展: 浅处的查找不修改树
+    SplayTree<int> t3(16);
+    for (i = GAP; i != 0; i = (i + GAP) % NUMS)
+        t3.insert(i);
+    for (i = 1; i < NUMS; i += 2)
+        t3.remove(i);
+    for (i = 0; i < NUMS; ++i)
+        if (t3.contains(i) != (i % 2 == 0 && i != 0))
+            cout << "Semi-splay find error: " << i << endl;
+    if (t3.findMin() != 2 || t3.findMax() != NUMS - 2)
+        cout << "Semi-splay FindMin or FindMax error!" << endl;
+
+    // 有序插入得到一条长链，复制、清空都不递归
+    SplayTree<string> s;
+    for (i = 0; i < 100000; ++i)
+        s.insert(to_string(1000000 + i));
+    s.insert("1000005");
+    SplayTree<string> s2 = s;
+    s.clear();
+    if (!s.empty() || s.contains("1000005") || !s2.contains("1000005") || s2.findMax() != "1099999")
+        cout << "Clear error!" << endl;
+    s.insert("a");
+    s2 = std::move(s);
+    if (!s2.contains("a") || s2.contains("1000005"))
+        cout << "Move error!" << endl;
+
     cout << "Test completed." << endl;
     return 0;
 }
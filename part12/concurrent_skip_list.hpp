@@ -0,0 +1,371 @@
+#ifndef CONCURRENT_SKIP_LIST_HPP
+#define CONCURRENT_SKIP_LIST_HPP
+
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include "../lib/epoch.h"
+
+// ConcurrentSkipList class
+// 无锁跳表，可以被任意多个线程同时读写的有序集合/映射
+// 每层是一条有序链表，节点的层数按1/2的概率递增，查找从最高层向下，期望O(log n)
+// 删除分两步: 先在节点各层的next指针最低位做标记(逻辑删除)，再由查找把标记的节点摘下(物理删除)
+// 被摘下的节点交给Epoch延迟释放，正在访问它的线程不会读到已释放的内存
+//
+// ConcurrentSkipList<Key>          集合
+// ConcurrentSkipList<Key, Value>   映射，值在插入后不再改变
+//
+// ******************PUBLIC OPERATIONS*********************
+// bool insert( x )       --> Insert x, return false if x is present
+// bool insert( x, v )    --> Insert x with value v, return false if x is present
+// bool remove( x )       --> Remove x, return false if x is absent
+// bool contains( x )     --> Return true if x is present
+// bool find( x, v )      --> Copy the value of x to v, return false if x is absent
+// forEachInRange( lo, hi, fn )      --> Call fn(x) for every lo <= x <= hi
+// forEachEntryInRange( lo, hi, fn ) --> Call fn(x, v) for every lo <= x <= hi
+// size_t size( )         --> Count the items, O(n)
+// bool empty( )          --> Return true if empty; else false
+// void print( )          --> Print items in sorted order
+//
+// insert/remove/contains/find可线性化: 插入在第0层链接成功时生效，删除在第0层标记成功时生效
+// 范围查询是弱一致的(与java.util.concurrent的跳表相同): 不会重复或乱序，
+// 查询期间一直存在的元素一定会被访问，查询期间插入或删除的元素可能访问也可能不访问
+// 析构、复制以外的操作都可以并发调用
+
+namespace DS
+{
+    // 集合不需要值，用空类型占位
+    struct SkipListSetTag {};
+
+    template <typename Key, typename Value = SkipListSetTag>
+    class ConcurrentSkipList
+    {
+    private:
+        static const int MAX_LEVEL = 32;
+
+        // next_[level]的最低位为1表示本节点在这一层已被删除
+        struct Node
+        {
+            Key key_;
+            Value value_;
+            int top_level_;
+            std::atomic<int> owners_; // 插入者与删除者，都放手后才能回收
+            std::atomic<uintptr_t>* next_; // top_level_个指针，与节点一起分配
+
+            Node(const Key& key, const Value& value, int top_level, std::atomic<uintptr_t>* next)
+            : key_{key}, value_{value}, top_level_{top_level}, owners_{2}, next_{next}
+            {
+                for(int i = 0; i < top_level; ++i)
+                    new (&next_[i]) std::atomic<uintptr_t>(0);
+            }
+        };
+
+        Node* head_; // 哨兵，MAX_LEVEL层，不存关键字
+
+        static bool isMarked(uintptr_t p)
+        { return p & 1; }
+
+        static Node* pointer(uintptr_t p)
+        { return reinterpret_cast<Node*>(p & ~static_cast<uintptr_t>(1)); }
+
+        static uintptr_t raw(Node* node)
+        { return reinterpret_cast<uintptr_t>(node); }
+
+        static Node* createNode(const Key& key, const Value& value, int top_level)
+        {
+            void* memory = ::operator new(sizeof(Node) + top_level * sizeof(std::atomic<uintptr_t>));
+            auto next = reinterpret_cast<std::atomic<uintptr_t>*>(static_cast<char*>(memory) + sizeof(Node));
+            return new (memory) Node(key, value, top_level, next);
+        }
+
+        static void destroyNode(void* p)
+        {
+            Node* node = static_cast<Node*>(p);
+            node->~Node();
+            ::operator delete(p);
+        }
+
+        // 层数为 k 的概率为 2^-k，每个线程有自己的随机数状态
+        static int randomLevel()
+        {
+            static thread_local uint64_t state =
+                    std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9e3779b97f4a7c15ull | 1;
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return 1 + __builtin_ctzll(state | (1ull << (MAX_LEVEL - 1)));
+        }
+
+        // 在每一层找到 preds[level] < x <= succs[level]，顺便摘下经过的已标记节点
+        // 摘除失败(前驱被修改)时返回false，需要从头重试
+        bool tryFind(const Key& x, Node** preds, Node** succs) const
+        {
+            Node* pred = head_;
+            for(int level = MAX_LEVEL - 1; level >= 0; --level)
+            {
+                Node* curr = pointer(pred->next_[level].load());
+                while(curr != nullptr)
+                {
+                    uintptr_t succ = curr->next_[level].load();
+                    if(isMarked(succ))
+                    {
+                        uintptr_t expected = raw(curr);
+                        if(!pred->next_[level].compare_exchange_strong(expected, succ & ~static_cast<uintptr_t>(1)))
+                            return false;
+                        curr = pointer(succ);
+                    } else if(curr->key_ < x)
+                    {
+                        pred = curr;
+                        curr = pointer(succ);
+                    } else
+                        break;
+                }
+                preds[level] = pred;
+                succs[level] = curr;
+            }
+            return true;
+        }
+
+        // 返回x是否存在(第0层的后继等于x且未被标记)
+        bool find(const Key& x, Node** preds, Node** succs) const
+        {
+            while(!tryFind(x, preds, succs))
+                ;
+            return succs[0] != nullptr && !(x < succs[0]->key_);
+        }
+
+        // 插入者与删除者都放手后，由后放手的一方确认节点已从各层摘下，然后回收
+        void release(Node* node)
+        {
+            if(node->owners_.fetch_sub(1) != 1)
+                return;
+            Node* preds[MAX_LEVEL];
+            Node* succs[MAX_LEVEL];
+            find(node->key_, preds, succs);
+            Epoch::retire(node, destroyNode);
+        }
+
+        // 第一个不小于x且未被删除的节点，不修改链表，调用者持有Epoch::Guard
+        Node* lowerBoundNode(const Key& x) const
+        {
+            Node* pred = head_;
+            Node* curr = nullptr;
+            for(int level = MAX_LEVEL - 1; level >= 0; --level)
+            {
+                curr = pointer(pred->next_[level].load());
+                while(curr != nullptr)
+                {
+                    uintptr_t succ = curr->next_[level].load();
+                    if(isMarked(succ))
+                        curr = pointer(succ);
+                    else if(curr->key_ < x)
+                    {
+                        pred = curr;
+                        curr = pointer(succ);
+                    } else
+                        break;
+                }
+            }
+            return curr;
+        }
+
+        template <typename Function>
+        void forEachNodeInRange(const Key& lo, const Key& hi, Function fn) const
+        {
+            Epoch::Guard guard;
+            for(Node* node = lowerBoundNode(lo); node != nullptr && !(hi < node->key_);)
+            {
+                uintptr_t next = node->next_[0].load();
+                if(!isMarked(next))
+                    fn(node);
+                node = pointer(next);
+            }
+        }
+
+        bool insertProcess(const Key& x, const Value& v)
+        {
+            Node* preds[MAX_LEVEL];
+            Node* succs[MAX_LEVEL];
+            int top_level = randomLevel();
+            Node* node = nullptr;
+            Epoch::Guard guard;
+            while(true)
+            {
+                if(find(x, preds, succs))
+                {
+                    if(node != nullptr) // 还没有发布，直接释放
+                        destroyNode(node);
+                    return false;
+                }
+                if(node == nullptr)
+                    node = createNode(x, v, top_level);
+                for(int level = 0; level < top_level; ++level)
+                    node->next_[level].store(raw(succs[level]), std::memory_order_relaxed);
+                uintptr_t expected = raw(succs[0]);
+                if(preds[0]->next_[0].compare_exchange_strong(expected, raw(node)))
+                    break;
+            }
+            // 逐层向上链接，节点被删除(标记)后停止
+            bool linking = true;
+            for(int level = 1; linking && level < top_level; ++level)
+            {
+                while(true)
+                {
+                    // 除了本线程，只有删除者会修改node的next指针(标记)
+                    uintptr_t next = node->next_[level].load();
+                    if(isMarked(next) || (next != raw(succs[level]) &&
+                                          !node->next_[level].compare_exchange_strong(next, raw(succs[level]))))
+                    {
+                        linking = false;
+                        break;
+                    }
+                    uintptr_t expected = raw(succs[level]);
+                    if(preds[level]->next_[level].compare_exchange_strong(expected, raw(node)))
+                        break;
+                    find(x, preds, succs);
+                    if(succs[0] != node) // 已在第0层被删除并摘下
+                    {
+                        linking = false;
+                        break;
+                    }
+                }
+            }
+            release(node);
+            return true;
+        }
+
+    public:
+        ConcurrentSkipList()
+        : head_{createNode(Key(), Value(), MAX_LEVEL)}
+        {}
+
+        ConcurrentSkipList(const ConcurrentSkipList& rhs) = delete;
+
+        ConcurrentSkipList& operator=(const ConcurrentSkipList& rhs) = delete;
+
+        // 要求没有其它线程在访问，已删除的节点由Epoch回收
+        ~ConcurrentSkipList()
+        {
+            Node* node = head_;
+            while(node != nullptr)
+            {
+                Node* next = pointer(node->next_[0].load());
+                destroyNode(node);
+                node = next;
+            }
+        }
+
+        bool insert(const Key& x)
+        { return insertProcess(x, Value()); }
+
+        bool insert(const Key& x, const Value& v)
+        { return insertProcess(x, v); }
+
+        bool remove(const Key& x)
+        {
+            Node* preds[MAX_LEVEL];
+            Node* succs[MAX_LEVEL];
+            Epoch::Guard guard;
+            if(!find(x, preds, succs))
+                return false;
+            Node* node = succs[0];
+            // 从上到下标记，第0层标记成功的线程完成删除
+            for(int level = node->top_level_ - 1; level >= 1; --level)
+            {
+                uintptr_t next = node->next_[level].load();
+                while(!isMarked(next) && !node->next_[level].compare_exchange_weak(next, next | 1))
+                    ;
+            }
+            uintptr_t next = node->next_[0].load();
+            while(true)
+            {
+                if(isMarked(next))
+                    return false; // 其它线程先删除
+                if(node->next_[0].compare_exchange_strong(next, next | 1))
+                    break;
+            }
+            find(x, preds, succs);
+            release(node);
+            return true;
+        }
+
+        bool contains(const Key& x) const
+        {
+            Epoch::Guard guard;
+            Node* node = lowerBoundNode(x);
+            return node != nullptr && !(x < node->key_);
+        }
+
+        bool find(const Key& x, Value& v) const
+        {
+            Epoch::Guard guard;
+            Node* node = lowerBoundNode(x);
+            if(node == nullptr || x < node->key_)
+                return false;
+            v = node->value_;
+            return true;
+        }
+
+        // 对 [lo, hi] 中的每个关键字调用 fn(x)
+        template <typename Function>
+        void forEachInRange(const Key& lo, const Key& hi, Function fn) const
+        { forEachNodeInRange(lo, hi, [&fn](Node* node) { fn(node->key_); }); }
+
+        // 对 [lo, hi] 中的每个关键字调用 fn(x, v)
+        template <typename Function>
+        void forEachEntryInRange(const Key& lo, const Key& hi, Function fn) const
+        { forEachNodeInRange(lo, hi, [&fn](Node* node) { fn(node->key_, node->value_); }); }
+
+        std::size_t size() const
+        {
+            Epoch::Guard guard;
+            std::size_t n = 0;
+            for(Node* node = pointer(head_->next_[0].load()); node != nullptr;)
+            {
+                uintptr_t next = node->next_[0].load();
+                n += !isMarked(next);
+                node = pointer(next);
+            }
+            return n;
+        }
+
+        bool empty() const
+        {
+            Epoch::Guard guard;
+            for(Node* node = pointer(head_->next_[0].load()); node != nullptr;)
+            {
+                uintptr_t next = node->next_[0].load();
+                if(!isMarked(next))
+                    return false;
+                node = pointer(next);
+            }
+            return true;
+        }
+
+        void print(std::ostream& out = std::cout) const
+        {
+            if(empty())
+            {
+                out << "Empty list" << std::endl;
+                return;
+            }
+            Epoch::Guard guard;
+            for(Node* node = pointer(head_->next_[0].load()); node != nullptr;)
+            {
+                uintptr_t next = node->next_[0].load();
+                if(!isMarked(next))
+                    out << node->key_ << std::endl;
+                node = pointer(next);
+            }
+        }
+    };
+
+    template <typename Key, typename Value>
+    const int ConcurrentSkipList<Key, Value>::MAX_LEVEL;
+}
+
+#endif //CONCURRENT_SKIP_LIST_HPP
@@ -0,0 +1,149 @@
+// 并发有序集合的扩展性
+// 关键字范围 [0, 2n)，预先插入n个，T个线程各执行ops次混合操作，统计总吞吐量:
+//   read-heavy     90% contains, 5% insert, 4% remove, 1% 范围查询(宽度64)
+//   update-heavy   50% contains, 25% insert, 25% remove
+// 对照: std::set加一把互斥锁
+// 线程数取1, 2, 4, ... max_threads
+//
+// 用法: concurrent_skip_list_benchmark [n] [ops_per_thread] [max_threads] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "concurrent_skip_list.hpp"
+
+const int SCAN_WIDTH = 64;
+
+class LockedSet
+{
+public:
+    bool insert(int x)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return set_.insert(x).second;
+    }
+
+    bool remove(int x)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return set_.erase(x) != 0;
+    }
+
+    bool contains(int x)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return set_.count(x) != 0;
+    }
+
+    template <typename Function>
+    void forEachInRange(int lo, int hi, Function fn)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(auto it = set_.lower_bound(lo); it != set_.end() && *it <= hi; ++it)
+            fn(*it);
+    }
+
+private:
+    std::mutex mutex_;
+    std::set<int> set_;
+};
+
+struct Mix
+{
+    const char* name;
+    int contains; // 百分比，其余依次为insert, remove, scan
+    int insert;
+    int remove;
+};
+
+const Mix MIXES[] = {
+        {"read-heavy", 90, 5, 4},
+        {"update-heavy", 50, 25, 25},
+};
+
+template <typename Set>
+double run(const Mix& mix, std::size_t n, std::size_t ops, int n_threads, int seed)
+{
+    Set set;
+    int range = static_cast<int>(2 * n);
+    uint32_t s = static_cast<uint32_t>(seed);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        s = s * 1103515245 + 12345;
+        set.insert(static_cast<int>(s % range));
+    }
+
+    std::atomic<uint64_t> checksum{0}; // 防止操作被优化掉
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for(int id = 0; id < n_threads; ++id)
+    {
+        threads.emplace_back([&, id]() {
+            uint64_t state = (static_cast<uint64_t>(seed) << 32) + id * 0x9e3779b97f4a7c15ull + 1;
+            uint64_t sum = 0;
+            for(std::size_t i = 0; i < ops; ++i)
+            {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                int key = static_cast<int>((state >> 8) % range);
+                int dice = static_cast<int>(state % 100);
+                if(dice < mix.contains)
+                    sum += set.contains(key);
+                else if(dice < mix.contains + mix.insert)
+                    sum += set.insert(key);
+                else if(dice < mix.contains + mix.insert + mix.remove)
+                    sum += set.remove(key);
+                else
+                    set.forEachInRange(key, key + SCAN_WIDTH, [&sum](int x) { sum += x; });
+            }
+            checksum += sum;
+        });
+    }
+    for(auto& th : threads)
+        th.join();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return n_threads * ops / sec / 1e6;
+}
+
+template <typename Set>
+void bench(const std::string& name, const Mix& mix, std::size_t n, std::size_t ops, int max_threads, int seed)
+{
+    std::cout << "  " << std::left << std::setw(20) << name << std::right;
+    for(int n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        std::cout << std::setw(9) << std::fixed << std::setprecision(2) << run<Set>(mix, n, ops, n_threads, seed);
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000000;
+    std::size_t ops = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : 1000000;
+    int max_threads = argc > 3 ? atoi(argv[3]) : 8;
+    int seed = argc > 4 ? atoi(argv[4]) : 1;
+    if(n < 1 || max_threads < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [n >= 1] [ops_per_thread] [max_threads >= 1] [seed]" << std::endl;
+        return 1;
+    }
+
+    std::cout << n << " keys, " << ops << " ops per thread (M ops/s), threads:";
+    for(int n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        std::cout << " " << n_threads;
+    std::cout << std::endl;
+    for(const Mix& mix : MIXES)
+    {
+        std::cout << mix.name << std::endl;
+        bench<LockedSet>("locked std::set", mix, n, ops, max_threads, seed);
+        bench<DS::ConcurrentSkipList<int>>("ConcurrentSkipList", mix, n, ops, max_threads, seed);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include "concurrent_skip_list.hpp"
+
+using namespace std;
+using DS::ConcurrentSkipList;
+
+// Test program
+int main()
+{
+    ConcurrentSkipList<int> t;
+    int NUMS = 20000;
+    const int GAP = 37;
+    int i;
+
+    cout << "Checking... (no more output means success)" << endl;
+
+    for (i = GAP; i != 0; i = (i + GAP) % NUMS)
+        t.insert(i);
+    for (i = 1; i < NUMS; i += 2)
+        t.remove(i);
+
+    if (NUMS < 40)
+        t.print();
+    if (t.size() != static_cast<size_t>(NUMS / 2 - 1) || t.insert(2) || t.remove(3))
+        cout << "Size error!" << endl;
+
+    for (i = 2; i < NUMS; i += 2)
+        if (!t.contains(i))
+            cout << "Find error1!" << endl;
+
+    for (i = 1; i < NUMS; i += 2)
+    {
+        if (t.contains(i))
+            cout << "Find error2!" << endl;
+    }
+
+    int expect = 100, count = 0;
+    t.forEachInRange(99, 200, [&](int x) {
+        if (x != expect)
+            cout << "Range error!" << endl;
+        expect += 2;
+        ++count;
+    });
+    if (count != 51)
+        cout << "Range error!" << endl;
+
+    // 映射
+    ConcurrentSkipList<int, string> m;
+    for (i = 0; i < 100; ++i)
+        m.insert(i, to_string(i));
+    string v;
+    if (!m.find(42, v) || v != "42" || m.find(100, v) || m.insert(42, "x"))
+        cout << "Map error!" << endl;
+    m.forEachEntryInRange(10, 12, [&](int x, const string& s) {
+        if (to_string(x) != s)
+            cout << "Map error!" << endl;
+    });
+
+    // 多个线程反复插入删除同一批关键字，记录每个线程成功的插入次数减删除次数
+    // 最后每个关键字的总和应等于它是否在表中
+    const int N_THREADS = 4;
+    const int N_KEYS = 256;
+    const int N_OPS = 100000;
+    ConcurrentSkipList<int> c;
+    vector<vector<int>> balance(N_THREADS, vector<int>(N_KEYS, 0));
+    vector<thread> threads;
+    for (int id = 0; id < N_THREADS; ++id)
+    {
+        threads.emplace_back([&, id]() {
+            unsigned seed = id * 7919 + 1;
+            for (int op = 0; op < N_OPS; ++op)
+            {
+                seed = seed * 1103515245 + 12345;
+                int key = (seed >> 8) % N_KEYS;
+                switch ((seed >> 4) % 3)
+                {
+                    case 0:
+                        balance[id][key] += c.insert(key);
+                        break;
+                    case 1:
+                        balance[id][key] -= c.remove(key);
+                        break;
+                    default:
+                    {
+                        // 范围内的关键字严格递增
+                        int last = -1;
+                        c.forEachInRange(key, key + 16, [&](int x) {
+                            if (x <= last || x < key || x > key + 16)
+                                cout << "Concurrent range error!" << endl;
+                            last = x;
+                        });
+                    }
+                }
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    size_t present = 0;
+    for (int key = 0; key < N_KEYS; ++key)
+    {
+        int sum = 0;
+        for (int id = 0; id < N_THREADS; ++id)
+            sum += balance[id][key];
+        if (sum != static_cast<int>(c.contains(key)))
+            cout << "Concurrent error: " << key << endl;
+        present += sum;
+    }
+    if (present != c.size())
+        cout << "Concurrent size error!" << endl;
+
+    cout << "Test finished" << endl;
+    return 0;
+}
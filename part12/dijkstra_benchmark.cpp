@@ -0,0 +1,198 @@
+// Dijkstra 单源最短路径上各种堆的性能对比
+// 配对堆使用decreaseKey，二叉堆/左式堆/二项队列不支持decreaseKey，
+// 采用惰性删除: 重复插入更小的距离，弹出时跳过过期项
+//
+// 用法: dijkstra_benchmark [n_vertices] [out_degree] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <utility>
+#include "pairing_heap.hpp"
+#include "../part6/binary_heap.hpp"
+#include "../part6/left_heap.hpp"
+#include "../part6/binomial_queue.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+
+typedef uint64_t Dist;
+typedef pair<Dist, uint32_t> Item; // (距离, 顶点)
+
+const Dist INF = numeric_limits<Dist>::max();
+
+// 邻接表按CSR方式连续存放
+struct Graph
+{
+    uint32_t n_vertices;
+    vector<uint32_t> offsets; // 顶点v的边为 [offsets[v], offsets[v + 1])
+    vector<uint32_t> targets;
+    vector<uint32_t> weights;
+};
+
+// 随机图: 先连一条环保证连通，其余的边随机生成，权重 [1, 1000]
+Graph makeRandomGraph(uint32_t n, uint32_t degree, int seed)
+{
+    DS::UniformRandom r(seed);
+    Graph g;
+    g.n_vertices = n;
+    g.offsets.resize(n + 1);
+    g.targets.reserve(static_cast<size_t>(n) * degree);
+    g.weights.reserve(static_cast<size_t>(n) * degree);
+    for(uint32_t v = 0; v < n; ++v)
+    {
+        g.offsets[v] = static_cast<uint32_t>(g.targets.size());
+        g.targets.push_back((v + 1) % n);
+        g.weights.push_back(r.nextInt(1, 1000));
+        for(uint32_t e = 1; e < degree; ++e)
+        {
+            g.targets.push_back(r.nextInt(0, n - 1));
+            g.weights.push_back(r.nextInt(1, 1000));
+        }
+    }
+    g.offsets[n] = static_cast<uint32_t>(g.targets.size());
+    return g;
+}
+
+struct Stats
+{
+    size_t inserts = 0;
+    size_t pops = 0;
+    size_t decreases = 0;
+};
+
+// 惰性删除版本，适用于没有decreaseKey的堆
+template <typename Heap>
+vector<Dist> dijkstraLazy(const Graph& g, uint32_t source, Stats& stats)
+{
+    vector<Dist> dist(g.n_vertices, INF);
+    Heap heap;
+    dist[source] = 0;
+    heap.insert(Item(0, source));
+    ++stats.inserts;
+    while(!heap.empty())
+    {
+        Item item;
+        heap.pop(item);
+        ++stats.pops;
+        uint32_t v = item.second;
+        if(item.first != dist[v]) // 过期项
+            continue;
+        for(uint32_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+        {
+            uint32_t w = g.targets[e];
+            Dist nd = item.first + g.weights[e];
+            if(nd < dist[w])
+            {
+                dist[w] = nd;
+                heap.insert(Item(nd, w));
+                ++stats.inserts;
+            }
+        }
+    }
+    return dist;
+}
+
+// 使用配对堆的decreaseKey，每个顶点最多在堆中出现一次
+vector<Dist> dijkstraDecreaseKey(const Graph& g, uint32_t source,
+        DS::PairingHeap<Item>::CombineMode mode, Stats& stats)
+{
+    typedef DS::PairingHeap<Item> Heap;
+    const Heap::Position NOT_IN_HEAP = numeric_limits<Heap::Position>::max();
+    vector<Dist> dist(g.n_vertices, INF);
+    vector<Heap::Position> pos(g.n_vertices, NOT_IN_HEAP);
+    vector<bool> done(g.n_vertices, false);
+    Heap heap(mode);
+    dist[source] = 0;
+    pos[source] = heap.insert(Item(0, source));
+    ++stats.inserts;
+    while(!heap.empty())
+    {
+        Item item;
+        heap.pop(item);
+        ++stats.pops;
+        uint32_t v = item.second;
+        done[v] = true;
+        for(uint32_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+        {
+            uint32_t w = g.targets[e];
+            Dist nd = item.first + g.weights[e];
+            if(done[w] || nd >= dist[w])
+                continue;
+            dist[w] = nd;
+            if(pos[w] == NOT_IN_HEAP)
+            {
+                pos[w] = heap.insert(Item(nd, w));
+                ++stats.inserts;
+            } else
+            {
+                heap.decreaseKey(pos[w], Item(nd, w));
+                ++stats.decreases;
+            }
+        }
+    }
+    return dist;
+}
+
+template <typename Func>
+void run(const string& name, const vector<Dist>& expect, Func func)
+{
+    Stats stats;
+    auto start = chrono::steady_clock::now();
+    vector<Dist> dist = func(stats);
+    auto end = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(end - start).count();
+    bool ok = expect.empty() || dist == expect;
+    cout << left << setw(28) << name
+         << right << setw(10) << fixed << setprecision(1) << ms << " ms"
+         << setw(12) << stats.inserts << " ins"
+         << setw(12) << stats.pops << " pop"
+         << setw(12) << stats.decreases << " dec"
+         << (ok ? "" : "  MISMATCH!") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t n = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 1000000;
+    uint32_t degree = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 8;
+    int seed = argc > 3 ? atoi(argv[3]) : 1;
+    if(n < 2 || degree < 1)
+    {
+        cout << "usage: " << argv[0] << " [n_vertices >= 2] [out_degree >= 1] [seed]" << endl;
+        return 1;
+    }
+
+    cout << "Building random graph: " << n << " vertices, " << degree << " out edges per vertex" << endl;
+    Graph g = makeRandomGraph(n, degree, seed);
+
+    Stats stats;
+    vector<Dist> expect = dijkstraLazy<DS::BinaryHeap<Item>>(g, 0, stats);
+
+    run("BinaryHeap (lazy)", expect, [&](Stats& s) {
+        return dijkstraLazy<DS::BinaryHeap<Item>>(g, 0, s);
+    });
+    run("LeftistHeap (lazy)", expect, [&](Stats& s) {
+        return dijkstraLazy<DS::LeftistHeap<Item>>(g, 0, s);
+    });
+    run("BinomialQueue (lazy)", expect, [&](Stats& s) {
+        return dijkstraLazy<DS::BinomialQueue<Item>>(g, 0, s);
+    });
+    run("PairingHeap (lazy)", expect, [&](Stats& s) {
+        return dijkstraLazy<DS::PairingHeap<Item>>(g, 0, s);
+    });
+    run("PairingHeap two-pass", expect, [&](Stats& s) {
+        return dijkstraDecreaseKey(g, 0, DS::PairingHeap<Item>::TWO_PASS, s);
+    });
+    run("PairingHeap multi-pass", expect, [&](Stats& s) {
+        return dijkstraDecreaseKey(g, 0, DS::PairingHeap<Item>::MULTI_PASS, s);
+    });
+    run("PairingHeap backward 1-pass", expect, [&](Stats& s) {
+        return dijkstraDecreaseKey(g, 0, DS::PairingHeap<Item>::BACKWARD_ONE_PASS, s);
+    });
+    return 0;
+}
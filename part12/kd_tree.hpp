@@ -2,156 +2,564 @@
 #define KD_TREE_HPP
 
 // k-d tree d维搜索树
-// 此处实现的是二维搜索树
-// 如果在建树时采用中值优化（保证根值是分割维度集合的中值）会建立一棵更加平衡的树
+// 每一层按一个维度把点分成两半，维度取该范围内坐标跨度最大的一维
+// 批量建树时用快速选择找中值作为分割点，树是平衡的，叶子最多LEAF_SIZE个点
+//
+// 存储: 点按树的顺序重排，每一维的坐标存成一个连续数组(SoA)，叶子是其中一段连续的下标
+// 节点按先序存在数组中，左儿子紧跟在父节点之后
+// 叶子中的距离按维度逐个累加到LEAF_SIZE长的数组里，内层循环可被编译器向量化
+// 插入(对数方法): 新的点先放在最多PENDING_LIMIT个点的缓冲区中(查询时逐个检查)，缓冲区满时
+// 与末尾不比它大的树合并成一棵新树，树按大小递减存放，大小至少逐棵翻倍，所以最多O(log n)棵；
+// 每个点最多被重建O(log n)次，查询依次搜索每棵树，共用同一个剪枝距离
+// 并行: 建树时左右子树的节点下标可以预先算出，前几层把两棵子树交给不同线程同时建；
+// 批量查询先把查询按所在叶子排序，相邻的查询走相同的路径，再分段交给各线程
+//
+// KdTree<Object, D>   坐标类型为Object的D维点，Point = std::array<Object, D>
+// 每个点有一个编号: build时为在输入中的下标，之后insert的点依次编号
+// 距离都是欧氏距离的平方，整数坐标时用double计算
+//
+// ******************PUBLIC OPERATIONS*********************
+// void build( points, n_threads )  --> Replace the contents, balanced bulk build
+// void insert( p )       --> Insert p
+// bool contains( p )     --> Return true if p is present
+// size_t size( )         --> Return the number of points
+// bool empty( )          --> Return true if empty; else false
+// void clear( )          --> Remove all points
+// forEachInRange( low, high, fn ) --> Call fn(p, id) for every p with low <= p <= high
+// nearest( q, k, max_distance )   --> Up to k nearest points within max_distance, closest first
+// nearestBatch( queries, k, n_threads, max_distance ) --> k nearest points of every query
+// forEachInRadius( q, r, fn )     --> Call fn(p, id, distance) for every p within distance r of q
+// void printRange( low, high )    --> Print points in the box
+// ******************ERRORS********************************
+// Throws IllegalArgumentException if more than 2^32 - 1 points are stored
 
+#include <iostream>
 #include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
 #include "../lib/dsexceptions.h"
+#include "../lib/fork_join.h"
+#include "../part6/binary_heap.hpp"
+#include "../part7/sort.hpp"
 
 namespace DS
 {
-    template <typename Object>
+    template <typename Object, int D = 2>
     class KdTree
     {
-    private:
-        class TreeNode
-        {
-        public:
-            std::vector<Object> data_;
-            TreeNode* left_;
-            TreeNode* right_;
+        static_assert(D > 0, "KdTree needs at least one dimension");
+
+    public:
+        typedef std::array<Object, D> Point;
+        typedef typename std::conditional<std::is_floating_point<Object>::value, Object, double>::type Distance;
 
-            explicit TreeNode(const std::vector<Object>& item)
-            : data_{item}, left_{nullptr}, right_{nullptr}
-            {}
+        struct Neighbor
+        {
+            Point point;
+            std::size_t id;
+            Distance distance; // 距离的平方
         };
 
-        TreeNode* root_;
+        // nearestBatch中不足k个结果时补齐的编号
+        static const std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+        KdTree()
+        : ids_{0}
+        {}
+
+        explicit KdTree(const std::vector<Point>& points, unsigned n_threads = 1)
+        : ids_{0}
+        { build(points, n_threads); }
+
+        bool empty() const
+        { return size() == 0; }
+
+        std::size_t size() const
+        { return slot_ids_.size() + pending_.size(); }
+
+        void clear()
+        {
+            for(auto& c : coords_)
+                c.clear();
+            slot_ids_.clear();
+            nodes_.clear();
+            trees_.clear();
+            pending_.clear();
+            pending_ids_.clear();
+            ids_ = 0;
+        }
+
+        // 以points替换原有内容，编号为points中的下标，最多用n_threads个线程
+        void build(const std::vector<Point>& points, unsigned n_threads = 1)
+        {
+            clear();
+            std::vector<std::size_t> ids(points.size());
+            for(std::size_t i = 0; i < points.size(); ++i)
+                ids[i] = i;
+            buildIndex(points, ids, n_threads);
+            ids_ = points.size();
+        }
+
+        void insert(const Point& p)
+        {
+            pending_.push_back(p);
+            pending_ids_.push_back(ids_++);
+            if(pending_.size() >= PENDING_LIMIT)
+                mergeTrees();
+        }
+
+        bool contains(const Point& p) const
+        {
+            for(const Point& x : pending_)
+                if(x == p)
+                    return true;
+            for(const Tree& tree : trees_)
+                if(containsProcess(p, tree.root_))
+                    return true;
+            return false;
+        }
+
+        // 对 low <= p <= high (每一维) 的点调用 fn(p, id)
+        template <typename Function>
+        void forEachInRange(const Point& low, const Point& high, Function fn) const
+        {
+            for(std::size_t i = 0; i < pending_.size(); ++i)
+                if(inBox(pending_[i], low, high))
+                    fn(pending_[i], pending_ids_[i]);
+            for(const Tree& tree : trees_)
+                rangeProcess(low, high, tree.root_, fn);
+        }
+
+        // 打印low~high范围内的点
+        void printRange(const Point& low, const Point& high, std::ostream& out = std::cout) const
+        {
+            forEachInRange(low, high, [&out](const Point& p, std::size_t) {
+                out << "(";
+                for(int d = 0; d < D; ++d)
+                    out << (d ? "," : "") << p[d];
+                out << ")" << std::endl;
+            });
+        }
 
-        void clear(TreeNode*& root)
+        // 距离q最近的k个点(距离平方不超过max_distance)，按距离从近到远
+        // 用大小为k的堆保存当前最近的点，堆顶为其中最远的一个，剪枝时与堆顶比较
+        std::vector<Neighbor> nearest(const Point& q, std::size_t k,
+                                      Distance max_distance = std::numeric_limits<Distance>::max()) const
         {
-            if(root)
+            std::vector<Neighbor> result(k);
+            NeighborHeap heap(FartherFirst(), k);
+            result.resize(nearestInto(q, k, max_distance, heap, result.data()));
+            return result;
+        }
+
+        // 每个查询的k个最近点，第i个查询的结果在 [i * k, (i + 1) * k)，按距离从近到远
+        // 不足k个时用编号为NOT_FOUND、距离为Distance最大值的项补齐
+        std::vector<Neighbor> nearestBatch(const std::vector<Point>& queries, std::size_t k, unsigned n_threads = 1,
+                                           Distance max_distance = std::numeric_limits<Distance>::max()) const
+        {
+            Neighbor missing{Point(), NOT_FOUND, std::numeric_limits<Distance>::max()};
+            std::vector<Neighbor> result(queries.size() * k, missing);
+            if(k == 0 || queries.empty())
+                return result;
+
+            // 按在第一棵(最大的)树中所在的叶子做计数排序，节点是先序编号的，相邻的叶子在空间上也相邻
+            // 还没有建树(空树或只有缓冲区中的点)时没有叶子，按原顺序逐个扫描
+            std::vector<std::size_t> order(queries.size());
+            if(nodes_.empty())
+            {
+                for(std::size_t i = 0; i < queries.size(); ++i)
+                    order[i] = i;
+            } else
             {
-                TreeNode* lp = root->left_;
-                TreeNode* rp = root->right_;
-                delete root;
-                root = nullptr;
-                clear(lp);
-                clear(rp);
+                std::vector<std::size_t> count(nodes_.size() + 1, 0);
+                std::vector<uint32_t> leaves(queries.size());
+                for(std::size_t i = 0; i < queries.size(); ++i)
+                    ++count[(leaves[i] = leafOf(queries[i])) + 1];
+                for(std::size_t i = 1; i < count.size(); ++i)
+                    count[i] += count[i - 1];
+                for(std::size_t i = 0; i < queries.size(); ++i)
+                    order[count[leaves[i]]++] = i;
             }
+
+            batchProcess(queries, order, 0, order.size(), k, max_distance, result, forkDepth(n_threads));
+            return result;
         }
 
-        void clone(TreeNode*& node, TreeNode* rhs)
+        // 对距离q不超过r的点调用 fn(p, id, distance)，distance为距离的平方
+        template <typename Function>
+        void forEachInRadius(const Point& q, Distance r, Function fn) const
         {
-            if(rhs)
+            Distance r2 = r * r;
+            for(std::size_t i = 0; i < pending_.size(); ++i)
             {
-                node = new TreeNode{rhs->data_};
-                clone(node->left_, rhs->left_);
-                clone(node->right_, rhs->right_);
+                Distance distance = distanceTo(q, pending_[i]);
+                if(distance <= r2)
+                    fn(pending_[i], pending_ids_[i], distance);
             }
+            Distance bound = r2;
+            auto report = [&](Distance distance, std::size_t slot) {
+                fn(pointAt(slot), slot_ids_[slot], distance);
+            };
+            for(const Tree& tree : trees_)
+                nearestProcess(q, tree.root_, bound, report);
         }
 
-        void printRange(const std::vector<Object>& low, const std::vector<Object>& high,
-                TreeNode* node, int level) const
+    private:
+        static const int LEAF_SIZE = 16;
+        static const std::size_t PENDING_LIMIT = 4 * LEAF_SIZE;
+
+        // split_所在的维度为dim_，左子树的点 <= split_ <= 右子树的点
+        // dim_ < 0 表示叶子，点的下标为 [begin_, end_)
+        struct Node
         {
-            if(node)
+            Object split_;
+            int dim_;
+            uint32_t begin_;
+            uint32_t end_;
+            uint32_t right_; // 右儿子在nodes_中的下标，左儿子为当前下标 + 1
+        };
+
+        struct Candidate
+        {
+            Distance distance_;
+            std::size_t slot_;
+        };
+
+        // 堆顶为距离最大的候选
+        struct FartherFirst
+        {
+            bool operator()(const Candidate& lhs, const Candidate& rhs) const
+            { return rhs.distance_ < lhs.distance_; }
+        };
+
+        typedef BinaryHeap<Candidate, FartherFirst> NeighborHeap;
+
+        // 一棵静态树: 节点为nodes_[root_, 下一棵树的root_)，点为size_个连续的slot
+        struct Tree
+        {
+            uint32_t root_;
+            uint32_t size_;
+        };
+
+        std::vector<Object> coords_[D]; // coords_[d][slot]: 树中第slot个点的第d维坐标
+        std::vector<std::size_t> slot_ids_; // 树中第slot个点的编号
+        std::vector<Node> nodes_;
+        std::vector<Tree> trees_; // 大小递减，节点和slot按树的顺序连续存放
+        std::vector<Point> pending_; // 还没有放进树的点
+        std::vector<std::size_t> pending_ids_;
+        std::size_t ids_; // 下一个编号
+
+        // 按维度dim比较两个点的下标
+        struct CompareOnDim
+        {
+            const std::vector<Point>* points_;
+            int dim_;
+
+            bool operator()(uint32_t lhs, uint32_t rhs) const
+            { return (*points_)[lhs][dim_] < (*points_)[rhs][dim_]; }
+        };
+
+        static Distance distanceTo(const Point& q, const Point& p)
+        {
+            Distance sum = 0;
+            for(int d = 0; d < D; ++d)
             {
-                if(low[0] <= node->data_[0] && high[0] >= node->data_[0] && \
-                low[1] <= node->data_[1] && high[1] >= node->data_[1])
-                    std::cout << "(" << node->data_[0] << "," << node->data_[1] << ")" << std::endl;
-                if(low[level] <= node->data_[level])
-                    printRange(low, high, node->left_, 1 - level);
-                if(high[level] >= node->data_[level])
-                    printRange(low, high, node->right_, 1 - level);
+                Distance diff = static_cast<Distance>(p[d]) - static_cast<Distance>(q[d]);
+                sum += diff * diff;
             }
+            return sum;
         }
 
-        void insert(const std::vector<Object>& x, TreeNode*& node, int level)
+        static bool inBox(const Point& p, const Point& low, const Point& high)
         {
-            if(node == nullptr)
-                node = new TreeNode(x);
-            else if(x[level] > node->data_[level])
-                insert(x, node->right_, 1 - level);
-            else if(x[level] < node->data_[level] || x[1 - level] != node->data_[1 - level])
-                insert(x, node->left_, 1 - level);
+            for(int d = 0; d < D; ++d)
+                if(p[d] < low[d] || high[d] < p[d])
+                    return false;
+            return true;
         }
 
-        bool contain(const std::vector<Object>& item, TreeNode* node, int level)
+        // slot >= 树中点数时为缓冲区中的点
+        Point pointAt(std::size_t slot) const
         {
-            if(item == nullptr)
-                return false;
-            else if(item[level] > node->data_[level])
-                return contain(item, node->right_, 1 - level);
-            else if(item[level] < node->data_[level] || item[1 - level] != node->data_[1 - level])
-                contain(item, node->left_, 1 - level);
-            else
-                return true;
+            if(slot >= slot_ids_.size())
+                return pending_[slot - slot_ids_.size()];
+            Point p;
+            for(int d = 0; d < D; ++d)
+                p[d] = coords_[d][slot];
+            return p;
         }
 
-    public:
-        KdTree()
-        : root_(nullptr)
-        {}
+        std::size_t idAt(std::size_t slot) const
+        {
+            if(slot >= slot_ids_.size())
+                return pending_ids_[slot - slot_ids_.size()];
+            return slot_ids_[slot];
+        }
 
-        KdTree(const KdTree& rhs)
-        : root_(nullptr)
+        // 缓冲区与末尾大小不超过它的树(逐棵累加)合并，在末尾建成一棵新树，编号不变
+        void mergeTrees()
         {
-            clone(root_, rhs.root_);
+            std::vector<Point> points(pending_);
+            std::vector<std::size_t> ids(pending_ids_);
+            pending_.clear();
+            pending_ids_.clear();
+            while(!trees_.empty() && trees_.back().size_ <= points.size())
+            {
+                Tree tree = trees_.back();
+                trees_.pop_back();
+                uint32_t first = static_cast<uint32_t>(slot_ids_.size()) - tree.size_;
+                for(uint32_t slot = first; slot < slot_ids_.size(); ++slot)
+                {
+                    points.push_back(pointAt(slot));
+                    ids.push_back(slot_ids_[slot]);
+                }
+                for(int d = 0; d < D; ++d)
+                    coords_[d].resize(first);
+                slot_ids_.resize(first);
+                nodes_.resize(tree.root_);
+            }
+            buildIndex(points, ids);
         }
 
-        KdTree(KdTree&& rhs) noexcept
-        : root_{rhs.root_}
+        // 在末尾为points建一棵新树
+        void buildIndex(const std::vector<Point>& points, const std::vector<std::size_t>& ids,
+                        unsigned n_threads = 1)
         {
-            rhs.root_ = nullptr;
+            if(points.size() >= std::numeric_limits<uint32_t>::max() - slot_ids_.size())
+                throw IllegalArgumentException{};
+            if(points.empty())
+                return;
+            uint32_t n = static_cast<uint32_t>(points.size());
+            uint32_t base = static_cast<uint32_t>(slot_ids_.size());
+            uint32_t root = static_cast<uint32_t>(nodes_.size());
+            std::vector<uint32_t> order(n);
+            for(uint32_t i = 0; i < n; ++i)
+                order[i] = i;
+            nodes_.resize(root + nodeCount(n));
+            for(int d = 0; d < D; ++d)
+                coords_[d].resize(base + n);
+            slot_ids_.resize(base + n);
+            buildProcess(points, ids, order, base, 0, n, root, forkDepth(n_threads));
+            trees_.push_back(Tree{root, n});
         }
 
-        ~KdTree()
+        // n个点的子树的节点数，建树时用来确定右子树的下标
+        static uint32_t nodeCount(uint32_t n)
         {
-            clear();
+            if(n <= static_cast<uint32_t>(LEAF_SIZE))
+                return 1;
+            return 1 + nodeCount(n / 2) + nodeCount(n - n / 2);
         }
 
-        KdTree& operator=(const KdTree& rhs)
+        // 为order[begin, end)建子树，根放在nodes_[index]，order[i]放在slot base + i
+        // 前depth层把左子树交给新线程，各线程写的节点和坐标互不重叠
+        void buildProcess(const std::vector<Point>& points, const std::vector<std::size_t>& ids,
+                          std::vector<uint32_t>& order, uint32_t base, uint32_t begin, uint32_t end,
+                          uint32_t index, int depth)
         {
-            KdTree copy{rhs};
-            std::swap(*this, copy);
-            return *this;
+            if(end - begin <= static_cast<uint32_t>(LEAF_SIZE))
+            {
+                // 按树的顺序把坐标拆成SoA
+                nodes_[index] = Node{Object(), -1, base + begin, base + end, 0};
+                for(uint32_t i = begin; i < end; ++i)
+                {
+                    for(int d = 0; d < D; ++d)
+                        coords_[d][base + i] = points[order[i]][d];
+                    slot_ids_[base + i] = ids[order[i]];
+                }
+                return;
+            }
+
+            // 跨度最大的维度，跨度用Distance计算，整数坐标相减可能溢出
+            Point low = points[order[begin]];
+            Point high = low;
+            for(uint32_t i = begin + 1; i < end; ++i)
+            {
+                const Point& p = points[order[i]];
+                for(int d = 0; d < D; ++d)
+                {
+                    low[d] = std::min(low[d], p[d]);
+                    high[d] = std::max(high[d], p[d]);
+                }
+            }
+            int dim = 0;
+            for(int d = 1; d < D; ++d)
+                if(span(low, high, dim) < span(low, high, d))
+                    dim = d;
+
+            // 中值放在mid处，左边的都不大于它，右边的都不小于它
+            uint32_t mid = begin + (end - begin) / 2;
+            quickSelect(order, begin, end - 1, mid + 1, CompareOnDim{&points, dim});
+            uint32_t right = index + 1 + nodeCount(mid - begin);
+            nodes_[index] = Node{points[order[mid]][dim], dim, base + begin, base + end, right};
+            forkJoin(depth,
+                     [&]() { buildProcess(points, ids, order, base, begin, mid, index + 1, depth - 1); },
+                     [&]() { buildProcess(points, ids, order, base, mid, end, right, depth - 1); });
         }
 
-        KdTree& operator=(KdTree&& rhs) noexcept
+        static Distance span(const Point& low, const Point& high, int d)
+        { return static_cast<Distance>(high[d]) - static_cast<Distance>(low[d]); }
+
+        // q在第一棵树中所在的叶子
+        uint32_t leafOf(const Point& q) const
         {
-            std::swap(root_, rhs.root_);
-            return *this;
+            uint32_t index = 0;
+            while(index < nodes_.size() && nodes_[index].dim_ >= 0)
+                index = q[nodes_[index].dim_] < nodes_[index].split_ ? index + 1 : nodes_[index].right_;
+            return index < nodes_.size() ? index : 0;
         }
 
-        bool empty() const
+        // 把距离q最近的至多k个点按从近到远写入out，返回个数，heap在多次查询间复用
+        std::size_t nearestInto(const Point& q, std::size_t k, Distance max_distance,
+                                NeighborHeap& heap, Neighbor* out) const
         {
-            return root_ == nullptr;
+            if(k == 0)
+                return 0;
+            heap.clear();
+            Distance bound = max_distance;
+            auto offer = [&](Distance distance, std::size_t slot) {
+                if(heap.size() == k && !(distance < heap.top().distance_))
+                    return;
+                if(heap.size() == k)
+                    heap.pop();
+                heap.insert(Candidate{distance, slot});
+                if(heap.size() == k)
+                    bound = std::min(max_distance, heap.top().distance_);
+            };
+            for(std::size_t i = 0; i < pending_.size(); ++i)
+            {
+                Distance distance = distanceTo(q, pending_[i]);
+                if(distance <= bound)
+                    offer(distance, slot_ids_.size() + i); // 缓冲区的点排在树中的点后面
+            }
+            for(const Tree& tree : trees_)
+                nearestProcess(q, tree.root_, bound, offer);
+
+            std::size_t n = heap.size();
+            for(std::size_t i = n; i-- > 0;)
+            {
+                const Candidate& c = heap.top();
+                out[i] = Neighbor{pointAt(c.slot_), idAt(c.slot_), c.distance_};
+                heap.pop();
+            }
+            return n;
         }
 
-        void clear()
+        // 依次回答queries[order[begin, end)]，前depth层把一半交给新线程
+        void batchProcess(const std::vector<Point>& queries, const std::vector<std::size_t>& order,
+                          std::size_t begin, std::size_t end, std::size_t k, Distance max_distance,
+                          std::vector<Neighbor>& result, int depth) const
         {
-            if(!empty())
-                clear(root_);
+            if(depth <= 0 || end - begin < 2)
+            {
+                NeighborHeap heap(FartherFirst(), k);
+                for(std::size_t i = begin; i < end; ++i)
+                    nearestInto(queries[order[i]], k, max_distance, heap, result.data() + order[i] * k);
+                return;
+            }
+            std::size_t mid = begin + (end - begin) / 2;
+            forkJoin(depth,
+                     [&]() { batchProcess(queries, order, begin, mid, k, max_distance, result, depth - 1); },
+                     [&]() { batchProcess(queries, order, mid, end, k, max_distance, result, depth - 1); });
         }
 
-        // 打印low~high范围内的点
-        void printRange(const std::vector<Object>& low, const std::vector<Object>& high) const
+        bool containsProcess(const Point& p, uint32_t index) const
         {
-            printRange(low, high, root_, 0);
+            const Node& node = nodes_[index];
+            if(node.dim_ < 0)
+            {
+                for(uint32_t slot = node.begin_; slot < node.end_; ++slot)
+                {
+                    int d = 0;
+                    while(d < D && coords_[d][slot] == p[d])
+                        ++d;
+                    if(d == D)
+                        return true;
+                }
+                return false;
+            }
+            // 与分割值相等的点可能在任意一边
+            if(!(node.split_ < p[node.dim_]) && containsProcess(p, index + 1))
+                return true;
+            return !(p[node.dim_] < node.split_) && containsProcess(p, node.right_);
         }
 
-        void insert(const std::vector<Object>& x)
+        template <typename Function>
+        void rangeProcess(const Point& low, const Point& high, uint32_t index, Function& fn) const
         {
-            insert(x, root_, 0);
+            const Node& node = nodes_[index];
+            if(node.dim_ < 0)
+            {
+                for(uint32_t slot = node.begin_; slot < node.end_; ++slot)
+                {
+                    int d = 0;
+                    while(d < D && !(coords_[d][slot] < low[d]) && !(high[d] < coords_[d][slot]))
+                        ++d;
+                    if(d == D)
+                        fn(pointAt(slot), slot_ids_[slot]);
+                }
+                return;
+            }
+            if(!(node.split_ < low[node.dim_]))
+                rangeProcess(low, high, index + 1, fn);
+            if(!(high[node.dim_] < node.split_))
+                rangeProcess(low, high, node.right_, fn);
         }
 
-        bool contain(const std::vector<Object>& item) const
+        // 叶子中所有点到q的距离，按维度累加，内层循环可被向量化
+        void leafDistances(const Point& q, const Node& node, Distance* distances) const
         {
-            if(empty())
-                return false;
-            return contain(item, root_, 0);
+            uint32_t n = node.end_ - node.begin_;
+            for(uint32_t i = 0; i < n; ++i)
+                distances[i] = 0;
+            for(int d = 0; d < D; ++d)
+            {
+                const Object* c = coords_[d].data() + node.begin_;
+                Distance qd = static_cast<Distance>(q[d]);
+                for(uint32_t i = 0; i < n; ++i)
+                {
+                    Distance diff = static_cast<Distance>(c[i]) - qd;
+                    distances[i] += diff * diff;
+                }
+            }
+        }
+
+        // 先进入q所在的一边，另一边只有在分割面的距离不超过bound时才进入
+        // bound为当前的剪枝距离(平方)，距离不超过bound的点交给offer，offer可以缩小bound
+        template <typename Offer>
+        void nearestProcess(const Point& q, uint32_t index, const Distance& bound, Offer& offer) const
+        {
+            const Node& node = nodes_[index];
+            if(node.dim_ < 0)
+            {
+                Distance distances[LEAF_SIZE];
+                leafDistances(q, node, distances);
+                for(uint32_t i = 0; i < node.end_ - node.begin_; ++i)
+                    if(distances[i] <= bound)
+                        offer(distances[i], node.begin_ + i);
+                return;
+            }
+            Distance diff = static_cast<Distance>(q[node.dim_]) - static_cast<Distance>(node.split_);
+            uint32_t near = diff < 0 ? index + 1 : node.right_;
+            uint32_t far = diff < 0 ? node.right_ : index + 1;
+            nearestProcess(q, near, bound, offer);
+            if(diff * diff <= bound)
+                nearestProcess(q, far, bound, offer);
         }
     };
+
+    template <typename Object, int D>
+    const int KdTree<Object, D>::LEAF_SIZE;
+
+    template <typename Object, int D>
+    const std::size_t KdTree<Object, D>::PENDING_LIMIT;
+
+    template <typename Object, int D>
+    const std::size_t KdTree<Object, D>::NOT_FOUND;
 }
 
 #endif //KD_TREE_HPP
@@ -0,0 +1,132 @@
+// k-d tree的建树与批量最近邻查询
+// 数据为三维float点:
+//   uniform     [0, 1)^3 中均匀分布
+//   clustered   64个中心附近的近似正态分布(三个均匀数之和)，标准差0.01
+// 建树: 逐个insert，与build的n_threads取1, 2, 4...比较
+// 查询: q个同分布的查询点，每个求k个最近点
+//   逐个调用nearest，与nearestBatch的n_threads取1, 2, 4...比较
+// 结果用距离的校验和比较
+//
+// 用法: kd_tree_benchmark [n] [queries] [k] [max_threads] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "kd_tree.hpp"
+#include "../lib/uniform_random.h"
+
+typedef DS::KdTree<float, 3> Tree;
+typedef Tree::Point Point;
+
+const int CLUSTERS = 64;
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+std::vector<Point> uniformPoints(std::size_t n, DS::UniformRandom& r)
+{
+    std::vector<Point> points(n);
+    for(auto& p : points)
+        for(auto& x : p)
+            x = static_cast<float>(r.nextDouble());
+    return points;
+}
+
+std::vector<Point> clusteredPoints(std::size_t n, DS::UniformRandom& r)
+{
+    std::vector<Point> centers = uniformPoints(CLUSTERS, r);
+    std::vector<Point> points(n);
+    for(auto& p : points)
+    {
+        const Point& c = centers[r.nextInt(0, CLUSTERS - 1)];
+        for(int d = 0; d < 3; ++d)
+            p[d] = c[d] + static_cast<float>((r.nextDouble() + r.nextDouble() + r.nextDouble() - 1.5) * 0.02);
+    }
+    return points;
+}
+
+double checksum(const std::vector<Tree::Neighbor>& neighbors)
+{
+    double sum = 0;
+    for(const auto& x : neighbors)
+        sum += x.distance;
+    return sum;
+}
+
+void bench(const std::string& name, const std::vector<Point>& points, const std::vector<Point>& queries,
+           std::size_t k, unsigned max_threads)
+{
+    std::cout << name << std::endl;
+    double t_insert = seconds([&]() {
+        Tree t;
+        for(const Point& p : points)
+            t.insert(p);
+    });
+    std::cout << "  build (ms)      insert one by one " << std::fixed << std::setprecision(1)
+              << t_insert * 1000 << ", build";
+    for(unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        std::cout << std::setw(9) << seconds([&]() { Tree t(points, n_threads); }) * 1000;
+    std::cout << std::endl;
+
+    Tree t(points, max_threads);
+    std::vector<Tree::Neighbor> expect;
+    expect.reserve(queries.size() * k);
+    double t_single = seconds([&]() {
+        for(const Point& q : queries)
+        {
+            auto result = t.nearest(q, k);
+            expect.insert(expect.end(), result.begin(), result.end());
+        }
+    });
+    double sum = checksum(expect);
+    std::cout << "  query (M/s)     nearest one by one " << std::setprecision(3)
+              << queries.size() / t_single / 1e6 << ", nearestBatch";
+    bool ok = true;
+    for(unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+    {
+        std::vector<Tree::Neighbor> result;
+        double time = seconds([&]() { result = t.nearestBatch(queries, k, n_threads); });
+        ok = ok && checksum(result) == sum;
+        std::cout << std::setw(9) << queries.size() / time / 1e6;
+    }
+    std::cout << (ok ? "" : "  MISMATCH!") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000000;
+    std::size_t q = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : 200000;
+    std::size_t k = argc > 3 ? static_cast<std::size_t>(atol(argv[3])) : 8;
+    unsigned max_threads = argc > 4 ? static_cast<unsigned>(atoi(argv[4])) : 4;
+    int seed = argc > 5 ? atoi(argv[5]) : 1;
+    if(n < 1 || k < 1 || max_threads < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [n >= 1] [queries] [k >= 1] [max_threads >= 1] [seed]" << std::endl;
+        return 1;
+    }
+
+    std::cout << n << " points, " << q << " queries, k = " << k << ", threads:";
+    for(unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        std::cout << " " << n_threads;
+    std::cout << std::endl;
+
+    DS::UniformRandom r(seed);
+    std::vector<Point> points = uniformPoints(n, r);
+    std::vector<Point> queries = uniformPoints(q, r);
+    bench("uniform", points, queries, k, max_threads);
+    points = clusteredPoints(n + q, r);
+    queries.assign(points.begin() + n, points.end());
+    points.resize(n);
+    bench("clustered", points, queries, k, max_threads);
+    return 0;
+}
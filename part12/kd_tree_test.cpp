@@ -1,29 +1,191 @@
 #include <iostream>
+#include <vector>
+#include <algorithm>
 #include "kd_tree.hpp"
+#include "../lib/uniform_random.h"
 
 using namespace std;
 using DS::KdTree;
+using DS::UniformRandom;
+
+// 与暴力查找比较 kNN、半径查询、范围查询与contains
+template <typename Object, int D>
+void check(KdTree<Object, D>& t, const vector<typename KdTree<Object, D>::Point>& points,
+           const typename KdTree<Object, D>::Point& q, const typename KdTree<Object, D>::Point& low,
+           const typename KdTree<Object, D>::Point& high, typename KdTree<Object, D>::Distance r)
+{
+    typedef typename KdTree<Object, D>::Distance Distance;
+    auto dist = [&](const typename KdTree<Object, D>::Point& p) {
+        Distance sum = 0;
+        for (int d = 0; d < D; ++d)
+            sum += (Distance(p[d]) - Distance(q[d])) * (Distance(p[d]) - Distance(q[d]));
+        return sum;
+    };
+
+    vector<Distance> all;
+    for (auto& p : points)
+        all.push_back(dist(p));
+    sort(all.begin(), all.end());
+    const size_t K = 10;
+    auto knn = t.nearest(q, K);
+    if (knn.size() != min(K, points.size()))
+        cout << "Nearest size error!" << endl;
+    for (size_t i = 0; i < knn.size(); ++i)
+        if (knn[i].distance != all[i] || dist(knn[i].point) != knn[i].distance || points[knn[i].id] != knn[i].point)
+            cout << "Nearest error!" << endl;
+
+    size_t in_radius = 0, in_box = 0;
+    for (auto& p : points)
+    {
+        in_radius += dist(p) <= r * r;
+        bool inside = true;
+        for (int d = 0; d < D; ++d)
+            inside = inside && low[d] <= p[d] && p[d] <= high[d];
+        in_box += inside;
+    }
+    size_t count = 0;
+    t.forEachInRadius(q, r, [&](const typename KdTree<Object, D>::Point& p, size_t id, Distance distance) {
+        if (distance > r * r || points[id] != p)
+            cout << "Radius error!" << endl;
+        ++count;
+    });
+    if (count != in_radius)
+        cout << "Radius count error!" << endl;
+    if (t.nearest(q, points.size(), r * r).size() != in_radius)
+        cout << "Nearest max distance error!" << endl;
+
+    count = 0;
+    t.forEachInRange(low, high, [&](const typename KdTree<Object, D>::Point& p, size_t id) {
+        for (int d = 0; d < D; ++d)
+            if (p[d] < low[d] || high[d] < p[d] || points[id] != p)
+                cout << "Range error!" << endl;
+        ++count;
+    });
+    if (count != in_box)
+        cout << "Range count error!" << endl;
+}
+
+template <typename Object, int D>
+void randomTest(int n, int scale)
+{
+    typedef typename KdTree<Object, D>::Point Point;
+    UniformRandom r{n};
+    auto randomPoint = [&]() {
+        Point p;
+        for (int d = 0; d < D; ++d)
+            p[d] = static_cast<Object>(r.nextInt(0, scale));
+        return p;
+    };
+    vector<Point> points;
+    for (int i = 0; i < n; ++i)
+        points.push_back(randomPoint());
+
+    // 批量建树后逐个插入，插入会触发树的合并
+    KdTree<Object, D> t(points);
+    for (int i = 0; i < n; ++i)
+    {
+        points.push_back(randomPoint());
+        t.insert(points.back());
+        if (i % 997 == 0)
+            check(t, points, randomPoint(), randomPoint(), randomPoint(), scale / 8);
+    }
+    if (t.size() != points.size())
+        cout << "Size error!" << endl;
+    for (int i = 0; i < 100; ++i)
+    {
+        Point low = randomPoint();
+        Point high = low;
+        for (int d = 0; d < D; ++d)
+            high[d] += scale / 4;
+        check(t, points, randomPoint(), low, high, scale / 10);
+        if (!t.contains(points[r.nextInt(0, static_cast<int>(points.size()) - 1)]))
+            cout << "Contains error!" << endl;
+    }
+
+    // 只用insert建成的一组树: 缓冲区满时与末尾的树合并
+    KdTree<Object, D> grown;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        grown.insert(points[i]);
+        if (i % 1499 == 0)
+            check(grown, vector<Point>(points.begin(), points.begin() + i + 1), randomPoint(), randomPoint(),
+                  randomPoint(), scale / 8);
+    }
+    check(grown, points, randomPoint(), randomPoint(), randomPoint(), scale / 8);
+
+    // 多线程建树与批量查询，结果应与单个查询相同
+    KdTree<Object, D> p(points, 4);
+    vector<Point> queries;
+    for (int i = 0; i < 1000; ++i)
+        queries.push_back(randomPoint());
+    const size_t K = 5;
+    auto batch = p.nearestBatch(queries, K, 4);
+    if (batch.size() != queries.size() * K)
+        cout << "Batch size error!" << endl;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        auto single = t.nearest(queries[i], K);
+        for (size_t j = 0; j < K; ++j)
+            if (batch[i * K + j].distance != single[j].distance || batch[i * K + j].point != points[batch[i * K + j].id])
+                cout << "Batch error!" << endl;
+    }
+    KdTree<Object, D> small(vector<Point>(points.begin(), points.begin() + 3), 2);
+    batch = small.nearestBatch(queries, K, 2);
+    for (size_t i = 0; i < queries.size(); ++i)
+        if (batch[i * K + 2].id == KdTree<Object, D>::NOT_FOUND || batch[i * K + 3].id != KdTree<Object, D>::NOT_FOUND)
+            cout << "Batch padding error!" << endl;
+
+    // 空树与只有insert的点(还没有建树)时也能批量查询
+    KdTree<Object, D> none;
+    batch = none.nearestBatch(queries, K, 2);
+    for (const auto& x : batch)
+        if (x.id != KdTree<Object, D>::NOT_FOUND)
+            cout << "Empty batch error!" << endl;
+    KdTree<Object, D> pending;
+    for (size_t i = 0; i < 3; ++i)
+        pending.insert(points[i]);
+    batch = pending.nearestBatch(queries, K, 2);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        auto single = pending.nearest(queries[i], K);
+        if (single.size() != 3 || batch[i * K + 3].id != KdTree<Object, D>::NOT_FOUND)
+            cout << "Pending batch error!" << endl;
+        for (size_t j = 0; j < single.size(); ++j)
+            if (batch[i * K + j].distance != single[j].distance || batch[i * K + j].id != single[j].id)
+                cout << "Pending batch error!" << endl;
+    }
+
+    KdTree<Object, D> c = t;
+    t.clear();
+    if (!t.empty() || t.contains(points[0]) || !t.nearest(points[0], 3).empty() || !c.contains(points[0]))
+        cout << "Clear error!" << endl;
+}
 
 int main()
 {
     KdTree<int> t;
 
-    cout << "Starting program" << endl;
+    cout << "Checking... (no more output means success)" << endl;
     for (int i = 300; i < 370; ++i)
+        t.insert({{i, 2500 - i}});
+    t.printRange({{70, 2186}}, {{1200, 2200}});
+
+    // 坐标接近int的两端，跨度超出int的范围
     {
-        vector<int> it(2);
-        it[0] = i;
-        it[1] = 2500 - i;
-        t.insert(it);
+        typedef KdTree<int>::Point Point;
+        vector<Point> extreme;
+        for (int i = 0; i < 100; ++i)
+            extreme.push_back(Point{{i % 2 ? 2000000000 - i : -2000000000 + i, i * 1000}});
+        KdTree<int> e(extreme);
+        check(e, extreme, Point{{1999999000, 0}}, Point{{-2000000000, 0}}, Point{{0, 50000}}, 100000);
     }
 
-    vector<int> low(2), high(2);
-    low[0] = 70;
-    low[1] = 2186;
-    high[0] = 1200;
-    high[1] = 2200;
-
-    t.printRange(low, high);
+    // 重复点多，分割值两侧都有相同坐标
+    randomTest<int, 2>(5000, 100);
+    randomTest<int, 2>(5000, 1000000);
+    randomTest<float, 3>(5000, 1000);
+    randomTest<double, 5>(2000, 1000);
 
+    cout << "Test finished" << endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,228 @@
+// 顺序统计(rank/select/countInRange)的性能对比
+// 顺序统计AVL树、顺序统计红黑树与基于排序的做法:
+//   sorted vector   排序后用lower_bound求rank，下标求select
+//                   更新时把新增的关键字追加后重新排序，删除用set_difference
+// 两种场景:
+//   static   建立一次，然后查询
+//   dynamic  多轮 (插入B个、删除B个、查询)，每轮之后排序的做法要重新整理数组
+// 所有做法的查询结果用校验和比较
+//
+// 用法: order_statistic_benchmark [n] [n_queries] [n_rounds] [batch] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstdlib>
+#include "rb_tree.hpp"
+#include "../part4/avl_tree.hpp"
+#include "../lib/uniform_random.h"
+
+typedef DS::AVLTree<int, true> RankAVL;
+typedef DS::RedBlackTree<int, DS::RBIdentity<int>, true> RankRB;
+
+const int KEY_RANGE = 0x3fffffff;
+
+// 有序数组，rank/select/countInRange 与树的接口一致
+class SortedVector
+{
+public:
+    void build(std::vector<int> keys)
+    {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        data_.swap(keys);
+    }
+
+    // 一轮批量更新，重新排序
+    void update(const std::vector<int>& inserted, std::vector<int> removed)
+    {
+        std::vector<int> merged(data_);
+        merged.insert(merged.end(), inserted.begin(), inserted.end());
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        std::sort(removed.begin(), removed.end());
+        data_.clear();
+        std::set_difference(merged.begin(), merged.end(), removed.begin(), removed.end(),
+                            std::back_inserter(data_));
+    }
+
+    std::size_t size() const
+    { return data_.size(); }
+
+    std::size_t rank(int x) const
+    { return std::lower_bound(data_.begin(), data_.end(), x) - data_.begin(); }
+
+    int select(std::size_t k) const
+    { return data_[k]; }
+
+    std::size_t countInRange(int lo, int hi) const
+    {
+        if(hi < lo)
+            return 0;
+        return std::upper_bound(data_.begin(), data_.end(), hi) - std::lower_bound(data_.begin(), data_.end(), lo);
+    }
+
+private:
+    std::vector<int> data_;
+};
+
+template <typename Tree>
+void buildTree(Tree& t, const std::vector<int>& keys)
+{
+    for(int x : keys)
+        t.insert(x);
+}
+
+void buildTree(SortedVector& t, const std::vector<int>& keys)
+{
+    t.build(keys);
+}
+
+template <typename Tree>
+void updateTree(Tree& t, const std::vector<int>& inserted, const std::vector<int>& removed)
+{
+    for(int x : inserted)
+        t.insert(x);
+    for(int x : removed)
+        t.remove(x);
+}
+
+void updateTree(SortedVector& t, const std::vector<int>& inserted, const std::vector<int>& removed)
+{
+    t.update(inserted, removed);
+}
+
+struct Round
+{
+    std::vector<int> inserted;
+    std::vector<int> removed;
+};
+
+struct Workload
+{
+    std::vector<int> keys;
+    std::vector<int> queries; // rank和countInRange的关键字
+    std::vector<double> positions; // select的相对位置 [0, 1)
+    std::vector<Round> rounds;
+};
+
+Workload makeWorkload(std::size_t n, std::size_t n_queries, int n_rounds, std::size_t batch, int seed)
+{
+    DS::UniformRandom r(seed);
+    Workload w;
+    w.keys.resize(n);
+    for(auto& x : w.keys)
+        x = r.nextInt(0, KEY_RANGE);
+    w.queries.resize(n_queries);
+    for(auto& x : w.queries)
+        x = r.nextInt(0, KEY_RANGE);
+    w.positions.resize(n_queries);
+    for(auto& p : w.positions)
+        p = r.nextDouble();
+    w.rounds.resize(n_rounds);
+    for(auto& round : w.rounds)
+    {
+        for(std::size_t i = 0; i < batch; ++i)
+        {
+            round.inserted.push_back(r.nextInt(0, KEY_RANGE));
+            round.removed.push_back(w.keys[r.nextInt(0, static_cast<int>(n) - 1)]);
+        }
+    }
+    return w;
+}
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// queries中 [first, last) 的rank/select/countInRange
+template <typename Tree>
+uint64_t query(const Tree& t, const Workload& w, std::size_t first, std::size_t last)
+{
+    uint64_t checksum = 0;
+    for(std::size_t i = first; i < last; ++i)
+    {
+        int x = w.queries[i];
+        checksum += t.rank(x);
+        checksum += static_cast<uint32_t>(t.select(static_cast<std::size_t>(w.positions[i] * t.size())));
+        checksum += t.countInRange(x, x + (KEY_RANGE >> 10));
+    }
+    return checksum;
+}
+
+struct Expect
+{
+    uint64_t static_sum;
+    uint64_t dynamic_sum;
+};
+
+template <typename Tree>
+void bench(const std::string& name, const Workload& w, Expect& expect, bool first)
+{
+    uint64_t static_sum = 0;
+    uint64_t dynamic_sum = 0;
+    double t_build, t_query, t_update = 0, t_dynamic_query = 0;
+    {
+        Tree* t = new Tree;
+        t_build = seconds([&]() { buildTree(*t, w.keys); });
+        t_query = seconds([&]() { static_sum = query(*t, w, 0, w.queries.size()); });
+
+        std::size_t per_round = w.rounds.empty() ? 0 : w.queries.size() / w.rounds.size();
+        for(std::size_t i = 0; i < w.rounds.size(); ++i)
+        {
+            t_update += seconds([&]() { updateTree(*t, w.rounds[i].inserted, w.rounds[i].removed); });
+            t_dynamic_query += seconds([&]() {
+                dynamic_sum += query(*t, w, i * per_round, (i + 1) * per_round);
+            });
+        }
+        delete t;
+    }
+    if(first)
+    {
+        expect.static_sum = static_sum;
+        expect.dynamic_sum = dynamic_sum;
+    }
+
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << t_build * 1000 << std::setw(10) << t_query * 1000
+              << std::setw(10) << t_update * 1000 << std::setw(10) << t_dynamic_query * 1000
+              << ((static_sum == expect.static_sum && dynamic_sum == expect.dynamic_sum) ? "" : "  MISMATCH!")
+              << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 10000000;
+    std::size_t n_queries = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : 1000000;
+    int n_rounds = argc > 3 ? atoi(argv[3]) : 10;
+    std::size_t batch = argc > 4 ? static_cast<std::size_t>(atol(argv[4])) : 1000;
+    int seed = argc > 5 ? atoi(argv[5]) : 1;
+    if(n < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [n >= 1] [n_queries] [n_rounds] [batch] [seed]" << std::endl;
+        return 1;
+    }
+
+    Workload w = makeWorkload(n, n_queries, n_rounds, batch, seed);
+    std::cout << n << " keys, " << n_queries << " x (rank + select + countInRange), "
+              << n_rounds << " rounds of " << batch << " inserts + " << batch << " removes" << std::endl;
+    std::cout << "  " << std::setw(16) << "" << std::setw(10) << "build" << std::setw(10) << "query"
+              << std::setw(10) << "update" << std::setw(10) << "query" << "   (ms)" << std::endl;
+    std::cout << "  " << std::setw(16) << "" << std::setw(20) << "static" << std::setw(20) << "dynamic" << std::endl;
+
+    Expect expect;
+    bench<SortedVector>("sorted vector", w, expect, true);
+    bench<RankAVL>("AVLTree", w, expect, false);
+    bench<RankRB>("RedBlackTree", w, expect, false);
+    return 0;
+}
@@ -2,287 +2,393 @@
 #define PAIRING_HEAP_HPP
 
 #include <iostream>
+#include <vector>
+#include <cstdint>
 #include <stdexcept>
 #include "../lib/dsexceptions.h"
 
 // Pairing heap class
 // 适合decreaseKey修改节点关键字值的场景
 // 小根堆
-// CONSTRUCTION: with no parameters
+// CONSTRUCTION: with an optional combine mode and compare function
 //
 // ******************PUBLIC OPERATIONS*********************
-// PairNode & insert( x ) --> Insert x
+// Position insert( x ) --> Insert x
 // pop( minItem )   --> Remove (and optionally return) top item
 // Comparable top( )  --> Return top item
 // bool empty( )        --> Return true if empty; else false
+// size_t size( )       --> Return number of items
 // void clear( )      --> Remove all items
 // void decreaseKey( Position p, newVal )
 //                        --> Decrease value in Position p
 // ******************ERRORS********************************
 // Throws UnderflowException as warranted
+//
+// 实现说明:
+// 节点存放在每个堆自己的节点池nodes_中，用32位下标相连，Position即为节点下标
+// Position在对应元素被pop之前一直有效，节点池扩容不会使其失效
+// 合并兄弟用的临时数组scratch_也属于每个堆，不同的堆可以在不同线程中同时使用
+// 合并兄弟的策略:
+//   TWO_PASS           从左到右两两合并，再从右到左依次合并(经典两趟)
+//   MULTI_PASS         把树放入队列，每次取队首两棵合并后放回队尾，直到只剩一棵
+//   BACKWARD_ONE_PASS  沿prev_从最右边向左一趟扫描，边两两配对边并入已合并的树，不需要临时数组
 
 namespace DS
 {
+    // 默认的比较函数
     template <typename Object>
+    class IsLessPH
+    {
+    public:
+        bool operator() (const Object& lhs, const Object& rhs) const
+        {
+            return lhs < rhs;
+        }
+    };
+
+    template <typename Object, class Compare = IsLessPH<Object>>
     class PairingHeap
     {
+    public:
+        enum CombineMode
+        {
+            TWO_PASS,
+            MULTI_PASS,
+            BACKWARD_ONE_PASS
+        };
+
+        typedef uint32_t Position;
+
     private:
         class PairNode
         {
         public:
             Object element_;
-            PairNode* first_child_;
-            PairNode* next_sibling_;
-            PairNode* prev_;
+            uint32_t first_child_;
+            uint32_t next_sibling_; // 空闲节点用它串成空闲链表
+            uint32_t prev_; // 第一个儿子指向父节点，其余指向左兄弟
 
-            explicit PairNode(const Object& e, PairNode* fc = nullptr, PairNode* ns = nullptr, PairNode* p = nullptr)
+            explicit PairNode(const Object& e, uint32_t fc = NIL, uint32_t ns = NIL, uint32_t p = NIL)
             : element_{e}, first_child_{fc}, next_sibling_{ns}, prev_{p}
             {}
 
-            explicit PairNode(Object&& e, PairNode* fc = nullptr, PairNode* ns = nullptr, PairNode* p = nullptr)
+            explicit PairNode(Object&& e, uint32_t fc = NIL, uint32_t ns = NIL, uint32_t p = NIL)
             : element_{std::move(e)}, first_child_{fc}, next_sibling_{ns}, prev_{p}
             {}
         };
 
-        PairNode* root_;
+        const static uint32_t NIL = 0xffffffffu; // 空下标
+
+        std::vector<PairNode> nodes_; // 节点池
+        std::vector<uint32_t> scratch_; // 合并兄弟用的临时数组
+        uint32_t root_;
+        uint32_t free_; // 空闲链表头
+        std::size_t size_;
+        CombineMode mode_;
+        Compare compare_;
 
-        void clone(PairNode*& root, PairNode* other)
+        template <typename T>
+        uint32_t allocate(T&& x)
         {
-            if(nullptr == other)
-                return;
-            root = new PairNode{other->element_};
-            if(other->first_child_)
+            if(free_ != NIL)
             {
-                clone(root->first_child_, other->first_child_);
-                root->first_child_->prev_ = root;
-            }
-            if(other->next_sibling_)
-            {
-                clone(root->next_sibling_, other->next_sibling_);
-                root->next_sibling_->prev_ = root;
+                uint32_t id = free_;
+                free_ = nodes_[id].next_sibling_;
+                nodes_[id].element_ = std::forward<T>(x);
+                nodes_[id].first_child_ = NIL;
+                nodes_[id].next_sibling_ = NIL;
+                nodes_[id].prev_ = NIL;
+                return id;
             }
+            nodes_.emplace_back(std::forward<T>(x));
+            return static_cast<uint32_t>(nodes_.size() - 1);
+        }
+
+        void release(uint32_t id)
+        {
+            nodes_[id].next_sibling_ = free_;
+            free_ = id;
         }
 
-        void clear(PairNode* root)
+        // 将两棵独立的树(根没有兄弟和父亲)连接在一起以满足堆序
+        // 返回新的根，较大的根成为较小根的第一个儿子
+        uint32_t link(uint32_t first, uint32_t second)
         {
-            if(nullptr == root)
-                return;
-            PairNode *fc = root->first_child_;
-            PairNode *ns = root->next_sibling_;
-            delete root;
-            clear(fc);
-            clear(ns);
+            if(compare_(nodes_[second].element_, nodes_[first].element_))
+                std::swap(first, second);
+            PairNode& parent = nodes_[first];
+            PairNode& child = nodes_[second];
+            child.prev_ = first;
+            child.next_sibling_ = parent.first_child_;
+            if(child.next_sibling_ != NIL)
+                nodes_[child.next_sibling_].prev_ = second;
+            parent.first_child_ = second;
+            return first;
         }
 
-        // 将first和second连接在一起以满足堆序
-        // first是树1的根，它可以不是nullptr
-        // first->next_sibling_ 在接入时必须是nullptr
-        // 所以root节点是唯一的，没有兄弟
-        // second是树2的根，可以是nullptr
-        // 合并结果到first上
-        void compareAndLink(PairNode*& first, PairNode* second)
+        // firstSibling是待合并的兄弟链表的第一个节点，假设不是NIL
+        // 返回合并后树的根
+        uint32_t combineSiblings(uint32_t first_sibling)
         {
-            if(second == nullptr)
-                return;
-            if(second->element_ < first->element_)
+            if(nodes_[first_sibling].next_sibling_ == NIL)
+            {
+                nodes_[first_sibling].prev_ = NIL;
+                return first_sibling;
+            }
+            if(mode_ == BACKWARD_ONE_PASS)
+                return backwardOnePass(first_sibling);
+            // 保存子树，并把每棵子树变成独立的树
+            scratch_.clear();
+            while(first_sibling != NIL)
             {
-                // first 成为second的第一个儿子
-                second->prev_ = first->prev_;
-                first->next_sibling_ = second->first_child_;
-                first->prev_ = second;
-                if(first->next_sibling_ != nullptr)
-                    first->next_sibling_->prev_ = first;
-                second->first_child_ = first;
-                first = second;
-            } else {
-                // second 变成 first的第一个儿子
-                second->prev_ = first;
-                first->next_sibling_ = second->next_sibling_;
-                if(first->next_sibling_)
-                    first->next_sibling_->prev_ = first;
-                second->next_sibling_ = first->first_child_;
-                if(second->next_sibling_)
-                    second->next_sibling_->prev_ = second;
-                first->first_child_ = second;
+                scratch_.push_back(first_sibling);
+                uint32_t next = nodes_[first_sibling].next_sibling_;
+                nodes_[first_sibling].next_sibling_ = NIL;
+                nodes_[first_sibling].prev_ = NIL;
+                first_sibling = next;
             }
+
+            if(mode_ == MULTI_PASS)
+                return multiPass();
+            return twoPass();
         }
 
         // 实现两趟合并的方法
-        // firstSibling是合并后树的根，假设不是nullptr
-        PairNode* combineSiblings(PairNode* firstSibling)
+        uint32_t twoPass()
         {
-            if(firstSibling->next_sibling_ == nullptr)
-                return firstSibling;
-            // 保存子树用
-            static std::vector<PairNode*> tree_array(5);
-            // 遍历firstSibling和其所有兄弟，保存子树
-            int n_siblings = 0;
-            for(; firstSibling != nullptr; ++n_siblings)
+            std::size_t n_siblings = scratch_.size();
+            std::size_t n_pairs = 0;
+            std::size_t i = 0;
+            for(; i + 1 < n_siblings; i += 2) // 两两合并
+                scratch_[n_pairs++] = link(scratch_[i], scratch_[i + 1]);
+            if(i < n_siblings) // n_siblings 为奇数，保留遗漏的一棵子树
+                scratch_[n_pairs++] = scratch_[i];
+            // 将上一步合并的树从右到左一一合并
+            uint32_t tree = scratch_[n_pairs - 1];
+            for(std::size_t j = n_pairs - 1; j-- > 0; )
+                tree = link(scratch_[j], tree);
+            return tree;
+        }
+
+        // 多趟合并，scratch_当作队列使用，每次合并后的树追加到末尾
+        uint32_t multiPass()
+        {
+            for(std::size_t i = 0; i + 1 < scratch_.size(); i += 2)
             {
-                if(n_siblings == tree_array.size())
-                    tree_array.resize(n_siblings * 2);
-                tree_array[n_siblings] = firstSibling;
-                firstSibling = firstSibling->next_sibling_;
+                uint32_t tree = link(scratch_[i], scratch_[i + 1]);
+                scratch_.push_back(tree);
             }
-            if(n_siblings == tree_array.size())
-                tree_array.resize(n_siblings + 1);
-            tree_array[n_siblings] = nullptr;
-
-            // 由于在合并时，每个子树的根的兄弟会被舍弃(视为nullptr)
-            // 所以用tree_array保存树根的兄弟，并用于后续合并
-            // combine
-            int i = 0;
-            for(; i + 1 < n_siblings; i += 2) // 两两合并
-                compareAndLink(tree_array[i], tree_array[i + 1]);
-            int j = i - 2;
-            if(j == n_siblings - 3) // n_siblings 为奇数，合并遗漏的一棵子树
-                compareAndLink(tree_array[j], tree_array[j + 2]);
-            for(; j >= 2; j -= 2) // 将上一步合并的树一一合并
-                compareAndLink(tree_array[j - 2], tree_array[j]);
-            return tree_array[0];
+            return scratch_.back();
         }
 
-    public:
-        typedef PairNode* Position;
+        // 从右到左的一趟合并，配对从最右边开始，利用prev_向左移动
+        // first_sibling的prev_指向被删除的父节点，用它判断扫描结束
+        uint32_t backwardOnePass(uint32_t first_sibling)
+        {
+            uint32_t cur = first_sibling;
+            while(nodes_[cur].next_sibling_ != NIL)
+                cur = nodes_[cur].next_sibling_;
 
-        explicit PairingHeap()
-        : root_{nullptr}
-        {}
+            uint32_t tree = NIL;
+            while(cur != NIL)
+            {
+                uint32_t pair = cur;
+                uint32_t next = NIL;
+                if(cur != first_sibling)
+                {
+                    uint32_t left = nodes_[cur].prev_;
+                    next = left == first_sibling ? NIL : nodes_[left].prev_;
+                    detach(left);
+                    detach(cur);
+                    pair = link(left, cur);
+                } else
+                    detach(cur);
+                tree = tree == NIL ? pair : link(pair, tree);
+                cur = next;
+            }
+            return tree;
+        }
 
-        ~PairingHeap()
+        // 把兄弟链表中的节点变成独立的树，调用者负责维护链表
+        void detach(uint32_t p)
         {
-            clear();
+            nodes_[p].next_sibling_ = NIL;
+            nodes_[p].prev_ = NIL;
         }
 
-        PairingHeap(const PairingHeap& rhs)
-        : root_{nullptr}
+        // 将节点p从它所在的兄弟链表中摘下，p不是根
+        void cut(uint32_t p)
         {
-            if(rhs.root_)
-                clone(root_, rhs.root_);
+            PairNode& node = nodes_[p];
+            // p有兄弟的话，p兄弟的prev连接p的prev
+            if(node.next_sibling_ != NIL)
+                nodes_[node.next_sibling_].prev_ = node.prev_;
+            if(nodes_[node.prev_].first_child_ == p) // 如果p是父节点的第一个儿子
+                nodes_[node.prev_].first_child_ = node.next_sibling_;
+            else // 否则p的上一个(prev)兄弟直连p的下一个兄弟
+                nodes_[node.prev_].next_sibling_ = node.next_sibling_;
+            node.next_sibling_ = NIL;
+            node.prev_ = NIL;
         }
 
+        // p改值后可能小于所属的父节点，剪下后与根合并
+        void afterDecrease(uint32_t p)
+        {
+            if(p != root_) // p不是根
+            {
+                cut(p);
+                root_ = link(root_, p);
+            }
+        }
+
+    public:
+        explicit PairingHeap(CombineMode mode = TWO_PASS, const Compare& cmp = Compare())
+        : root_{NIL}, free_{NIL}, size_{0}, mode_{mode}, compare_{cmp}
+        {}
+
+        ~PairingHeap() = default;
+
+        // 节点之间用下标相连，节点池直接拷贝即可，Position在副本中同样有效
+        PairingHeap(const PairingHeap& rhs)
+        : nodes_{rhs.nodes_}, root_{rhs.root_}, free_{rhs.free_}, size_{rhs.size_},
+          mode_{rhs.mode_}, compare_{rhs.compare_}
+        {}
+
         PairingHeap(PairingHeap&& rhs) noexcept
-        : root_{rhs.root_}
+        : nodes_{std::move(rhs.nodes_)}, scratch_{std::move(rhs.scratch_)}, root_{rhs.root_},
+          free_{rhs.free_}, size_{rhs.size_}, mode_{rhs.mode_}, compare_{std::move(rhs.compare_)}
         {
-            rhs.root_ = nullptr;
+            rhs.nodes_.clear();
+            rhs.root_ = NIL;
+            rhs.free_ = NIL;
+            rhs.size_ = 0;
         }
 
         PairingHeap& operator=(const PairingHeap& rhs)
         {
             PairingHeap copy{rhs};
-            std::swap(*this, copy);
+            swap(copy);
             return *this;
         }
 
         PairingHeap& operator=(PairingHeap&& rhs) noexcept
         {
-            std::swap(root_, rhs.root_);
+            swap(rhs);
             return *this;
         }
 
+        void swap(PairingHeap& rhs) noexcept
+        {
+            std::swap(nodes_, rhs.nodes_);
+            std::swap(scratch_, rhs.scratch_);
+            std::swap(root_, rhs.root_);
+            std::swap(free_, rhs.free_);
+            std::swap(size_, rhs.size_);
+            std::swap(mode_, rhs.mode_);
+            std::swap(compare_, rhs.compare_);
+        }
+
         bool empty() const
         {
-            return root_ == nullptr;
+            return root_ == NIL;
+        }
+
+        std::size_t size() const
+        {
+            return size_;
         }
 
         const Object& top() const
         {
             if(empty())
                 throw UnderflowException{};
-            return root_->element_;
+            return nodes_[root_].element_;
         }
 
         void pop()
         {
             if(empty())
                 throw UnderflowException{};
-            PairNode* old_root = root_;
-            if(root_->first_child_ == nullptr)
-                root_ = nullptr;
+            uint32_t old_root = root_;
+            if(nodes_[root_].first_child_ == NIL)
+                root_ = NIL;
             else
-                root_ = combineSiblings(root_->first_child_);
-            delete old_root;
+                root_ = combineSiblings(nodes_[root_].first_child_);
+            release(old_root);
+            --size_;
         }
 
         void pop(Object& item)
         {
-            item = top();
+            if(empty())
+                throw UnderflowException{};
+            item = std::move(nodes_[root_].element_);
             pop();
         }
 
+        // 释放全部节点，节点池的容量保留下来供后续插入使用
         void clear()
         {
-            clear(root_);
-            root_ = nullptr;
+            nodes_.clear();
+            root_ = NIL;
+            free_ = NIL;
+            size_ = 0;
         }
 
-        PairNode* insert(const Object& x)
+        // 预留节点池空间
+        void reserve(std::size_t n)
         {
-            PairNode* new_node = nullptr;
-            new_node = new PairNode(x);
-            if(nullptr == root_)
-                root_ = new_node;
-            else
-                compareAndLink(root_, new_node);
+            nodes_.reserve(n);
+        }
+
+        Position insert(const Object& x)
+        {
+            uint32_t new_node = allocate(x);
+            root_ = root_ == NIL ? new_node : link(root_, new_node);
+            ++size_;
             return new_node;
         }
 
-        PairNode* insert(Object&& x)
+        Position insert(Object&& x)
         {
-            PairNode* new_node = nullptr;
-            new_node = new PairNode{std::move(x)};
-            if(nullptr == root_)
-                root_ = new_node;
-            else
-                compareAndLink(root_, new_node);
+            uint32_t new_node = allocate(std::move(x));
+            root_ = root_ == NIL ? new_node : link(root_, new_node);
+            ++size_;
             return new_node;
         }
 
+        // 获取Position处的元素
+        const Object& at(Position p) const
+        {
+            return nodes_[p].element_;
+        }
+
         // 减小key的值
-        void decreaseKey(PairNode* p, const Object& new_val)
+        void decreaseKey(Position p, const Object& new_val)
         {
-            if(p->element_ < new_val)
+            if(compare_(nodes_[p].element_, new_val))
                 throw std::invalid_argument("new val should be not large than old val");
-            if(new_val < p->element_)
+            if(compare_(new_val, nodes_[p].element_))
             {
-                p->element_ = new_val; // 点p改值后可能小于所属的父节点
-                if (p != root_) // p不是根
-                {
-                    // p有兄弟的话，p兄弟的prev连接p的prev
-                    if (p->next_sibling_ != nullptr)
-                        p->next_sibling_->prev_ = p->prev_;
-                    if (p->prev_->first_child_ == p) // 如果p是父节点的第一个儿子
-                        p->prev_->first_child_ = p->next_sibling_;
-                    else // 否则p的上一个(prev)兄弟直连p的下一个兄弟
-                        p->prev_->next_sibling_ = p->next_sibling_;
-                    p->next_sibling_ = nullptr;
-                    compareAndLink(root_, p);
-                }
+                nodes_[p].element_ = new_val;
+                afterDecrease(p);
             }
         }
 
         // 减小key的值
-        void decreaseKey(PairNode* p, Object&& new_val)
+        void decreaseKey(Position p, Object&& new_val)
         {
-            if(p->element_ < new_val)
+            if(compare_(nodes_[p].element_, new_val))
                 throw std::invalid_argument("new val should be not large than old val");
-            if(new_val < p->element_)
+            if(compare_(new_val, nodes_[p].element_))
             {
-                p->element_ = std::move(new_val); // 点p改值后可能小于所属的父节点
-                if (p != root_) // p不是根
-                {
-                    // p有兄弟的话，p兄弟的prev连接p的prev
-                    if (p->next_sibling_ != nullptr)
-                        p->next_sibling_->prev_ = p->prev_;
-                    if (p->prev_->first_child_ == p) // 如果p是父节点的第一个儿子
-                        p->prev_->first_child_ = p->next_sibling_;
-                    else // 否则p的上一个(prev)兄弟直连p的下一个兄弟
-                        p->prev_->next_sibling_ = p->next_sibling_;
-                    p->next_sibling_ = nullptr;
-                    compareAndLink(root_, p);
-                }
+                nodes_[p].element_ = std::move(new_val);
+                afterDecrease(p);
             }
         }
     };
+
+    template <typename Object, class Compare>
+    const uint32_t PairingHeap<Object, Compare>::NIL;
 }
 #endif //PAIRING_HEAP_HPP
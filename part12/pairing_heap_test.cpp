@@ -5,16 +5,16 @@
 using namespace std;
 using DS::PairingHeap;
 
-// Test program
-int main()
+typedef PairingHeap<int> Heap;
+
+void test(Heap::CombineMode mode)
 {
-    PairingHeap<int> h;
+    Heap h(mode);
 
     int numItems = 4000;
     int i = 37;
     int j;
 
-    cout << "Checking; no bad output is good" << endl;
     for (i = 37; i != 0; i = (i + 37) % numItems)
         h.insert(i);
 
@@ -26,14 +26,14 @@ int main()
             cout << "Oops! " << i << endl;
     }
 
-    vector<PairingHeap<int>::Position> p(numItems);
+    vector<Heap::Position> p(numItems);
     for (i = 0, j = numItems / 2; i < numItems; ++i, j = (j + 71) % numItems)
         p[j] = h.insert(j + numItems);
     for (i = 0, j = numItems / 2; i < numItems; ++i, j = (j + 53) % numItems)
         h.decreaseKey(p[j], j);
     i = -1;
 
-    PairingHeap<int> h2;
+    Heap h2;
 
     h2 = h;
     while (!h2.empty())
@@ -43,7 +43,15 @@ int main()
         if (x != ++i)
             cout << "Oops! " << i << endl;
     }
+}
 
+// Test program
+int main()
+{
+    cout << "Checking; no bad output is good" << endl;
+    test(Heap::TWO_PASS);
+    test(Heap::MULTI_PASS);
+    test(Heap::BACKWARD_ONE_PASS);
     cout << "Check completed" << endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,363 @@
+#ifndef PERSISTENT_TREAP_HPP
+#define PERSISTENT_TREAP_HPP
+
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstddef>
+#include "../lib/uniform_random.h"
+#include "../lib/dsexceptions.h"
+#include "../lib/epoch.h"
+
+// PersistentTreap class
+// 可持久化(写时复制)树堆，适合读多写少、被很多线程同时读的集合
+// 已经发布的节点不再修改，更新时只复制从根到修改位置的路径(期望O(log n)个节点)，
+// 新旧版本共享其余的节点，然后原子地发布新的版本
+// ******************PUBLIC OPERATIONS*********************
+// Snapshot snapshot( )   --> Return the current version, lock-free
+// bool insert( x )       --> Insert x, return false if x is present
+// bool remove( x )       --> Remove x, return false if x is absent
+// bool contains( x )     --> Return true if x is present in the current version
+// size_t size( )         --> Return the number of items in the current version
+// bool empty( )          --> Return true if empty; else false
+// void clear( )          --> Remove all items
+// void reclaim( )        --> Free versions this thread replaced that no reader can reach
+// ******************SNAPSHOT OPERATIONS*******************
+// 快照是不可变的版本，之后的更新对它没有影响，可以复制、传给其它线程
+// bool contains( x ) / size( ) / empty( )
+// Object findMin( ) / findMax( )
+// void forEach( fn )     --> Call fn on each item in sorted order
+// void print( )          --> Print tree in sorted order
+// ******************ERRORS********************************
+// Throws UnderflowException as warranted
+//
+// 并发:
+// 读者只做原子操作，不加锁；写者之间用互斥锁串行
+// 节点和版本都用引用计数回收，节点被多个版本共享
+// 读者取快照时在Epoch::Guard中读根版本并增加其引用计数
+// 写者发布新版本后，把旧版本交给Epoch延迟释放(见lib/epoch.h): 等到发布前登记的读者都已离开，
+// 不需要所有读者同时空闲；读者在登记期间被调度出去时纪元无法前进，
+// 所以写者待释放的版本超过RETIRED_LIMIT时让出CPU，等读者离开后再继续，待释放的版本数有上界
+
+namespace DS
+{
+    template <typename Object>
+    class PersistentTreap
+    {
+    private:
+        struct TreeNode
+        {
+            Object element_;
+            TreeNode* left_;
+            TreeNode* right_;
+            int priority_;
+            std::atomic<int> refs_;
+
+            TreeNode(const Object& e, int pr, TreeNode* lt, TreeNode* rt)
+            : element_{e}, left_{lt}, right_{rt}, priority_{pr}, refs_{1}
+            {}
+        };
+
+        struct Version
+        {
+            TreeNode* root_;
+            std::size_t size_;
+            std::atomic<int> refs_;
+
+            Version(TreeNode* root, std::size_t size)
+            : root_{root}, size_{size}, refs_{1}
+            {}
+        };
+
+        static TreeNode* retain(TreeNode* node)
+        {
+            if(node != nullptr)
+                node->refs_.fetch_add(1, std::memory_order_relaxed);
+            return node;
+        }
+
+        static void release(TreeNode* node)
+        {
+            while(node != nullptr && node->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                TreeNode* right = node->right_;
+                release(node->left_);
+                delete node;
+                node = right;
+            }
+        }
+
+        static void retain(Version* v)
+        { v->refs_.fetch_add(1, std::memory_order_relaxed); }
+
+        static void release(Version* v)
+        {
+            if(v->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                release(v->root_);
+                delete v;
+            }
+        }
+
+        // Epoch::retire的deleter，释放树持有的引用
+        static void releaseRetired(void* p)
+        { release(static_cast<Version*>(p)); }
+
+        // 复制node，换上新的儿子(引用由调用者转交)，另一个儿子共享
+        static TreeNode* copyWithLeft(const TreeNode* node, TreeNode* left)
+        { return new TreeNode(node->element_, node->priority_, left, retain(node->right_)); }
+
+        static TreeNode* copyWithRight(const TreeNode* node, TreeNode* right)
+        { return new TreeNode(node->element_, node->priority_, retain(node->left_), right); }
+
+        // 以下函数返回新建的子树(持有一个引用)，新节点在发布之前可以直接修改
+        // x已经存在时返回nullptr
+        TreeNode* insertProcess(const TreeNode* node, const Object& x, int priority)
+        {
+            if(node == nullptr)
+                return new TreeNode(x, priority, nullptr, nullptr);
+            if(x < node->element_)
+            {
+                TreeNode* left = insertProcess(node->left_, x, priority);
+                if(left == nullptr)
+                    return nullptr;
+                TreeNode* copy = copyWithLeft(node, left);
+                if(left->priority_ < copy->priority_) // 右旋，两个节点都是新的
+                {
+                    copy->left_ = left->right_;
+                    left->right_ = copy;
+                    return left;
+                }
+                return copy;
+            }
+            if(node->element_ < x)
+            {
+                TreeNode* right = insertProcess(node->right_, x, priority);
+                if(right == nullptr)
+                    return nullptr;
+                TreeNode* copy = copyWithRight(node, right);
+                if(right->priority_ < copy->priority_) // 左旋
+                {
+                    copy->right_ = right->left_;
+                    right->left_ = copy;
+                    return right;
+                }
+                return copy;
+            }
+            return nullptr;
+        }
+
+        // 合并less和greater的复制，原来的节点不变
+        static TreeNode* join(const TreeNode* less, const TreeNode* greater)
+        {
+            if(less == nullptr)
+                return retain(const_cast<TreeNode*>(greater));
+            if(greater == nullptr)
+                return retain(const_cast<TreeNode*>(less));
+            if(less->priority_ < greater->priority_)
+                return copyWithRight(less, join(less->right_, greater));
+            return copyWithLeft(greater, join(less, greater->left_));
+        }
+
+        // x不存在时found为false，返回nullptr
+        static TreeNode* removeProcess(const TreeNode* node, const Object& x, bool& found)
+        {
+            if(node == nullptr)
+            {
+                found = false;
+                return nullptr;
+            }
+            if(x < node->element_)
+            {
+                TreeNode* left = removeProcess(node->left_, x, found);
+                return found ? copyWithLeft(node, left) : nullptr;
+            }
+            if(node->element_ < x)
+            {
+                TreeNode* right = removeProcess(node->right_, x, found);
+                return found ? copyWithRight(node, right) : nullptr;
+            }
+            found = true;
+            return join(node->left_, node->right_);
+        }
+
+        std::atomic<Version*> current_;
+        std::mutex write_mutex_;
+        UniformRandom random_;
+
+        static const std::size_t RETIRED_LIMIT = 1024;
+
+        // 调用者持有write_mutex_
+        void publish(Version* v)
+        {
+            Epoch::retire(current_.exchange(v), releaseRetired);
+            while(Epoch::pending() > RETIRED_LIMIT)
+            {
+                std::this_thread::yield();
+                Epoch::collect();
+            }
+        }
+
+    public:
+        class Snapshot
+        {
+        public:
+            Snapshot(const Snapshot& rhs)
+            : version_{rhs.version_}
+            { retain(version_); }
+
+            Snapshot& operator=(const Snapshot& rhs)
+            {
+                retain(rhs.version_);
+                release(version_);
+                version_ = rhs.version_;
+                return *this;
+            }
+
+            ~Snapshot()
+            { release(version_); }
+
+            bool contains(const Object& x) const
+            {
+                const TreeNode* node = version_->root_;
+                while(node != nullptr)
+                {
+                    if(x < node->element_)
+                        node = node->left_;
+                    else if(node->element_ < x)
+                        node = node->right_;
+                    else
+                        return true;
+                }
+                return false;
+            }
+
+            std::size_t size() const
+            { return version_->size_; }
+
+            bool empty() const
+            { return version_->root_ == nullptr; }
+
+            const Object& findMin() const
+            {
+                if(empty())
+                    throw UnderflowException{};
+                const TreeNode* node = version_->root_;
+                while(node->left_ != nullptr)
+                    node = node->left_;
+                return node->element_;
+            }
+
+            const Object& findMax() const
+            {
+                if(empty())
+                    throw UnderflowException{};
+                const TreeNode* node = version_->root_;
+                while(node->right_ != nullptr)
+                    node = node->right_;
+                return node->element_;
+            }
+
+            template <typename Function>
+            void forEach(Function fn) const
+            { forEachProcess(version_->root_, fn); }
+
+            void print(std::ostream& out = std::cout) const
+            {
+                if(empty())
+                    out << "Empty tree" << std::endl;
+                else
+                    forEach([&out](const Object& x) { out << x << std::endl; });
+            }
+
+        private:
+            friend class PersistentTreap;
+
+            Version* version_;
+
+            // 引用已经由调用者增加
+            explicit Snapshot(Version* v)
+            : version_{v}
+            {}
+
+            template <typename Function>
+            static void forEachProcess(const TreeNode* node, Function& fn)
+            {
+                while(node != nullptr)
+                {
+                    forEachProcess(node->left_, fn);
+                    fn(node->element_);
+                    node = node->right_;
+                }
+            }
+        };
+
+        PersistentTreap()
+        : current_{new Version(nullptr, 0)}
+        {}
+
+        PersistentTreap(const PersistentTreap& rhs) = delete;
+
+        PersistentTreap& operator=(const PersistentTreap& rhs) = delete;
+
+        // 快照和Epoch中待释放的版本各自持有引用，可以比树活得更久
+        ~PersistentTreap()
+        { release(current_.load()); }
+
+        Snapshot snapshot() const
+        {
+            Epoch::Guard guard;
+            Version* v = current_.load();
+            retain(v);
+            return Snapshot(v);
+        }
+
+        bool contains(const Object& x) const
+        { return snapshot().contains(x); }
+
+        std::size_t size() const
+        { return snapshot().size(); }
+
+        bool empty() const
+        { return snapshot().empty(); }
+
+        bool insert(const Object& x)
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            Version* v = current_.load();
+            TreeNode* root = insertProcess(v->root_, x, random_.nextInt());
+            if(root == nullptr)
+                return false;
+            publish(new Version(root, v->size_ + 1));
+            return true;
+        }
+
+        bool remove(const Object& x)
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            Version* v = current_.load();
+            bool found;
+            TreeNode* root = removeProcess(v->root_, x, found);
+            if(!found)
+                return false;
+            publish(new Version(root, v->size_ - 1));
+            return true;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            publish(new Version(nullptr, 0));
+        }
+
+        // 写者每替换一定数量的版本会自动回收一次，写完一批之后也可以调用
+        void reclaim()
+        { Epoch::collect(); }
+    };
+
+    template <typename Object>
+    const std::size_t PersistentTreap<Object>::RETIRED_LIMIT;
+}
+
+#endif //PERSISTENT_TREAP_HPP
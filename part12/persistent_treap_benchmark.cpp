@@ -0,0 +1,200 @@
+// 读多写少时集合的读扩展性
+// 一个写者不停地删除并重新插入随机关键字，R个读者随机查找，固定时间后统计吞吐量:
+//   locked Treap       Treap加一把互斥锁，读写都加锁
+//   snapshot per op    PersistentTreap，每次查找取一次快照
+//   snapshot per batch PersistentTreap，每取一次快照查找BATCH次
+// 读者数取1, 2, 4, ... max_readers，写者每次更新之后休息write_pause微秒
+//
+// 用法: persistent_treap_benchmark [n] [max_readers] [ms_per_run] [write_pause_us] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "treap.hpp"
+#include "persistent_treap.hpp"
+#include "../lib/uniform_random.h"
+
+const int BATCH = 64;
+
+class LockedTreap
+{
+public:
+    bool contains(int x)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return treap_.contains(x);
+    }
+
+    void insert(int x)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        treap_.insert(x);
+    }
+
+    void remove(int x)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        treap_.remove(x);
+    }
+
+    // 每次查找都要加锁，批量查找与单个相同
+    template <typename Iterator>
+    uint64_t containsBatch(Iterator first, Iterator last)
+    {
+        uint64_t found = 0;
+        for(; first != last; ++first)
+            found += contains(*first);
+        return found;
+    }
+
+private:
+    std::mutex mutex_;
+    DS::Treap<int> treap_;
+};
+
+class SnapshotPerOp
+{
+public:
+    bool contains(int x)
+    { return treap_.contains(x); }
+
+    void insert(int x)
+    { treap_.insert(x); }
+
+    void remove(int x)
+    { treap_.remove(x); }
+
+    template <typename Iterator>
+    uint64_t containsBatch(Iterator first, Iterator last)
+    {
+        uint64_t found = 0;
+        for(; first != last; ++first)
+            found += treap_.contains(*first);
+        return found;
+    }
+
+protected:
+    DS::PersistentTreap<int> treap_;
+};
+
+class SnapshotPerBatch : public SnapshotPerOp
+{
+public:
+    template <typename Iterator>
+    uint64_t containsBatch(Iterator first, Iterator last)
+    {
+        DS::PersistentTreap<int>::Snapshot snap = treap_.snapshot();
+        uint64_t found = 0;
+        for(; first != last; ++first)
+            found += snap.contains(*first);
+        return found;
+    }
+};
+
+struct Result
+{
+    double lookups_per_sec;
+    double updates_per_sec;
+};
+
+template <typename Set>
+Result run(const std::vector<int>& keys, int n_readers, int ms, int write_pause_us, int seed)
+{
+    Set set;
+    for(int x : keys)
+        set.insert(x);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> hits{0}; // 防止查找被优化掉
+    uint64_t updates = 0;
+    std::vector<std::thread> readers;
+    for(int r = 0; r < n_readers; ++r)
+    {
+        readers.emplace_back([&, r]() {
+            DS::UniformRandom random(seed + r + 1);
+            std::vector<int> queries(BATCH);
+            uint64_t count = 0;
+            uint64_t found = 0;
+            while(!stop.load(std::memory_order_relaxed))
+            {
+                for(int& q : queries)
+                    q = keys[random.nextInt(0, static_cast<int>(keys.size()) - 1)];
+                found += set.containsBatch(queries.begin(), queries.end());
+                count += BATCH;
+            }
+            lookups += count;
+            hits += found;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::milliseconds(ms);
+    DS::UniformRandom random(seed);
+    while(std::chrono::steady_clock::now() < end)
+    {
+        int x = keys[random.nextInt(0, static_cast<int>(keys.size()) - 1)];
+        set.remove(x);
+        set.insert(x);
+        updates += 2;
+        if(write_pause_us > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(write_pause_us));
+    }
+    stop = true;
+    for(auto& reader : readers)
+        reader.join();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return Result{lookups / sec, updates / sec};
+}
+
+template <typename Set>
+void bench(const std::string& name, const std::vector<int>& keys, int max_readers, int ms,
+           int write_pause_us, int seed)
+{
+    std::cout << "  " << std::left << std::setw(20) << name << std::right;
+    for(int n_readers = 1; n_readers <= max_readers; n_readers *= 2)
+    {
+        Result r = run<Set>(keys, n_readers, ms, write_pause_us, seed);
+        std::cout << std::setw(9) << std::fixed << std::setprecision(2) << r.lookups_per_sec / 1e6
+                  << "/" << std::left << std::setw(7) << std::setprecision(0) << r.updates_per_sec / 1e3
+                  << std::right;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 100000;
+    int max_readers = argc > 2 ? atoi(argv[2]) : 8;
+    int ms = argc > 3 ? atoi(argv[3]) : 500;
+    int write_pause_us = argc > 4 ? atoi(argv[4]) : 100;
+    int seed = argc > 5 ? atoi(argv[5]) : 1;
+    if(n < 1 || max_readers < 1 || ms < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [n >= 1] [max_readers >= 1] [ms_per_run >= 1] "
+                  << "[write_pause_us] [seed]" << std::endl;
+        return 1;
+    }
+
+    DS::UniformRandom random(seed);
+    std::vector<int> keys(n);
+    for(auto& x : keys)
+        x = random.nextInt(0, 0x3fffffff);
+
+    std::cout << n << " keys, 1 writer (pause " << write_pause_us << " us), " << ms << " ms per run" << std::endl;
+    std::cout << "  M lookups/s / K updates/s, readers:";
+    for(int n_readers = 1; n_readers <= max_readers; n_readers *= 2)
+        std::cout << " " << n_readers;
+    std::cout << std::endl;
+    bench<LockedTreap>("locked Treap", keys, max_readers, ms, write_pause_us, seed);
+    bench<SnapshotPerOp>("snapshot per op", keys, max_readers, ms, write_pause_us, seed);
+    bench<SnapshotPerBatch>("snapshot per batch", keys, max_readers, ms, write_pause_us, seed);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "persistent_treap.hpp"
+
+using namespace std;
+using DS::PersistentTreap;
+
+// 记录存活的对象数，检查被替换的版本确实释放了
+struct Counted
+{
+    static atomic<int> live;
+    int value;
+
+    Counted(int v)
+    : value{v}
+    { ++live; }
+
+    Counted(const Counted& rhs)
+    : value{rhs.value}
+    { ++live; }
+
+    ~Counted()
+    { --live; }
+
+    bool operator<(const Counted& rhs) const
+    { return value < rhs.value; }
+};
+
+atomic<int> Counted::live{0};
+
+// Test program
+int main()
+{
+    PersistentTreap<int> t;
+    int NUMS = 20000;
+    const int GAP = 37;
+    int i;
+
+    cout << "Checking... (no more output means success)" << endl;
+
+    for (i = GAP; i != 0; i = (i + GAP) % NUMS)
+        t.insert(i);
+    PersistentTreap<int>::Snapshot all = t.snapshot();
+    for (i = 1; i < NUMS; i += 2)
+        t.remove(i);
+
+    PersistentTreap<int>::Snapshot s = t.snapshot();
+    if (NUMS < 40)
+        s.print();
+    if (s.findMin() != 2 || s.findMax() != NUMS - 2 || s.size() != static_cast<size_t>(NUMS / 2 - 1))
+        cout << "FindMin or FindMax error!" << endl;
+
+    for (i = 2; i < NUMS; i += 2)
+        if (!t.contains(i))
+            cout << "Find error1!" << endl;
+
+    for (i = 1; i < NUMS; i += 2)
+    {
+        if (t.contains(i))
+            cout << "Find error2!" << endl;
+    }
+
+    // 旧的快照不受之后更新的影响
+    for (i = 1; i < NUMS; ++i)
+        if (!all.contains(i))
+            cout << "Snapshot error!" << endl;
+    if (all.size() != static_cast<size_t>(NUMS - 1) || t.insert(2) || !t.insert(1) || t.remove(3))
+        cout << "Snapshot error!" << endl;
+    int expect = 2;
+    s.forEach([&](int x) {
+        if (x != expect)
+            cout << "ForEach error!" << endl;
+        expect += 2;
+    });
+    t.clear();
+    if (!t.empty() || s.empty() || !s.contains(NUMS - 2))
+        cout << "Clear error!" << endl;
+
+    // 一个写者与多个读者: 写者按顺序插入i并删除i - WINDOW
+    // 每个版本都是一段连续的整数，读者看到的最大值不会变小
+    const int N_READERS = 4;
+    const int WINDOW = 500;
+    atomic<bool> done{false};
+    vector<thread> readers;
+    for (int r = 0; r < N_READERS; ++r)
+    {
+        readers.emplace_back([&]() {
+            int last_max = 0;
+            while (!done.load())
+            {
+                PersistentTreap<int>::Snapshot snap = t.snapshot();
+                if (snap.empty())
+                    continue;
+                int next = snap.findMin();
+                snap.forEach([&](int x) {
+                    if (x != next)
+                        cout << "Concurrent snapshot error!" << endl;
+                    ++next;
+                });
+                if (next - snap.findMin() != static_cast<int>(snap.size()) || snap.findMax() < last_max)
+                    cout << "Concurrent snapshot error!" << endl;
+                last_max = snap.findMax();
+            }
+        });
+    }
+    for (i = 1; i <= 5000; ++i)
+    {
+        t.insert(i);
+        if (i > WINDOW)
+            t.remove(i - WINDOW);
+    }
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+    t.reclaim();
+
+    // 读者一直在取快照时，旧版本也会陆续释放，存活的节点数有上界
+    // (每次更新复制约log n个节点，全部留下会有几十万个)
+    {
+        PersistentTreap<Counted> c;
+        atomic<bool> stop{false};
+        vector<thread> busy;
+        for (int r = 0; r < 2; ++r)
+            busy.emplace_back([&c, &stop, r]() {
+                while (!stop.load())
+                    c.contains(Counted(r));
+            });
+        int max_live = 0;
+        for (i = 0; i < 40000; ++i)
+        {
+            if (!c.insert(Counted(i % 64)))
+                c.remove(Counted(i % 64));
+            max_live = max(max_live, Counted::live.load());
+        }
+        stop = true;
+        for (auto& reader : busy)
+            reader.join();
+        if (max_live > 20000)
+            cout << "Reclaim error: " << max_live << " live nodes!" << endl;
+    }
+
+    cout << "Test finished" << endl;
+    return 0;
+}
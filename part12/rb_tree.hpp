@@ -2,6 +2,9 @@
 #define RB_TREE_HPP
 
 #include <iostream>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
 #include "../lib/dsexceptions.h"
 
 // Red-black tree class
@@ -9,24 +12,67 @@
 // CONSTRUCTION: with negative infinity object also
 //               used to signal failed finds
 //
+// RedBlackTree<Object>        有序集合
+// RedBlackMap<Key, Value>     有序映射，元素为 std::pair<const Key, Value>，按first排序
+//
 // ******************PUBLIC OPERATIONS*********************
-// void insert( x )       --> Insert x
-// void remove( x )       --> Remove x (unimplemented)
+// bool insert( x )       --> Insert x, return false if x is present
+// void remove( x )       --> Remove x
 // bool contains( x )     --> Return true if x is present
 // Comparable findMin( )  --> Return smallest item
 // Comparable findMax( )  --> Return largest item
 // bool empty( )        --> Return true if empty; else false
 // void clear( )      --> Remove all items
 // void print( )      --> Print tree in sorted order
+// begin( ) / end( )      --> Bidirectional iterators in sorted order
+// find( x )              --> Iterator to x, or end( )
+// lowerBound( x )        --> Iterator to the first item >= x
+// upperBound( x )        --> Iterator to the first item > x
+// equalRange( x )        --> pair( lowerBound( x ), upperBound( x ) )
+// forEachInRange( lo, hi, fn ) --> Call fn(item) for every lo <= item <= hi
+// ******************ORDER STATISTIC***********************
+// RedBlackTree<Object, KeyOf, true> 在节点中维护子树大小，支持以下O(log n)操作
+// size_t size( )         --> Return the number of items
+// size_t rank( x )       --> Return the number of items < x
+// Object select( k )     --> Return the k-th smallest item, k from 0
+// size_t countInRange( lo, hi ) --> Return the number of items in [lo, hi]
 // ******************ERRORS********************************
 // Throws UnderflowException as warranted
+// Throws ArrayIndexOutOfBoundsException if select( k ) with k >= size( )
+//
+// 迭代器沿parent_指针移动，++/--摊还O(1)
+// 查找类的操作都以关键字为参数，映射的关键字为pair的first
+// 集合的iterator就是const_iterator；映射的iterator可以修改值(second)，关键字是const的
+// remove只使指向被删除元素的迭代器失效
 
 namespace DS
 {
+    // 集合的关键字就是元素本身
     template <typename Object>
+    struct RBIdentity
+    {
+        typedef Object type;
+
+        const Object& operator()(const Object& x) const
+        { return x; }
+    };
+
+    // 映射的关键字为pair的first
+    template <typename Key, typename Value>
+    struct RBPairKey
+    {
+        typedef Key type;
+
+        const Key& operator()(const std::pair<const Key, Value>& x) const
+        { return x.first; }
+    };
+
+    template <typename Object, typename KeyOf = RBIdentity<Object>, bool ORDER_STATISTIC = false>
     class RedBlackTree
     {
     private:
+        typedef typename KeyOf::type Key;
+
         enum Color {RED, BLACK};
 
         class TreeNode
@@ -37,19 +83,51 @@ namespace DS
             TreeNode* right_;
             TreeNode* parent_;
             Color color_;
+            int size_; // 子树的节点数，只在ORDER_STATISTIC时维护
 
             explicit TreeNode(const Object& e = Object{}, Color c = BLACK,
                     TreeNode* lt = nullptr, TreeNode* rt = nullptr, TreeNode* p = nullptr)
-            : element_{e}, left_{lt}, right_{rt}, parent_{p}, color_{c}
+            : element_{e}, left_{lt}, right_{rt}, parent_{p}, color_{c}, size_{1}
             {}
 
             explicit TreeNode(Object&& e, Color c = BLACK,
                     TreeNode* lt = nullptr, TreeNode* rt = nullptr, TreeNode* p = nullptr)
-            : element_{std::move(e)}, left_{lt}, right_{rt}, parent_{p}, color_{c}
+            : element_{std::move(e)}, left_{lt}, right_{rt}, parent_{p}, color_{c}, size_{1}
             {}
         };
 
         TreeNode* root_;
+        KeyOf key_of_;
+
+        const Key& key(const TreeNode* node) const
+        { return key_of_(node->element_); }
+
+        static int size(const TreeNode* node)
+        { return nullptr == node ? 0 : node->size_; }
+
+        // 从node到根的每个节点子树大小加delta
+        static void addSizeToRoot(TreeNode* node, int delta)
+        {
+            for(; node; node = node->parent_)
+                node->size_ += delta;
+        }
+
+        // 小于x (inclusive为true时不大于x) 的元素个数
+        std::size_t countLess(const Key& x, bool inclusive) const
+        {
+            std::size_t count = 0;
+            TreeNode* node = root_;
+            while(node)
+            {
+                if(key(node) < x || (inclusive && !(x < key(node))))
+                {
+                    count += size(node->left_) + 1;
+                    node = node->right_;
+                } else
+                    node = node->left_;
+            }
+            return count;
+        }
 
         void clone(TreeNode*& node, TreeNode* node_parent, TreeNode* new_node)
         {
@@ -58,6 +136,7 @@ namespace DS
             else
             {
                 node = new TreeNode(new_node->element_, new_node->color_, nullptr, nullptr, node_parent);
+                node->size_ = new_node->size_;
                 clone(node->left_, node, new_node->left_);
                 clone(node->right_, node, new_node->right_);
             }
@@ -83,22 +162,103 @@ namespace DS
             print(node->right_);
         }
 
-        void insert(const Object& x, TreeNode*& current, TreeNode* parent)
+        static TreeNode* minNode(TreeNode* node)
         {
-            if(nullptr == current)
+            while(node->left_)
+                node = node->left_;
+            return node;
+        }
+
+        static TreeNode* maxNode(TreeNode* node)
+        {
+            while(node->right_)
+                node = node->right_;
+            return node;
+        }
+
+        // 中序后继: 右子树的最小节点，或者第一个从左边到达的祖先
+        static TreeNode* successor(TreeNode* node)
+        {
+            if(node->right_)
+                return minNode(node->right_);
+            TreeNode* parent = node->parent_;
+            while(parent && node == parent->right_)
             {
-                current = new TreeNode(x, RED, nullptr, nullptr, parent);
-                if(parent->color_ == RED)
-                    insertFixUp(current);
-            } else if(current->element_ == x)
+                node = parent;
+                parent = parent->parent_;
+            }
+            return parent;
+        }
+
+        static TreeNode* predecessor(TreeNode* node)
+        {
+            if(node->left_)
+                return maxNode(node->left_);
+            TreeNode* parent = node->parent_;
+            while(parent && node == parent->left_)
             {
-                return;
-            } else if(x < current->element_)
+                node = parent;
+                parent = parent->parent_;
+            }
+            return parent;
+        }
+
+        TreeNode* findNode(const Key& x) const
+        {
+            TreeNode* ptr = root_;
+            while(ptr)
+            {
+                if(x < key(ptr))
+                    ptr = ptr->left_;
+                else if(key(ptr) < x)
+                    ptr = ptr->right_;
+                else
+                    return ptr;
+            }
+            return nullptr;
+        }
+
+        // 第一个关键字 >= x (STRICT为false) 或 > x (STRICT为true) 的节点
+        template <bool STRICT>
+        TreeNode* boundNode(const Key& x) const
+        {
+            TreeNode* ptr = root_;
+            TreeNode* result = nullptr;
+            while(ptr)
+            {
+                if(STRICT ? x < key(ptr) : !(key(ptr) < x))
+                {
+                    result = ptr;
+                    ptr = ptr->left_;
+                } else
+                    ptr = ptr->right_;
+            }
+            return result;
+        }
+
+        template <typename X>
+        bool insertProcess(X&& x)
+        {
+            TreeNode* parent = nullptr;
+            TreeNode** link = &root_;
+            const Key& k = key_of_(x);
+            while(*link)
             {
-                insert(x, current->left_, current);
-            } else {
-                insert(x, current->right_, current);
+                parent = *link;
+                if(k < key(parent))
+                    link = &parent->left_;
+                else if(key(parent) < k)
+                    link = &parent->right_;
+                else
+                    return false; // 重复元素
             }
+            TreeNode* current = new TreeNode(std::forward<X>(x), RED, nullptr, nullptr, parent);
+            *link = current;
+            // 先更新路径上的子树大小，修复过程中的旋转依赖儿子的大小
+            if(ORDER_STATISTIC)
+                addSizeToRoot(parent, 1);
+            insertFixUp(current);
+            return true;
         }
 
         void insertFixUp(TreeNode*& node)
@@ -175,7 +335,7 @@ namespace DS
             root_->color_ = BLACK;
         }
 
-        TreeNode* rotateWithLeftChild(TreeNode*& k2)
+        void rotateWithLeftChild(TreeNode*& k2)
         {
             TreeNode* k1 = k2->left_;
             k2->left_ = k1->right_;
@@ -192,9 +352,16 @@ namespace DS
 
             k1->right_ = k2;
             k2->parent_ = k1;
+
+            // k1取代k2成为子树的根，子树大小不变
+            if(ORDER_STATISTIC)
+            {
+                k1->size_ = k2->size_;
+                k2->size_ = size(k2->left_) + size(k2->right_) + 1;
+            }
         }
 
-        TreeNode* rotateWithRightChild(TreeNode*& k1)
+        void rotateWithRightChild(TreeNode*& k1)
         {
             TreeNode* k2 = k1->right_;
             k1->right_ = k2->left_;
@@ -211,55 +378,92 @@ namespace DS
 
             k2->left_ = k1;
             k1->parent_ = k2;
+
+            if(ORDER_STATISTIC)
+            {
+                k2->size_ = k1->size_;
+                k1->size_ = size(k1->left_) + size(k1->right_) + 1;
+            }
         }
 
-        void remove(const Object& x, TreeNode*& node)
+        void removeNode(TreeNode* node)
         {
-            if(node == nullptr)
-                return;
-            if(x == node->element_)
-            {
-                TreeNode* remove_node = nullptr;
-                TreeNode* adjust_node = nullptr;
-                if(node->left_ != nullptr && node->right_ != nullptr)
-                {
-                    remove_node = findSuccessor(node);
-                    node->element_ = remove_node->element_;
-                } else {
-                    remove_node = node;
-                }
+            TreeNode* remove_node = nullptr;
+            TreeNode* adjust_node = nullptr;
+            // 有两个儿子时先与后继交换位置，元素不移动(映射的关键字是const的，其他迭代器也不失效)
+            if(node->left_ != nullptr && node->right_ != nullptr)
+                swapWithSuccessor(node);
+            remove_node = node;
+
+            if(remove_node->left_)
+                adjust_node = remove_node->left_;
+            else
+                adjust_node = remove_node->right_;
 
-                if(remove_node->left_)
-                    adjust_node = remove_node->left_;
+            TreeNode* parent = remove_node->parent_;
+            if(adjust_node)
+                adjust_node->parent_ = parent;
+            if(nullptr == parent)
+                root_ = adjust_node;
+            else
+            {
+                if(remove_node == parent->left_)
+                    parent->left_ = adjust_node;
                 else
-                    adjust_node = remove_node->right_;
+                    parent->right_ = adjust_node;
+            }
+            if(ORDER_STATISTIC)
+                addSizeToRoot(parent, -1);
+            // 删除黑色节点后，即使替代节点为空也要修复
+            if(remove_node->color_ == BLACK)
+                removeFixUp(adjust_node, parent);
 
-                if(nullptr == remove_node->parent_)
-                    root_ = adjust_node;
-                else
-                {
-                    if(remove_node == remove_node->parent_->left_)
-                        remove_node->parent_->left_ = adjust_node;
-                    else
-                        remove_node->parent_->right_ = adjust_node;
-                }
-                if(adjust_node)
-                {
-                    adjust_node->parent_ = remove_node->parent_;
-                    if (remove_node->color_ == BLACK)
-                        removeFixUp(adjust_node, adjust_node->parent_);
-                }
+            delete remove_node;
+        }
+
+        // parent中指向old的链接改为指向now，parent为空时now成为根
+        void replaceChild(TreeNode* parent, TreeNode* old, TreeNode* now)
+        {
+            if(nullptr == parent)
+                root_ = now;
+            else if(parent->left_ == old)
+                parent->left_ = now;
+            else
+                parent->right_ = now;
+        }
 
-                delete remove_node;
-            } else if(x < node->element_)
+        // 交换node与其后继在树中的位置，颜色与子树大小属于位置，也一起交换
+        // 之后node没有左儿子
+        void swapWithSuccessor(TreeNode* node)
+        {
+            TreeNode* next = minNode(node->right_);
+            TreeNode* next_parent = next->parent_;
+            TreeNode* next_right = next->right_;
+
+            replaceChild(node->parent_, node, next);
+            next->parent_ = node->parent_;
+            next->left_ = node->left_;
+            next->left_->parent_ = next;
+            if(next_parent == node) // 后继就是右儿子
+            {
+                next->right_ = node;
+                node->parent_ = next;
+            } else
             {
-                remove(x, node->left_);
-            } else {
-                remove(x, node->right_);
+                next->right_ = node->right_;
+                next->right_->parent_ = next;
+                next_parent->left_ = node;
+                node->parent_ = next_parent;
             }
+            node->left_ = nullptr;
+            node->right_ = next_right;
+            if(next_right)
+                next_right->parent_ = node;
+            std::swap(node->color_, next->color_);
+            std::swap(node->size_, next->size_);
         }
 
-        void removeFixUp(TreeNode*& current, TreeNode*& parent)
+        void removeFixUp(TreeNode* current, TreeNode* parent)
         {
             // 空节点也算作黑色节点
             while((current == nullptr || current->color_ == BLACK) && current != root_)
@@ -346,6 +550,113 @@ namespace DS
                 current->color_ = BLACK;
         }
     public:
+        // 双向迭代器，end()为空节点，--end()得到最大元素
+        class const_iterator
+        {
+            friend class RedBlackTree;
+        public:
+            const_iterator()
+            : tree_{nullptr}, current_{nullptr}
+            {}
+
+            const Object& operator*() const
+            { return current_->element_; }
+
+            const Object* operator->() const
+            { return &current_->element_; }
+
+            const_iterator& operator++()
+            {
+                current_ = successor(current_);
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const_iterator old = *this;
+                ++(*this);
+                return old;
+            }
+
+            const_iterator& operator--()
+            {
+                current_ = current_ ? predecessor(current_) : maxNode(tree_->root_);
+                return *this;
+            }
+
+            const_iterator operator--(int)
+            {
+                const_iterator old = *this;
+                --(*this);
+                return old;
+            }
+
+            bool operator==(const const_iterator& rhs) const
+            { return current_ == rhs.current_; }
+
+            bool operator!=(const const_iterator& rhs) const
+            { return current_ != rhs.current_; }
+
+        protected:
+            const RedBlackTree* tree_;
+            TreeNode* current_;
+
+            const_iterator(const RedBlackTree* tree, TreeNode* p)
+            : tree_{tree}, current_{p}
+            {}
+        };
+
+    private:
+        // 映射的迭代器，可以修改元素的second
+        class MapIterator : public const_iterator
+        {
+            friend class RedBlackTree;
+        public:
+            MapIterator() = default;
+
+            Object& operator*() const
+            { return this->current_->element_; }
+
+            Object* operator->() const
+            { return &this->current_->element_; }
+
+            MapIterator& operator++()
+            {
+                const_iterator::operator++();
+                return *this;
+            }
+
+            MapIterator operator++(int)
+            {
+                MapIterator old = *this;
+                ++(*this);
+                return old;
+            }
+
+            MapIterator& operator--()
+            {
+                const_iterator::operator--();
+                return *this;
+            }
+
+            MapIterator operator--(int)
+            {
+                MapIterator old = *this;
+                --(*this);
+                return old;
+            }
+
+        protected:
+            MapIterator(const RedBlackTree* tree, TreeNode* p)
+            : const_iterator{tree, p}
+            {}
+        };
+
+    public:
+        // 集合的元素就是关键字，不能通过迭代器修改
+        typedef typename std::conditional<std::is_same<KeyOf, RBIdentity<Object>>::value,
+                                          const_iterator, MapIterator>::type iterator;
+
         RedBlackTree()
         : root_{nullptr}
         {}
@@ -356,13 +667,13 @@ namespace DS
         {}
 
         RedBlackTree(const RedBlackTree& rhs)
-        : root_{nullptr}
+        : root_{nullptr}, key_of_{rhs.key_of_}
         {
             clone(root_, nullptr, rhs.root_);
         }
 
         RedBlackTree(RedBlackTree&& rhs) noexcept
-        : root_{rhs.root_}
+        : root_{rhs.root_}, key_of_{rhs.key_of_}
         {
             rhs.root_ = nullptr;
         }
@@ -383,6 +694,7 @@ namespace DS
         RedBlackTree& operator=(RedBlackTree&& rhs) noexcept
         {
             std::swap(root_, rhs.root_);
+            std::swap(key_of_, rhs.key_of_);
             return *this;
         }
 
@@ -414,61 +726,126 @@ namespace DS
         {
             if(empty())
                 throw UnderflowException{};
-            TreeNode* ptr = root_;
-            while(ptr->left_)
-                ptr = ptr->left_;
-            return ptr->element_;
+            return minNode(root_)->element_;
         }
 
         const Object& findMax() const
         {
             if(empty())
                 throw UnderflowException{};
-            TreeNode* ptr = root_;
-            while(ptr->right_)
-                ptr = ptr->right_;
-            return ptr->element_;
+            return maxNode(root_)->element_;
         }
 
-        bool contains(const Object& x) const
+        bool contains(const Key& x) const
         {
-            TreeNode* ptr = root_;
-            while(ptr)
-            {
-                if(x < ptr->element_)
-                    ptr = ptr->left_;
-                else if(ptr->element_ < x)
-                    ptr = ptr->right_;
-                else
-                    return true;
-            }
-            return false;
+            return findNode(x) != nullptr;
         }
 
-        void insert(const Object& x)
+        bool insert(const Object& x)
         {
-            if(empty())
+            return insertProcess(x);
+        }
+
+        bool insert(Object&& x)
+        {
+            return insertProcess(std::move(x));
+        }
+
+        void remove(const Key& x)
+        {
+            TreeNode* node = findNode(x);
+            if(node)
+                removeNode(node);
+        }
+
+        iterator begin()
+        { return iterator(this, root_ ? minNode(root_) : nullptr); }
+
+        const_iterator begin() const
+        { return const_iterator(this, root_ ? minNode(root_) : nullptr); }
+
+        iterator end()
+        { return iterator(this, nullptr); }
+
+        const_iterator end() const
+        { return const_iterator(this, nullptr); }
+
+        iterator find(const Key& x)
+        { return iterator(this, findNode(x)); }
+
+        const_iterator find(const Key& x) const
+        { return const_iterator(this, findNode(x)); }
+
+        iterator lowerBound(const Key& x)
+        { return iterator(this, boundNode<false>(x)); }
+
+        const_iterator lowerBound(const Key& x) const
+        { return const_iterator(this, boundNode<false>(x)); }
+
+        iterator upperBound(const Key& x)
+        { return iterator(this, boundNode<true>(x)); }
+
+        const_iterator upperBound(const Key& x) const
+        { return const_iterator(this, boundNode<true>(x)); }
+
+        std::pair<const_iterator, const_iterator> equalRange(const Key& x) const
+        { return std::make_pair(lowerBound(x), upperBound(x)); }
+
+        std::size_t size() const
+        {
+            static_assert(ORDER_STATISTIC, "size() requires RedBlackTree<Object, KeyOf, true>");
+            return size(root_);
+        }
+
+        // 小于x的元素个数，也就是x在升序中的下标
+        std::size_t rank(const Key& x) const
+        {
+            static_assert(ORDER_STATISTIC, "rank() requires RedBlackTree<Object, KeyOf, true>");
+            return countLess(x, false);
+        }
+
+        // 第k小的元素，k从0开始
+        const Object& select(std::size_t k) const
+        {
+            static_assert(ORDER_STATISTIC, "select() requires RedBlackTree<Object, KeyOf, true>");
+            if(k >= size())
+                throw ArrayIndexOutOfBoundsException{};
+            TreeNode* node = root_;
+            while(true)
             {
-                root_ = new TreeNode(x, BLACK, nullptr, nullptr, nullptr);
-                return;
+                std::size_t left = size(node->left_);
+                if(k < left)
+                    node = node->left_;
+                else if(k == left)
+                    return node->element_;
+                else
+                {
+                    k -= left + 1;
+                    node = node->right_;
+                }
             }
-            insert(x, root_, nullptr);
         }
 
-        void remove(const Object& x)
+        // [lo, hi] 中的元素个数
+        std::size_t countInRange(const Key& lo, const Key& hi) const
         {
-            if(empty())
-                return;
-            remove(x, root_);
+            static_assert(ORDER_STATISTIC, "countInRange() requires RedBlackTree<Object, KeyOf, true>");
+            if(hi < lo)
+                return 0;
+            return countLess(hi, true) - countLess(lo, false);
         }
 
-        TreeNode* findSuccessor(TreeNode* node) const
+        // 对 [lo, hi] 中的每个元素调用 fn(item)
+        // 定位lo需要O(log n)，之后沿后继前进，k个元素共O(k)
+        template <typename Function>
+        void forEachInRange(const Key& lo, const Key& hi, Function fn) const
         {
-            TreeNode* ptr = node->right_;
-            while(ptr->left_)
-                ptr = ptr->left_;
-            return ptr;
+            for(TreeNode* node = boundNode<false>(lo); node && !(hi < key(node)); node = successor(node))
+                fn(node->element_);
         }
     };
+
+    template <typename Key, typename Value>
+    using RedBlackMap = RedBlackTree<std::pair<const Key, Value>, RBPairKey<Key, Value>>;
 }
 #endif //RB_TREE_HPP
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include "rb_tree.hpp"
 using namespace std;
 using DS::RedBlackTree;
@@ -56,6 +59,74 @@ int main()
     if (NUMS < 1000)
         t.print();
 
+    cout << "============" << endl;
+    cout << "Iterator check" << endl;
+    int expect = 2;
+    for(auto it = t.begin(); it != t.end(); ++it, expect += 2)
+        if(*it != expect)
+            cout << "Iterator error: " << *it << endl;
+    if(expect != NUMS)
+        cout << "Iterator count error!" << endl;
+    expect = NUMS - 2;
+    for(auto it = t.end(); it != t.begin(); expect -= 2)
+        if(*--it != expect)
+            cout << "Reverse iterator error: " << *it << endl;
+
+    if(*t.lowerBound(101) != 102 || *t.lowerBound(102) != 102 || *t.upperBound(102) != 104)
+        cout << "Bound error!" << endl;
+    if(t.lowerBound(NUMS) != t.end() || t.find(101) != t.end() || *t.find(100) != 100)
+        cout << "Find error4!" << endl;
+    auto range = t.equalRange(100);
+    if(*range.first != 100 || *range.second != 102)
+        cout << "EqualRange error!" << endl;
+    int count = 0, sum = 0;
+    t.forEachInRange(99, 120, [&](int x) { ++count; sum += x; });
+    if(count != 11 || sum != (100 + 120) * 11 / 2)
+        cout << "Range error: " << count << " " << sum << endl;
+
+    cout << "============" << endl;
+    cout << "Map check" << endl;
+    DS::RedBlackMap<int, string> m;
+    for(i = 0; i < 1000; ++i)
+        m.insert(make_pair(i, to_string(i)));
+    if(m.insert(make_pair(5, string("five"))) || m.find(5)->second != "5")
+        cout << "Map insert error!" << endl;
+    m.find(5)->second = "five";
+    m.remove(6);
+    if(m.find(5)->second != "five" || m.contains(6) || m.lowerBound(6)->second != "7")
+        cout << "Map find error!" << endl;
+    if((--m.end())->first != 999 || m.findMin().first != 0)
+        cout << "Map min/max error!" << endl;
+
+    // 集合的元素与映射的关键字不能通过迭代器修改
+    static_assert(is_const<remove_reference<decltype(*t.begin())>::type>::value, "set iterator must be const");
+    static_assert(is_const<decltype(m.begin()->first)>::value, "map key must be const");
+    // 删除有两个儿子的节点后，指向其他元素的迭代器仍然有效
+    auto kept = m.find(502);
+    for(i = 0; i < 1000; i += 3)
+        m.remove(i);
+    if(kept->first != 502 || kept->second != "502" || (++kept)->first != 503 || (++kept)->first != 505)
+        cout << "Map iterator error!" << endl;
+
+    cout << "============" << endl;
+    cout << "Order statistic check" << endl;
+    RedBlackTree<int, DS::RBIdentity<int>, true> r;
+    for(i = GAP; i != 0; i = (i + GAP) % NUMS)
+        r.insert(i);
+    for(i = 1; i < NUMS; i += 2)
+        r.remove(i);
+    if(r.size() != static_cast<size_t>(NUMS / 2 - 1))
+        cout << "Size error!" << endl;
+    for(i = 2; i < NUMS; i += 2)
+    {
+        if(r.rank(i) != static_cast<size_t>(i / 2 - 1) || r.rank(i + 1) != static_cast<size_t>(i / 2))
+            cout << "Rank error: " << i << endl;
+        if(r.select(i / 2 - 1) != i)
+            cout << "Select error: " << i << endl;
+    }
+    if(r.countInRange(99, 200) != 51 || r.countInRange(200, 99) != 0 || r.countInRange(-5, NUMS) != r.size())
+        cout << "CountInRange error!" << endl;
+
     cout << "Test complete..." << endl;
     return 0;
 }
\ No newline at end of file
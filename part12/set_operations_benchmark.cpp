@@ -0,0 +1,174 @@
+// 平衡树的批量建树与集合运算
+// Treap与AVLTree:
+//   build    由有序序列buildFromSorted，与逐个插入比较
+//   union / intersection / difference   基于split/join的集合运算，n_threads取1, 2, 4...
+// 对照: 有序数组上的std::set_union / set_intersection / set_difference
+// 结果用元素个数和校验和比较
+//
+// 用法: set_operations_benchmark [n] [max_threads] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstdlib>
+#include "treap.hpp"
+#include "../part4/avl_tree.hpp"
+#include "../lib/uniform_random.h"
+
+typedef DS::AVLTree<int, true> RankAVL;
+
+struct Workload
+{
+    std::vector<int> a; // 有序，无重复
+    std::vector<int> b;
+};
+
+// 两个集合各n个元素，大约一半重叠
+std::vector<int> randomSorted(std::size_t n, DS::UniformRandom& r)
+{
+    std::vector<int> v(n);
+    for(auto& x : v)
+        x = r.nextInt(0, static_cast<int>(n) * 4);
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+uint64_t checksum(const std::vector<int>& v)
+{
+    uint64_t sum = v.size();
+    for(int x : v)
+        sum = sum * 31 + static_cast<uint32_t>(x);
+    return sum;
+}
+
+// 按从小到大的顺序求校验和: AVLTree用select，Treap没有遍历接口，逐个取出最小元素
+uint64_t checksum(RankAVL& t)
+{
+    std::vector<int> v;
+    for(std::size_t k = 0; k < t.size(); ++k)
+        v.push_back(t.select(k));
+    return checksum(v);
+}
+
+uint64_t checksum(DS::Treap<int>& t)
+{
+    std::vector<int> v;
+    while(!t.empty())
+    {
+        v.push_back(t.findMin());
+        t.remove(t.findMin());
+    }
+    return checksum(v);
+}
+
+enum Operation { UNION, INTERSECTION, DIFFERENCE };
+
+const char* OP_NAMES[] = {"union", "intersection", "difference"};
+
+std::vector<int> expected(const Workload& w, Operation op)
+{
+    std::vector<int> out;
+    if(op == UNION)
+        std::set_union(w.a.begin(), w.a.end(), w.b.begin(), w.b.end(), std::back_inserter(out));
+    else if(op == INTERSECTION)
+        std::set_intersection(w.a.begin(), w.a.end(), w.b.begin(), w.b.end(), std::back_inserter(out));
+    else
+        std::set_difference(w.a.begin(), w.a.end(), w.b.begin(), w.b.end(), std::back_inserter(out));
+    return out;
+}
+
+template <typename Tree>
+double setOperation(const Workload& w, Operation op, unsigned n_threads, uint64_t& sum)
+{
+    Tree a, b;
+    a.buildFromSorted(w.a.begin(), w.a.end());
+    b.buildFromSorted(w.b.begin(), w.b.end());
+    double t = seconds([&]() {
+        if(op == UNION)
+            a.unionWith(b, n_threads);
+        else if(op == INTERSECTION)
+            a.intersectWith(b, n_threads);
+        else
+            a.differenceWith(b, n_threads);
+    });
+    sum = checksum(a);
+    return t;
+}
+
+template <typename Tree>
+void bench(const std::string& name, const Workload& w, unsigned max_threads)
+{
+    double t_build = seconds([&]() {
+        Tree t;
+        t.buildFromSorted(w.a.begin(), w.a.end());
+    });
+    double t_insert = seconds([&]() {
+        Tree t;
+        for(int x : w.a)
+            t.insert(x);
+    });
+    std::cout << name << ": buildFromSorted " << std::fixed << std::setprecision(1) << t_build * 1000
+              << " ms, insert one by one " << t_insert * 1000 << " ms" << std::endl;
+
+    for(int op = UNION; op <= DIFFERENCE; ++op)
+    {
+        uint64_t expect = checksum(expected(w, static_cast<Operation>(op)));
+        std::cout << "  " << std::left << std::setw(14) << OP_NAMES[op] << std::right;
+        bool ok = true;
+        for(unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        {
+            uint64_t sum;
+            double t = setOperation<Tree>(w, static_cast<Operation>(op), n_threads, sum);
+            ok = ok && sum == expect;
+            std::cout << std::setw(10) << std::fixed << std::setprecision(1) << t * 1000;
+        }
+        std::cout << (ok ? "" : "  MISMATCH!") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000000;
+    unsigned max_threads = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : 4;
+    int seed = argc > 3 ? atoi(argv[3]) : 1;
+    if(n < 1 || max_threads < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [n >= 1] [max_threads >= 1] [seed]" << std::endl;
+        return 1;
+    }
+
+    DS::UniformRandom r(seed);
+    Workload w;
+    w.a = randomSorted(n, r);
+    w.b = randomSorted(n, r);
+    std::cout << w.a.size() << " + " << w.b.size() << " keys (ms), threads:";
+    for(unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        std::cout << " " << n_threads;
+    std::cout << std::endl;
+
+    for(int op = UNION; op <= DIFFERENCE; ++op)
+    {
+        std::vector<int> out;
+        double t = seconds([&]() { out = expected(w, static_cast<Operation>(op)); });
+        std::cout << "sorted vector " << OP_NAMES[op] << ": " << std::fixed << std::setprecision(1)
+                  << t * 1000 << " ms, " << out.size() << " keys" << std::endl;
+    }
+    bench<DS::Treap<int>>("Treap", w, max_threads);
+    bench<RankAVL>("AVLTree", w, max_threads);
+    return 0;
+}
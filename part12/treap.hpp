@@ -7,8 +7,10 @@
 
 #include <iostream>
 #include <climits>
+#include <vector>
 #include "../lib/uniform_random.h"
 #include "../lib/dsexceptions.h"
+#include "../lib/fork_join.h"
 
 // Treap class
 // 树堆
@@ -21,8 +23,19 @@
 // bool empty( )        --> Return true if empty; else false
 // void clear( )      --> Remove all items
 // void print( )      --> Print tree in sorted order
+// buildFromSorted( first, last ) --> Build from strictly increasing input, O(n)
+// void split( x, greater )       --> Move items >= x into greater
+// void join( rhs )               --> Append rhs, all items of rhs > items of this
+// void unionWith( rhs, n_threads )        --> this = this | rhs
+// void intersectWith( rhs, n_threads )    --> this = this & rhs
+// void differenceWith( rhs, n_threads )   --> this = this - rhs
 // ******************ERRORS********************************
 // Throws UnderflowException as warranted
+// Throws IllegalArgumentException if buildFromSorted/join input is out of order
+//
+// split/join/集合运算都会取走rhs(或greater原有)的节点，之后rhs为空
+// 集合运算以优先级较高的根为轴分割另一棵树，左右两边递归，期望O(m log(n/m + 1))
+// 左右两边互不相关，前log2(n_threads)层递归用fork-join并行
 
 namespace DS
 {
@@ -31,32 +44,26 @@ namespace DS
     {
     public:
         Treap()
+        : null_node_{nullNode()}
         {
-            null_node_ = new TreeNode{};
-            null_node_->left_ = null_node_->right_ = null_node_;
-            null_node_->priority_ = INT32_MAX;
             root_ = null_node_;
         }
 
         Treap(const Treap& rhs)
+        : null_node_{nullNode()}
         {
-            null_node_ = new TreeNode{};
-            null_node_->left_ = null_node_->right_ = null_node_;
-            null_node_->priority_ = INT32_MAX;
             clone(root_, rhs.root_);
         }
 
         Treap(Treap&& rhs) noexcept
         : root_{rhs.root_}, null_node_{rhs.null_node_}
         {
-            rhs.root_ = nullptr;
-            rhs.null_node_ = nullptr;
+            rhs.root_ = rhs.null_node_;
         }
 
         ~Treap()
         {
             clear();
-            delete null_node_;
         }
 
         Treap& operator=(const Treap& rhs)
@@ -69,7 +76,6 @@ namespace DS
         Treap& operator=(Treap&& rhs) noexcept
         {
             std::swap(root_, rhs.root_);
-            std::swap(null_node_, rhs.null_node_);
             return *this;
         }
 
@@ -98,19 +104,20 @@ namespace DS
             return ptr->element_;
         }
 
+        // 空节点被所有树共享，这里不能把x写入空节点当作哨兵
         bool contains(const Object& x) const
         {
             TreeNode* current = root_;
-            null_node_->element_ = x;
-            while(true)
+            while(current != null_node_)
             {
                 if(x < current->element_)
                     current = current->left_;
-                else if(x > current->element_)
+                else if(current->element_ < x)
                     current = current->right_;
                 else
-                    return current != null_node_;
+                    return true;
             }
+            return false;
         }
 
         void clear()
@@ -141,6 +148,82 @@ namespace DS
             remove(x, root_);
         }
 
+        // 由严格递增的序列建树，O(n)
+        // 按顺序加入节点，用栈维护最右链(笛卡尔树的构造)，每个节点最多进出栈一次
+        template <typename Iterator>
+        void buildFromSorted(Iterator first, Iterator last)
+        {
+            clear();
+            std::vector<TreeNode*> right_spine;
+            TreeNode* prev = nullptr;
+            for(; first != last; ++first)
+            {
+                if(prev && !(prev->element_ < *first))
+                {
+                    // 输入无序，先把已经建好的部分挂到根上再清除
+                    if(!right_spine.empty())
+                        root_ = right_spine.front();
+                    clear();
+                    throw IllegalArgumentException{};
+                }
+                TreeNode* node = new TreeNode(*first, random_.nextInt(), null_node_, null_node_);
+                TreeNode* last_popped = null_node_;
+                while(!right_spine.empty() && node->priority_ < right_spine.back()->priority_)
+                {
+                    last_popped = right_spine.back();
+                    right_spine.pop_back();
+                }
+                node->left_ = last_popped;
+                if(!right_spine.empty())
+                    right_spine.back()->right_ = node;
+                right_spine.push_back(node);
+                prev = node;
+            }
+            if(!right_spine.empty())
+                root_ = right_spine.front();
+        }
+
+        // 把 >= x 的元素移到greater中(greater原有的元素被清除)
+        void split(const Object& x, Treap& greater)
+        {
+            greater.clear();
+            TreeNode* mid = nullptr;
+            split(root_, x, root_, greater.root_, mid);
+            if(mid != nullptr)
+            {
+                mid->left_ = null_node_;
+                mid->right_ = null_node_;
+                greater.root_ = join(mid, greater.root_);
+            }
+        }
+
+        // 把rhs接在后面，要求rhs的元素都大于本树的元素
+        void join(Treap& rhs)
+        {
+            if(!empty() && !rhs.empty() && !(findMax() < rhs.findMin()))
+                throw IllegalArgumentException{};
+            root_ = join(root_, rhs.root_);
+            rhs.root_ = rhs.null_node_;
+        }
+
+        void unionWith(Treap& rhs, unsigned n_threads = 1)
+        {
+            root_ = unionProcess(root_, rhs.root_, forkDepth(n_threads));
+            rhs.root_ = rhs.null_node_;
+        }
+
+        void intersectWith(Treap& rhs, unsigned n_threads = 1)
+        {
+            root_ = intersectProcess(root_, rhs.root_, forkDepth(n_threads));
+            rhs.root_ = rhs.null_node_;
+        }
+
+        void differenceWith(Treap& rhs, unsigned n_threads = 1)
+        {
+            root_ = differenceProcess(root_, rhs.root_, forkDepth(n_threads));
+            rhs.root_ = rhs.null_node_;
+        }
+
 
     private:
         class TreeNode
@@ -165,9 +248,123 @@ namespace DS
         };
 
         TreeNode* root_;
-        TreeNode* null_node_;
+        TreeNode* null_node_; // 所有树共享的空节点，只读
         UniformRandom random_;
 
+        static TreeNode* nullNode()
+        {
+            static TreeNode node(Object(), INT32_MAX, &node, &node);
+            return &node;
+        }
+
+        // 按x把node分成 < x 和 > x 两棵树，等于x的节点放在mid中
+        void split(TreeNode* node, const Object& x, TreeNode*& less, TreeNode*& greater, TreeNode*& mid)
+        {
+            if(node == null_node_)
+            {
+                less = greater = null_node_;
+                mid = nullptr;
+            } else if(node->element_ < x)
+            {
+                split(node->right_, x, node->right_, greater, mid);
+                less = node;
+            } else if(x < node->element_)
+            {
+                split(node->left_, x, less, node->left_, mid);
+                greater = node;
+            } else
+            {
+                less = node->left_;
+                greater = node->right_;
+                mid = node;
+            }
+        }
+
+        // 合并两棵树，less的元素都小于greater，优先级小的作为根
+        TreeNode* join(TreeNode* less, TreeNode* greater)
+        {
+            if(less == null_node_)
+                return greater;
+            if(greater == null_node_)
+                return less;
+            if(less->priority_ < greater->priority_)
+            {
+                less->right_ = join(less->right_, greater);
+                return less;
+            }
+            greater->left_ = join(less, greater->left_);
+            return greater;
+        }
+
+        TreeNode* unionProcess(TreeNode* a, TreeNode* b, int depth)
+        {
+            if(a == null_node_)
+                return b;
+            if(b == null_node_)
+                return a;
+            if(b->priority_ < a->priority_)
+                std::swap(a, b);
+            TreeNode *less, *greater, *mid;
+            split(b, a->element_, less, greater, mid);
+            delete mid; // 重复元素
+            TreeNode* left = a->left_;
+            TreeNode* right = a->right_;
+            forkJoin(depth,
+                     [&]() { left = unionProcess(left, less, depth - 1); },
+                     [&]() { right = unionProcess(right, greater, depth - 1); });
+            a->left_ = left;
+            a->right_ = right;
+            return a;
+        }
+
+        TreeNode* intersectProcess(TreeNode* a, TreeNode* b, int depth)
+        {
+            if(a == null_node_ || b == null_node_)
+            {
+                clear(a);
+                clear(b);
+                return null_node_;
+            }
+            if(b->priority_ < a->priority_)
+                std::swap(a, b);
+            TreeNode *less, *greater, *mid;
+            split(b, a->element_, less, greater, mid);
+            TreeNode* left = a->left_;
+            TreeNode* right = a->right_;
+            forkJoin(depth,
+                     [&]() { left = intersectProcess(left, less, depth - 1); },
+                     [&]() { right = intersectProcess(right, greater, depth - 1); });
+            if(mid != nullptr) // 两边都有，保留a
+            {
+                delete mid;
+                a->left_ = left;
+                a->right_ = right;
+                return a;
+            }
+            delete a;
+            return join(left, right);
+        }
+
+        // a - b，以b的根为轴分割a
+        TreeNode* differenceProcess(TreeNode* a, TreeNode* b, int depth)
+        {
+            if(a == null_node_ || b == null_node_)
+            {
+                clear(b);
+                return a;
+            }
+            TreeNode *less, *greater, *mid;
+            split(a, b->element_, less, greater, mid);
+            delete mid;
+            TreeNode* left = b->left_;
+            TreeNode* right = b->right_;
+            delete b;
+            forkJoin(depth,
+                     [&]() { less = differenceProcess(less, left, depth - 1); },
+                     [&]() { greater = differenceProcess(greater, right, depth - 1); });
+            return join(less, greater);
+        }
+
         void clone(TreeNode*& root, TreeNode* node)
         {
             if(node == node->left_)
@@ -255,16 +452,18 @@ namespace DS
                     remove(x, node->right_);
                 else // match
                 {
-                    if(node->left_->priority_ < node->right_->priority_)
-                        rotateWithLeftChild(node);
-                    else
-                        rotateWithRightChild(node);
-                    if(node != null_node_) // 不是叶子节点
-                        remove(x, node);
-                    else // 是叶子节点
+                    if(node->left_ == null_node_ || node->right_ == null_node_) // 至多一个儿子，直接删除
+                    {
+                        TreeNode* old_node = node;
+                        node = (node->left_ == null_node_) ? node->right_ : node->left_;
+                        delete old_node;
+                    } else // 把优先级小的儿子转上来，x下沉一层
                     {
-                        delete node->left_;
-                        node->left_ = null_node_;
+                        if(node->left_->priority_ < node->right_->priority_)
+                            rotateWithLeftChild(node);
+                        else
+                            rotateWithRightChild(node);
+                        remove(x, node);
                     }
                 }
             }
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <vector>
 #include "treap.hpp"
 
 using namespace std;
@@ -48,6 +49,46 @@ int main()
             cout << "Find error2!" << endl;
     }
 
+    // 批量建树、分割与连接、集合运算
+    NUMS = 20000;
+    vector<int> evens, thirds;
+    for (i = 0; i < NUMS; i += 2)
+        evens.push_back(i);
+    for (i = 0; i < NUMS; i += 3)
+        thirds.push_back(i);
+    Treap<int> a, b, g;
+    a.buildFromSorted(evens.begin(), evens.end());
+    for (i = 0; i < NUMS; ++i)
+        if (a.contains(i) != (i % 2 == 0))
+            cout << "BuildFromSorted error!" << endl;
+    a.split(1001, g);
+    if (a.findMax() != 1000 || g.findMin() != 1002)
+        cout << "Split error!" << endl;
+    a.join(g);
+    if (!g.empty() || a.findMin() != 0 || a.findMax() != NUMS - 2)
+        cout << "Join error!" << endl;
+
+    b.buildFromSorted(thirds.begin(), thirds.end());
+    a.unionWith(b, 4);
+    if (!b.empty())
+        cout << "Union error!" << endl;
+    for (i = 0; i < NUMS; ++i)
+        if (a.contains(i) != (i % 2 == 0 || i % 3 == 0))
+            cout << "Union error!" << endl;
+
+    b.buildFromSorted(thirds.begin(), thirds.end());
+    a.differenceWith(b, 4);
+    for (i = 0; i < NUMS; ++i)
+        if (a.contains(i) != (i % 2 == 0 && i % 3 != 0))
+            cout << "Difference error!" << endl;
+
+    b.buildFromSorted(evens.begin(), evens.end());
+    g.buildFromSorted(thirds.begin(), thirds.end());
+    b.intersectWith(g, 4);
+    for (i = 0; i < NUMS; ++i)
+        if (b.contains(i) != (i % 6 == 0))
+            cout << "Intersection error!" << endl;
+
     cout << "Test finished" << endl;
     return 0;
 }
\ No newline at end of file
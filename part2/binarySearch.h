@@ -7,20 +7,20 @@
 
 #define NOT_FOUND -1
 // return index, if not found, return -1
+// 在左闭右开区间[low, high)中查找，空数组和key小于所有元素时不会下溢
 	template <typename Object>
 int binarySearch(const std::vector<Object>& array, const Object& key)
 {
-	std::size_t low = 0, high = array.size() - 1;
-	std::size_t mid = low + (high - low) / 2;
-	while(low <= high)                      
-	{                                      
-		if(array[mid] > key)                  
-			high = mid - 1;
+	std::size_t low = 0, high = array.size();
+	while(low < high)
+	{
+		std::size_t mid = low + (high - low) / 2;
+		if(array[mid] > key)
+			high = mid;
 		else if(array[mid] < key)
 			low = mid + 1;
 		else
-			return mid;
-		mid = low + (high - low) / 2;
+			return static_cast<int>(mid);
 	}
 	return NOT_FOUND;
 }
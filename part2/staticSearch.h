@@ -0,0 +1,304 @@
+/// @file    staticSearch.h
+/// 静态有序数组的查找索引
+/// 数组建立索引后不再修改，用缓存友好的布局代替普通二分查找
+///
+/// EytzingerIndex  按BFS(堆)顺序存放: 节点k的儿子为2k, 2k+1
+///                 查找无分支，并提前预取4层之后的节点
+/// STreeIndex      静态B树: 每个节点16个关键字(int时恰好一个缓存行)，儿子按隐式下标排列
+///                 节点内用计数比较(可被编译器向量化)代替二分
+///
+/// lowerBound(x)   返回原有序数组中第一个不小于x的位置，不存在时返回size()
+/// find(x)         返回等于x的位置，不存在时返回NOT_FOUND
+/// lookupMany(...) 批量查找，多个查询交错前进以隐藏内存延迟
+
+#ifndef __STATICSEARCH_H__
+#define __STATICSEARCH_H__
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "binarySearch.h"
+
+namespace staticsearch
+{
+	// 按地址预取，不做指针运算，越界地址也不会出错
+	template <typename Object>
+	inline void prefetch(const Object* base, std::size_t index)
+	{
+		__builtin_prefetch(reinterpret_cast<const void*>(
+				reinterpret_cast<std::uintptr_t>(base) + index * sizeof(Object)));
+	}
+
+	// 64字节对齐的数组
+	template <typename Object>
+	class AlignedArray
+	{
+		public:
+			AlignedArray() : data_{nullptr}, size_{0} {}
+
+			void assign(std::size_t n, const Object& value)
+			{
+				const std::size_t pad = 64 / sizeof(Object) + 1;
+				storage_.assign(n + pad, value);
+				std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(storage_.data());
+				std::size_t skip = ((64 - addr % 64) % 64) / sizeof(Object);
+				data_ = storage_.data() + skip;
+				size_ = n;
+			}
+
+			Object& operator[] (std::size_t i) { return data_[i]; }
+			const Object& operator[] (std::size_t i) const { return data_[i]; }
+			const Object* data() const { return data_; }
+			std::size_t size() const { return size_; }
+
+		private:
+			std::vector<Object> storage_;
+			Object* data_;
+			std::size_t size_;
+	};
+
+	const std::size_t BATCH = 16; // lookupMany中同时前进的查询数
+}
+
+template <typename Object>
+class EytzingerIndex
+{
+	public:
+		EytzingerIndex() { build(std::vector<Object>()); }
+
+		explicit EytzingerIndex(const std::vector<Object>& sorted) { build(sorted); }
+
+		// sorted 必须升序
+		void build(const std::vector<Object>& sorted)
+		{
+			n_ = sorted.size();
+			tree_.assign(n_ + 1, Object{});
+			rank_.assign(n_ + 1, static_cast<uint32_t>(n_)); // rank_[0]表示不存在
+			slot_.assign(n_, 0);
+			std::size_t next = 0;
+			fill(sorted, next, 1);
+			full_levels_ = 0;
+			while((std::size_t(2) << full_levels_) - 1 <= n_)
+				++full_levels_;
+		}
+
+		std::size_t size() const { return n_; }
+
+		std::size_t lowerBound(const Object& x) const
+		{
+			std::size_t k = 1;
+			for(int level = 0; level < full_levels_; ++level)
+				k = step(k, x);
+			return finish(k, x);
+		}
+
+		int find(const Object& x) const
+		{
+			std::size_t pos = lowerBound(x);
+			if(pos == n_ || x < tree_[slot_[pos]])
+				return NOT_FOUND;
+			return static_cast<int>(pos);
+		}
+
+		// out[i] = lowerBound(queries[i])
+		void lookupMany(const Object* queries, std::size_t count, std::size_t* out) const
+		{
+			std::size_t k[staticsearch::BATCH];
+			for(std::size_t start = 0; start < count; start += staticsearch::BATCH)
+			{
+				std::size_t m = count - start < staticsearch::BATCH ? count - start : staticsearch::BATCH;
+				const Object* q = queries + start;
+				for(std::size_t i = 0; i < m; ++i)
+					k[i] = 1;
+				// 所有查询一起下降一层，预取的访存可以同时进行
+				for(int level = 0; level < full_levels_; ++level)
+					for(std::size_t i = 0; i < m; ++i)
+						k[i] = step(k[i], q[i]);
+				for(std::size_t i = 0; i < m; ++i)
+					out[start + i] = finish(k[i], q[i]);
+			}
+		}
+
+	private:
+		// 一个缓存行中的元素个数，预取 k * STRIDE 即为4层之后的16个后代
+		static const std::size_t STRIDE = 64 / sizeof(Object) ? 64 / sizeof(Object) : 1;
+
+		std::size_t n_;
+		int full_levels_; // 满层的层数，这些层中的下标一定不越界
+		staticsearch::AlignedArray<Object> tree_; // tree_[1..n]
+		std::vector<uint32_t> rank_; // Eytzinger下标 -> 有序数组下标
+		std::vector<uint32_t> slot_; // 有序数组下标 -> Eytzinger下标
+
+		// 中序遍历依次填入有序数组的元素
+		void fill(const std::vector<Object>& sorted, std::size_t& next, std::size_t k)
+		{
+			if(k > n_)
+				return;
+			fill(sorted, next, 2 * k);
+			tree_[k] = sorted[next];
+			rank_[k] = static_cast<uint32_t>(next);
+			slot_[next] = static_cast<uint32_t>(k);
+			++next;
+			fill(sorted, next, 2 * k + 1);
+		}
+
+		std::size_t step(std::size_t k, const Object& x) const
+		{
+			staticsearch::prefetch(tree_.data(), k * STRIDE);
+			return 2 * k + (tree_[k] < x);
+		}
+
+		// 最后一个不满的层，然后去掉末尾的右转(1)和一次左转(0)得到答案
+		std::size_t finish(std::size_t k, const Object& x) const
+		{
+			if(k <= n_)
+				k = 2 * k + (tree_[k] < x);
+			k >>= __builtin_ffsll(static_cast<long long>(~k));
+			return rank_[k];
+		}
+};
+
+template <typename Object>
+const std::size_t EytzingerIndex<Object>::STRIDE;
+
+template <typename Object>
+class STreeIndex
+{
+	static_assert(std::is_arithmetic<Object>::value, "STreeIndex pads nodes with numeric_limits::max()");
+
+	public:
+		static const std::size_t B = 16; // 每个节点的关键字数
+
+		STreeIndex() { build(std::vector<Object>()); }
+
+		explicit STreeIndex(const std::vector<Object>& sorted) { build(sorted); }
+
+		// sorted 必须升序
+		void build(const std::vector<Object>& sorted)
+		{
+			n_ = sorted.size();
+			n_blocks_ = (n_ + B - 1) / B;
+			keys_.assign(n_blocks_ * B, std::numeric_limits<Object>::max());
+			rank_.assign(n_blocks_ * B, static_cast<uint32_t>(n_));
+			std::size_t next = 0;
+			fill(sorted, next, 0);
+			// 按BFS顺序编号，最后一个节点最深
+			height_ = n_blocks_ == 0 ? 0 : 1;
+			for(std::size_t k = n_blocks_ - 1; n_blocks_ != 0 && k > 0; k = (k - 1) / (B + 1))
+				++height_;
+		}
+
+		std::size_t size() const { return n_; }
+
+		std::size_t lowerBound(const Object& x) const
+		{
+			std::size_t k = 0;
+			uint32_t result = static_cast<uint32_t>(n_);
+			while(k < n_blocks_)
+				k = step(k, x, result);
+			return result;
+		}
+
+		int find(const Object& x) const
+		{
+			std::size_t k = 0;
+			uint32_t result = static_cast<uint32_t>(n_);
+			std::size_t pos = n_blocks_ * B;
+			while(k < n_blocks_)
+			{
+				std::size_t i = rankInNode(k, x);
+				if(i < B)
+				{
+					result = rank_[k * B + i];
+					pos = k * B + i;
+				}
+				k = child(k, i);
+			}
+			if(result == n_ || x < keys_[pos])
+				return NOT_FOUND;
+			return static_cast<int>(result);
+		}
+
+		// out[i] = lowerBound(queries[i])
+		void lookupMany(const Object* queries, std::size_t count, std::size_t* out) const
+		{
+			std::size_t k[staticsearch::BATCH];
+			uint32_t result[staticsearch::BATCH];
+			for(std::size_t start = 0; start < count; start += staticsearch::BATCH)
+			{
+				std::size_t m = count - start < staticsearch::BATCH ? count - start : staticsearch::BATCH;
+				const Object* q = queries + start;
+				for(std::size_t i = 0; i < m; ++i)
+				{
+					k[i] = 0;
+					result[i] = static_cast<uint32_t>(n_);
+				}
+				for(int level = 0; level < height_; ++level)
+				{
+					for(std::size_t i = 0; i < m; ++i)
+					{
+						if(k[i] < n_blocks_)
+						{
+							k[i] = step(k[i], q[i], result[i]);
+							staticsearch::prefetch(keys_.data(), k[i] * B);
+						}
+					}
+				}
+				for(std::size_t i = 0; i < m; ++i)
+					out[start + i] = result[i];
+			}
+		}
+
+	private:
+		std::size_t n_;
+		std::size_t n_blocks_;
+		int height_;
+		staticsearch::AlignedArray<Object> keys_; // 节点k的关键字为 keys_[k * B, k * B + B)
+		std::vector<uint32_t> rank_; // 关键字所在的有序数组下标
+
+		static std::size_t child(std::size_t k, std::size_t i)
+		{ return k * (B + 1) + i + 1; }
+
+		// 节点中小于x的关键字个数，无分支，循环可以被向量化
+		std::size_t rankInNode(std::size_t k, const Object& x) const
+		{
+			const Object* node = keys_.data() + k * B;
+			unsigned count = 0;
+			for(std::size_t j = 0; j < B; ++j)
+				count += node[j] < x;
+			return count;
+		}
+
+		std::size_t step(std::size_t k, const Object& x, uint32_t& result) const
+		{
+			std::size_t i = rankInNode(k, x);
+			if(i < B)
+				result = rank_[k * B + i];
+			return child(k, i);
+		}
+
+		// 中序遍历: 儿子0, 关键字0, 儿子1, ..., 关键字B-1, 儿子B
+		void fill(const std::vector<Object>& sorted, std::size_t& next, std::size_t k)
+		{
+			if(k >= n_blocks_)
+				return;
+			for(std::size_t i = 0; i < B; ++i)
+			{
+				fill(sorted, next, child(k, i));
+				if(next < n_)
+				{
+					keys_[k * B + i] = sorted[next];
+					rank_[k * B + i] = static_cast<uint32_t>(next);
+					++next;
+				}
+			}
+			fill(sorted, next, child(k, B));
+		}
+};
+
+template <typename Object>
+const std::size_t STreeIndex<Object>::B;
+
+#endif
@@ -0,0 +1,100 @@
+/// @file    staticSearchBenchmark.cpp
+/// 静态查找索引与std::lower_bound的查找速度对比
+/// 用法: staticSearch_benchmark [max_exponent] [n_queries]
+/// 数组大小为 10^3, 10^4, ..., 10^max_exponent (默认7，10^9需要约24GB内存)
+
+#include "staticSearch.h"
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdint>
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+// 返回每秒查找次数(百万)，checksum用于检查结果一致并防止被优化掉
+template <typename Func>
+double measure(Func func, std::size_t n_queries, std::uint64_t& checksum)
+{
+	auto start = std::chrono::steady_clock::now();
+	checksum = func();
+	auto end = std::chrono::steady_clock::now();
+	double sec = std::chrono::duration<double>(end - start).count();
+	return n_queries / sec / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+	int max_exp = argc > 1 ? std::atoi(argv[1]) : 7;
+	std::size_t n_queries = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+	std::mt19937 gen(1);
+
+	cout << std::setw(12) << "n" << std::setw(14) << "lower_bound" << std::setw(14) << "eytzinger"
+	     << std::setw(14) << "eytz-batch" << std::setw(14) << "s-tree" << std::setw(14) << "s-tree-batch"
+	     << "   (M lookups/s)" << endl;
+	std::size_t n = 1000;
+	for(int e = 3; e <= max_exp; ++e, n *= 10)
+	{
+		vector<int> sorted(n);
+		std::uniform_int_distribution<int> dist(0, std::numeric_limits<int>::max() - 1);
+		for(auto& x : sorted)
+			x = dist(gen);
+		std::sort(sorted.begin(), sorted.end());
+		vector<int> queries(n_queries);
+		for(auto& x : queries)
+			x = dist(gen);
+
+		EytzingerIndex<int> eytzinger(sorted);
+		STreeIndex<int> stree(sorted);
+		vector<std::size_t> out(n_queries);
+		std::uint64_t expect, sum;
+		bool ok = true;
+
+		double base = measure([&]() {
+			std::uint64_t s = 0;
+			for(int x : queries)
+				s += std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+			return s;
+		}, n_queries, expect);
+		double eytz = measure([&]() {
+			std::uint64_t s = 0;
+			for(int x : queries)
+				s += eytzinger.lowerBound(x);
+			return s;
+		}, n_queries, sum);
+		ok = ok && sum == expect;
+		double eytz_batch = measure([&]() {
+			eytzinger.lookupMany(queries.data(), queries.size(), out.data());
+			std::uint64_t s = 0;
+			for(std::size_t r : out)
+				s += r;
+			return s;
+		}, n_queries, sum);
+		ok = ok && sum == expect;
+		double s_tree = measure([&]() {
+			std::uint64_t s = 0;
+			for(int x : queries)
+				s += stree.lowerBound(x);
+			return s;
+		}, n_queries, sum);
+		ok = ok && sum == expect;
+		double s_tree_batch = measure([&]() {
+			stree.lookupMany(queries.data(), queries.size(), out.data());
+			std::uint64_t s = 0;
+			for(std::size_t r : out)
+				s += r;
+			return s;
+		}, n_queries, sum);
+		ok = ok && sum == expect;
+
+		cout << std::fixed << std::setprecision(2) << std::setw(12) << n << std::setw(14) << base
+		     << std::setw(14) << eytz << std::setw(14) << eytz_batch << std::setw(14) << s_tree
+		     << std::setw(14) << s_tree_batch << (ok ? "" : "   MISMATCH!") << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,64 @@
+/// @file    staticSearchTest.cpp
+
+#include "staticSearch.h"
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+// 与std::lower_bound对比
+template <typename Index>
+void check(const char* name, const vector<int>& sorted, const vector<int>& queries)
+{
+	Index index(sorted);
+	vector<std::size_t> batch(queries.size());
+	index.lookupMany(queries.data(), queries.size(), batch.data());
+	for(std::size_t i = 0; i < queries.size(); ++i)
+	{
+		int x = queries[i];
+		std::size_t expect = std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+		int expect_find = expect < sorted.size() && sorted[expect] == x ? static_cast<int>(expect) : NOT_FOUND;
+		if(index.lowerBound(x) != expect || batch[i] != expect)
+			cout << "Oops! " << name << " lowerBound n=" << sorted.size() << " x=" << x << endl;
+		if(index.find(x) != expect_find)
+			cout << "Oops! " << name << " find n=" << sorted.size() << " x=" << x << endl;
+	}
+}
+
+int main()
+{
+	std::srand(7);
+	cout << "Begin test..." << endl;
+	for(int n = 0; n < 3000; n += 1 + n / 4)
+	{
+		vector<int> sorted;
+		for(int i = 0; i < n; ++i)
+			sorted.push_back(std::rand() % (2 * n + 1)); // 有重复
+		std::sort(sorted.begin(), sorted.end());
+		vector<int> queries;
+		for(int i = -1; i <= 2 * n + 1; ++i)
+			queries.push_back(i);
+		check<EytzingerIndex<int>>("Eytzinger", sorted, queries);
+		check<STreeIndex<int>>("STree", sorted, queries);
+
+		// binarySearch 不会越界，找到的位置确实等于key
+		for(int x : queries)
+		{
+			int pos = binarySearch(sorted, x);
+			bool exist = std::binary_search(sorted.begin(), sorted.end(), x);
+			if((pos == NOT_FOUND) == exist || (pos != NOT_FOUND && sorted[pos] != x))
+				cout << "Oops! binarySearch n=" << n << " x=" << x << endl;
+		}
+	}
+	// 关键字为最大值
+	vector<int> edge = {1, 2, std::numeric_limits<int>::max()};
+	vector<int> edge_queries = {0, 3, std::numeric_limits<int>::max()};
+	check<EytzingerIndex<int>>("Eytzinger", edge, edge_queries);
+	check<STreeIndex<int>>("STree", edge, edge_queries);
+	cout << "End test... no other output is good" << endl;
+	return 0;
+}
@@ -5,6 +5,10 @@
 
 #include "../lib/dsexceptions.h"
 #include <iostream>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "../lib/fork_join.h"
 
 // AVL Tree ADT
 // 二叉平衡树
@@ -21,12 +25,30 @@
 // void clear( )          --> Remove all items
 // void printTree( )      --> Print tree in sorted order
 // int height()           --> the height of the tree
+// buildFromSorted( first, last ) --> Build from strictly increasing input, O(n)
+// void split( x, greater )       --> Move items >= x into greater
+// void join( rhs )               --> Append rhs, all items of rhs > items of this
+// void unionWith( rhs, n_threads )        --> this = this | rhs
+// void intersectWith( rhs, n_threads )    --> this = this & rhs
+// void differenceWith( rhs, n_threads )   --> this = this - rhs
+// ******************ORDER STATISTIC***********************
+// AVLTree<Object, true> 在节点中维护子树大小，支持以下O(log n)操作
+// size_t size( )         --> Return the number of items
+// size_t rank( x )       --> Return the number of items < x
+// Object select( k )     --> Return the k-th smallest item, k from 0
+// size_t countInRange( lo, hi ) --> Return the number of items in [lo, hi]
 // ******************ERRORS********************************
 // Throws UnderflowException as warranted
+// Throws ArrayIndexOutOfBoundsException if select( k ) with k >= size( )
+// Throws IllegalArgumentException if buildFromSorted/join input is out of order
+//
+// split/join/集合运算基于join(l, k, r): 沿较高一棵树的边下降到高度相差不超过1处接上，回溯时平衡
+// split/join/集合运算都会取走rhs(或greater原有)的节点，之后rhs为空
+// 集合运算以一棵树的根为轴分割另一棵树，左右两边互不相关，前log2(n_threads)层递归用fork-join并行
 
 namespace DS
 {
-    template <typename Object>
+    template <typename Object, bool ORDER_STATISTIC = false>
     class AVLTree
     {
     private:
@@ -37,13 +59,14 @@ namespace DS
             TreeNode* left_;
             TreeNode* right_;
             int height_;
+            int size_; // 子树的节点数，只在ORDER_STATISTIC时维护
 
-            explicit TreeNode(const Object& element, TreeNode* lt = nullptr, TreeNode* rt = nullptr, int h = 0)
-                : element_{element}, left_{lt}, right_{rt}, height_{h}
+            explicit TreeNode(const Object& element, TreeNode* lt = nullptr, TreeNode* rt = nullptr, int h = 0, int sz = 1)
+                : element_{element}, left_{lt}, right_{rt}, height_{h}, size_{sz}
             {}
 
-            explicit TreeNode(Object&& element, TreeNode* lt = nullptr, TreeNode* rt = nullptr, int h = 0)
-                : element_{std::move(element)}, left_{lt}, right_{rt}, height_{h}
+            explicit TreeNode(Object&& element, TreeNode* lt = nullptr, TreeNode* rt = nullptr, int h = 0, int sz = 1)
+                : element_{std::move(element)}, left_{lt}, right_{rt}, height_{h}, size_{sz}
             {}
         };
 
@@ -51,16 +74,41 @@ namespace DS
         int height(TreeNode* node) const
         { return (nullptr == node) ? -1 : node->height_; }
 
+        // 返回子树node的节点数
+        int size(TreeNode* node) const
+        { return (nullptr == node) ? 0 : node->size_; }
+
+        // 插入、删除路径上的节点和旋转涉及的节点都经过这里，子树大小随高度一起更新
         void adjustHeight(TreeNode*& node)
         {
             int h_l = height(node->left_), h_r = height(node->right_);
             node->height_ = (h_l > h_r ? h_l : h_r) + 1;
+            if(ORDER_STATISTIC)
+                node->size_ = size(node->left_) + size(node->right_) + 1;
+        }
+
+        // 小于x (inclusive为true时不大于x) 的元素个数
+        std::size_t countLess(const Object& x, bool inclusive) const
+        {
+            std::size_t count = 0;
+            TreeNode* node = root_;
+            while(node)
+            {
+                if(node->element_ < x || (inclusive && !(x < node->element_)))
+                {
+                    count += size(node->left_) + 1;
+                    node = node->right_;
+                } else
+                    node = node->left_;
+            }
+            return count;
         }
 
         TreeNode* cloneTree(TreeNode* root) const
         {
             if(root)  // 树深拷贝，递归复制树的左子树，右子树
-                return new TreeNode(root->element_, cloneTree(root->left_), cloneTree(root->right_));
+                return new TreeNode(root->element_, cloneTree(root->left_), cloneTree(root->right_),
+                                    root->height_, root->size_);
             else
                 return nullptr;
         }
@@ -242,6 +290,149 @@ namespace DS
             rotateWithRightChild(root);
         }
 
+        // 以k为根连接l和r，l中的元素 < k < r中的元素，O(|height(l) - height(r)|)
+        TreeNode* joinProcess(TreeNode* l, TreeNode* k, TreeNode* r)
+        {
+            if(height(l) > height(r) + ALLOWED_IMBALANCE)
+            {
+                l->right_ = joinProcess(l->right_, k, r);
+                balance(l);
+                return l;
+            }
+            if(height(r) > height(l) + ALLOWED_IMBALANCE)
+            {
+                r->left_ = joinProcess(l, k, r->left_);
+                balance(r);
+                return r;
+            }
+            k->left_ = l;
+            k->right_ = r;
+            adjustHeight(k);
+            return k;
+        }
+
+        // 取出node中的最大节点，其余的部分由rest返回
+        TreeNode* splitLast(TreeNode* node, TreeNode*& rest)
+        {
+            if(node->right_ == nullptr)
+            {
+                rest = node->left_;
+                return node;
+            }
+            TreeNode* last = splitLast(node->right_, rest);
+            rest = joinProcess(node->left_, node, rest);
+            return last;
+        }
+
+        // 没有中间节点的连接
+        TreeNode* joinProcess(TreeNode* l, TreeNode* r)
+        {
+            if(l == nullptr)
+                return r;
+            TreeNode* rest;
+            TreeNode* last = splitLast(l, rest);
+            return joinProcess(rest, last, r);
+        }
+
+        // 按x把node分成 < x 和 > x 两棵树，等于x的节点放在mid中
+        void splitProcess(TreeNode* node, const Object& x, TreeNode*& less, TreeNode*& greater, TreeNode*& mid)
+        {
+            if(node == nullptr)
+            {
+                less = greater = mid = nullptr;
+                return;
+            }
+            TreeNode* left = node->left_;
+            TreeNode* right = node->right_;
+            if(node->element_ < x)
+            {
+                splitProcess(right, x, right, greater, mid);
+                less = joinProcess(left, node, right);
+            } else if(x < node->element_)
+            {
+                splitProcess(left, x, less, left, mid);
+                greater = joinProcess(left, node, right);
+            } else
+            {
+                less = left;
+                greater = right;
+                mid = node;
+            }
+        }
+
+        TreeNode* buildProcess(TreeNode** nodes, std::size_t n)
+        {
+            if(n == 0)
+                return nullptr;
+            std::size_t mid = n / 2;
+            TreeNode* node = nodes[mid];
+            node->left_ = buildProcess(nodes, mid);
+            node->right_ = buildProcess(nodes + mid + 1, n - mid - 1);
+            adjustHeight(node);
+            return node;
+        }
+
+        TreeNode* unionProcess(TreeNode* a, TreeNode* b, int depth)
+        {
+            if(a == nullptr)
+                return b;
+            if(b == nullptr)
+                return a;
+            TreeNode *less, *greater, *mid;
+            splitProcess(b, a->element_, less, greater, mid);
+            delete mid; // 重复元素
+            TreeNode* left = a->left_;
+            TreeNode* right = a->right_;
+            forkJoin(depth,
+                     [&]() { left = unionProcess(left, less, depth - 1); },
+                     [&]() { right = unionProcess(right, greater, depth - 1); });
+            return joinProcess(left, a, right);
+        }
+
+        TreeNode* intersectProcess(TreeNode* a, TreeNode* b, int depth)
+        {
+            if(a == nullptr || b == nullptr)
+            {
+                clearTree(a);
+                clearTree(b);
+                return nullptr;
+            }
+            TreeNode *less, *greater, *mid;
+            splitProcess(b, a->element_, less, greater, mid);
+            TreeNode* left = a->left_;
+            TreeNode* right = a->right_;
+            forkJoin(depth,
+                     [&]() { left = intersectProcess(left, less, depth - 1); },
+                     [&]() { right = intersectProcess(right, greater, depth - 1); });
+            if(mid != nullptr) // 两边都有，保留a
+            {
+                delete mid;
+                return joinProcess(left, a, right);
+            }
+            delete a;
+            return joinProcess(left, right);
+        }
+
+        // a - b，以b的根为轴分割a
+        TreeNode* differenceProcess(TreeNode* a, TreeNode* b, int depth)
+        {
+            if(a == nullptr || b == nullptr)
+            {
+                clearTree(b);
+                return a;
+            }
+            TreeNode *less, *greater, *mid;
+            splitProcess(a, b->element_, less, greater, mid);
+            delete mid;
+            TreeNode* left = b->left_;
+            TreeNode* right = b->right_;
+            delete b;
+            forkJoin(depth,
+                     [&]() { less = differenceProcess(less, left, depth - 1); },
+                     [&]() { greater = differenceProcess(greater, right, depth - 1); });
+            return joinProcess(less, greater);
+        }
+
         TreeNode* root_;
 
     public:
@@ -278,6 +469,9 @@ namespace DS
         bool empty() const
         { return root_ == nullptr; }
 
+        int height() const
+        { return height(root_); }
+
         // 判断树是否包含x
         bool contains(const Object& x) const
         {
@@ -329,6 +523,103 @@ namespace DS
         {
             removeProcess(x, root_);
         }
+
+        // 由严格递增的序列建树，每次取中间的元素作为根，O(n)
+        // first, last 为随机访问迭代器
+        template <typename Iterator>
+        void buildFromSorted(Iterator first, Iterator last)
+        {
+            std::size_t n = last - first;
+            for(std::size_t i = 1; i < n; ++i)
+                if(!(first[i - 1] < first[i]))
+                    throw IllegalArgumentException{};
+            clear();
+            std::vector<TreeNode*> nodes(n);
+            for(std::size_t i = 0; i < n; ++i)
+                nodes[i] = new TreeNode(first[i]);
+            root_ = buildProcess(nodes.data(), n);
+        }
+
+        // 把 >= x 的元素移到greater中(greater原有的元素被清除)
+        void split(const Object& x, AVLTree& greater)
+        {
+            greater.clear();
+            TreeNode* mid;
+            splitProcess(root_, x, root_, greater.root_, mid);
+            if(mid != nullptr)
+                greater.root_ = joinProcess(nullptr, mid, greater.root_);
+        }
+
+        // 把rhs接在后面，要求rhs的元素都大于本树的元素
+        void join(AVLTree& rhs)
+        {
+            if(!empty() && !rhs.empty() && !(findMax() < rhs.findMin()))
+                throw IllegalArgumentException{};
+            root_ = joinProcess(root_, rhs.root_);
+            rhs.root_ = nullptr;
+        }
+
+        void unionWith(AVLTree& rhs, unsigned n_threads = 1)
+        {
+            root_ = unionProcess(root_, rhs.root_, forkDepth(n_threads));
+            rhs.root_ = nullptr;
+        }
+
+        void intersectWith(AVLTree& rhs, unsigned n_threads = 1)
+        {
+            root_ = intersectProcess(root_, rhs.root_, forkDepth(n_threads));
+            rhs.root_ = nullptr;
+        }
+
+        void differenceWith(AVLTree& rhs, unsigned n_threads = 1)
+        {
+            root_ = differenceProcess(root_, rhs.root_, forkDepth(n_threads));
+            rhs.root_ = nullptr;
+        }
+
+        std::size_t size() const
+        {
+            static_assert(ORDER_STATISTIC, "size() requires AVLTree<Object, true>");
+            return size(root_);
+        }
+
+        // 小于x的元素个数，也就是x在升序中的下标
+        std::size_t rank(const Object& x) const
+        {
+            static_assert(ORDER_STATISTIC, "rank() requires AVLTree<Object, true>");
+            return countLess(x, false);
+        }
+
+        // 第k小的元素，k从0开始
+        const Object& select(std::size_t k) const
+        {
+            static_assert(ORDER_STATISTIC, "select() requires AVLTree<Object, true>");
+            if(k >= size())
+                throw ArrayIndexOutOfBoundsException{};
+            TreeNode* node = root_;
+            while(true)
+            {
+                std::size_t left = size(node->left_);
+                if(k < left)
+                    node = node->left_;
+                else if(k == left)
+                    return node->element_;
+                else
+                {
+                    k -= left + 1;
+                    node = node->right_;
+                }
+            }
+        }
+
+        // [lo, hi] 中的元素个数
+        std::size_t countInRange(const Object& lo, const Object& hi) const
+        {
+            static_assert(ORDER_STATISTIC, "countInRange() requires AVLTree<Object, true>");
+            if(hi < lo)
+                return 0;
+            return countLess(hi, true) - countLess(lo, false);
+        }
     };
 }
 #endif //__AVL_TREE_HPP__
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <vector>
 #include "avl_tree.hpp"
 using namespace std;
 using DS::AVLTree;
@@ -47,6 +48,68 @@ int main()
             cout << "Find error2: " << i << endl;
     }
 
+    // 顺序统计
+    AVLTree<int, true> r;
+    for(i = GAP; i != 0; i = (i + GAP) % NUMS)
+        r.insert(i);
+    for(i = 1; i < NUMS; i += 2)
+        r.remove(i);
+    if(r.size() != static_cast<size_t>(NUMS / 2 - 1))
+        cout << "Size error: " << r.size() << endl;
+    for(i = 2; i < NUMS; i += 2)
+    {
+        if(r.rank(i) != static_cast<size_t>(i / 2 - 1) || r.rank(i + 1) != static_cast<size_t>(i / 2))
+            cout << "Rank error: " << i << endl;
+        if(r.select(i / 2 - 1) != i)
+            cout << "Select error: " << i << endl;
+    }
+    if(r.countInRange(99, 200) != 51 || r.countInRange(200, 99) != 0 || r.countInRange(-5, NUMS) != r.size())
+        cout << "CountInRange error!" << endl;
+    AVLTree<int, true> r2;
+    r2 = r;
+    if(r2.select(0) != 2 || r2.rank(NUMS) != r.size())
+        cout << "Copy error!" << endl;
+
+    // 批量建树、分割与连接、集合运算
+    vector<int> evens, thirds;
+    for(i = 0; i < NUMS; i += 2)
+        evens.push_back(i);
+    for(i = 0; i < NUMS; i += 3)
+        thirds.push_back(i);
+    AVLTree<int, true> a, b, g;
+    a.buildFromSorted(evens.begin(), evens.end());
+    if(a.size() != evens.size() || a.height() > 15 || a.select(100) != 200)
+        cout << "BuildFromSorted error!" << endl;
+    a.split(1001, g);
+    if(a.findMax() != 1000 || g.findMin() != 1002 || a.size() + g.size() != evens.size())
+        cout << "Split error!" << endl;
+    a.join(g);
+    if(!g.empty() || a.size() != evens.size() || a.rank(NUMS) != a.size())
+        cout << "Join error!" << endl;
+
+    b.buildFromSorted(thirds.begin(), thirds.end());
+    a.unionWith(b, 4);
+    if(!b.empty() || a.size() != static_cast<size_t>((NUMS - 1) / 2 + (NUMS - 1) / 3 - (NUMS - 1) / 6 + 1))
+        cout << "Union error: " << a.size() << endl;
+    for(i = 0; i < NUMS; ++i)
+        if(a.contains(i) != (i % 2 == 0 || i % 3 == 0))
+            cout << "Union error: " << i << endl;
+
+    b.buildFromSorted(thirds.begin(), thirds.end());
+    a.differenceWith(b, 4);
+    for(i = 0; i < NUMS; ++i)
+        if(a.contains(i) != (i % 2 == 0 && i % 3 != 0))
+            cout << "Difference error: " << i << endl;
+
+    b.buildFromSorted(evens.begin(), evens.end());
+    g.buildFromSorted(thirds.begin(), thirds.end());
+    b.intersectWith(g, 4);
+    if(b.size() != static_cast<size_t>((NUMS - 1) / 6 + 1))
+        cout << "Intersection error: " << b.size() << endl;
+    for(i = 0; i < NUMS; ++i)
+        if(b.contains(i) != (i % 6 == 0))
+            cout << "Intersection error: " << i << endl;
+
     cout << "End of test..." << endl;
     return 0;
 }
@@ -0,0 +1,756 @@
+// B+树
+
+#ifndef __BPLUS_TREE_HPP__
+#define __BPLUS_TREE_HPP__
+
+#include "../lib/dsexceptions.h"
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+// B+ Tree ADT
+// 有序集合/映射，所有元素都在叶子中，内部节点只存分隔关键字
+// 一个节点的关键字占NODE_BYTES字节(默认256字节，即4个缓存行)，树高比二叉树低得多，
+// 每次查找只访问很少的节点，节点内用计数比较(可被编译器向量化)代替二分
+// 叶子用双向链表连接，范围查询只需定位一次，然后沿链表扫描
+//
+// BPlusTree<Key>          集合
+// BPlusTree<Key, Value>   映射，每个关键字对应一个值
+//
+// ******************PUBLIC OPERATIONS*********************
+// void insert( x )       --> Insert x
+// bool insert( x, v )    --> Insert x with value v, return false if x is present
+// void remove( x )       --> Remove x
+// bool contains( x )     --> Return true if x is present
+// Value* find( x )       --> Return the value of x, or nullptr
+// Object findMin( )      --> Return smallest item
+// Object findMax( )      --> Return largest item
+// bool empty( )          --> Return true if empty; else false
+// size_t size( )         --> Return the number of items
+// void clear( )          --> Remove all items
+// void printTree( )      --> Print tree in sorted order
+// int height( )          --> the height of the tree, -1 if empty
+// buildFromSorted( v )   --> Bulk-load from strictly increasing input, O(n)
+// lowerBound( x )        --> Iterator to the first item >= x
+// upperBound( x )        --> Iterator to the first item > x
+// forEachInRange( lo, hi, fn ) --> Call fn(x) for every lo <= x <= hi
+// ******************ERRORS********************************
+// Throws UnderflowException as warranted
+// Throws IllegalArgumentException if buildFromSorted input is not strictly increasing
+
+namespace DS
+{
+    // 集合不需要值，用空类型占位
+    struct BPlusSetTag {};
+
+    template <typename Key, typename Value = BPlusSetTag, std::size_t NODE_BYTES = 256>
+    class BPlusTree
+    {
+    private:
+        // 节点的关键字个数，至少为4
+        static const int MAX_KEYS = NODE_BYTES / sizeof(Key) < 4 ? 4 : static_cast<int>(NODE_BYTES / sizeof(Key));
+        static const int MIN_KEYS = MAX_KEYS / 2; // 非根节点的最少关键字个数
+
+        class Node
+        {
+        public:
+            bool is_leaf_;
+            int n_; // 关键字个数
+
+            explicit Node(bool is_leaf)
+            : is_leaf_{is_leaf}, n_{0}
+            {}
+        };
+
+        // 内部节点: children_[i]中的关键字 < keys_[i] <= children_[i + 1]中的关键字
+        class InnerNode : public Node
+        {
+        public:
+            Key keys_[MAX_KEYS];
+            Node* children_[MAX_KEYS + 1];
+
+            InnerNode()
+            : Node(false)
+            {}
+        };
+
+        class LeafNode : public Node
+        {
+        public:
+            Key keys_[MAX_KEYS];
+            Value values_[MAX_KEYS];
+            LeafNode* prev_;
+            LeafNode* next_;
+
+            LeafNode()
+            : Node(true), prev_{nullptr}, next_{nullptr}
+            {}
+        };
+
+    public:
+        // 沿叶子链表前进的只读迭代器
+        class const_iterator
+        {
+        public:
+            const_iterator()
+            : leaf_{nullptr}, index_{0}
+            {}
+
+            const Key& operator* () const
+            { return leaf_->keys_[index_]; }
+
+            const Key* operator-> () const
+            { return &leaf_->keys_[index_]; }
+
+            const Value& value() const
+            { return leaf_->values_[index_]; }
+
+            const_iterator& operator++ ()
+            {
+                if(++index_ == leaf_->n_)
+                {
+                    leaf_ = leaf_->next_;
+                    index_ = 0;
+                }
+                return *this;
+            }
+
+            const_iterator operator++ (int)
+            {
+                const_iterator old = *this;
+                ++(*this);
+                return old;
+            }
+
+            bool operator== (const const_iterator& rhs) const
+            { return leaf_ == rhs.leaf_ && index_ == rhs.index_; }
+
+            bool operator!= (const const_iterator& rhs) const
+            { return !(*this == rhs); }
+
+        private:
+            const LeafNode* leaf_;
+            int index_;
+
+            const_iterator(const LeafNode* leaf, int index)
+            : leaf_{leaf}, index_{index}
+            {}
+
+            friend class BPlusTree;
+        };
+
+        BPlusTree()
+        : root_{nullptr}, head_{nullptr}, tail_{nullptr}, size_{0}
+        {}
+
+        BPlusTree(const BPlusTree& rhs)
+        : root_{nullptr}, head_{nullptr}, tail_{nullptr}, size_{0}
+        {
+            // 按顺序取出全部元素后批量建树
+            std::vector<Key> keys;
+            std::vector<Value> values;
+            keys.reserve(rhs.size_);
+            values.reserve(rhs.size_);
+            for(const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+            {
+                keys.push_back(*it);
+                values.push_back(it.value());
+            }
+            bulkLoad(keys, values);
+        }
+
+        BPlusTree(BPlusTree&& rhs) noexcept
+        : root_{rhs.root_}, head_{rhs.head_}, tail_{rhs.tail_}, size_{rhs.size_}
+        {
+            rhs.root_ = nullptr;
+            rhs.head_ = rhs.tail_ = nullptr;
+            rhs.size_ = 0;
+        }
+
+        ~BPlusTree()
+        { clear(); }
+
+        BPlusTree& operator=(const BPlusTree& rhs)
+        {
+            BPlusTree copy{rhs};
+            std::swap(*this, copy);
+            return *this;
+        }
+
+        BPlusTree& operator=(BPlusTree&& rhs) noexcept
+        {
+            std::swap(root_, rhs.root_);
+            std::swap(head_, rhs.head_);
+            std::swap(tail_, rhs.tail_);
+            std::swap(size_, rhs.size_);
+            return *this;
+        }
+
+        bool empty() const
+        { return root_ == nullptr; }
+
+        std::size_t size() const
+        { return size_; }
+
+        int height() const
+        {
+            int h = -1;
+            for(const Node* node = root_; node != nullptr; ++h)
+                node = node->is_leaf_ ? nullptr : static_cast<const InnerNode*>(node)->children_[0];
+            return h;
+        }
+
+        const Key& findMin() const
+        {
+            if(empty())
+                throw UnderflowException{};
+            return head_->keys_[0];
+        }
+
+        const Key& findMax() const
+        {
+            if(empty())
+                throw UnderflowException{};
+            return tail_->keys_[tail_->n_ - 1];
+        }
+
+        bool contains(const Key& x) const
+        { return find(x) != nullptr; }
+
+        const Value* find(const Key& x) const
+        {
+            if(empty())
+                return nullptr;
+            const LeafNode* leaf = findLeaf(x);
+            int pos = countLess(leaf->keys_, leaf->n_, x);
+            if(pos < leaf->n_ && !(x < leaf->keys_[pos]))
+                return &leaf->values_[pos];
+            return nullptr;
+        }
+
+        Value* find(const Key& x)
+        { return const_cast<Value*>(static_cast<const BPlusTree*>(this)->find(x)); }
+
+        void printTree(std::ostream& out = std::cout, bool reverse = false) const
+        {
+            if(empty())
+                out << "Empty tree" << std::endl;
+            else if(reverse)
+            {
+                for(const LeafNode* leaf = tail_; leaf != nullptr; leaf = leaf->prev_)
+                    for(int i = leaf->n_ - 1; i >= 0; --i)
+                        out << leaf->keys_[i] << std::endl;
+            } else
+            {
+                for(const_iterator it = begin(); it != end(); ++it)
+                    out << *it << std::endl;
+            }
+        }
+
+        void clear()
+        {
+            clearTree(root_);
+            root_ = nullptr;
+            head_ = tail_ = nullptr;
+            size_ = 0;
+        }
+
+        // 插入，重复项不考虑
+        void insert(const Key& x)
+        { insert(x, Value{}); }
+
+        // 插入关键字和值，关键字已存在时不修改原来的值并返回false
+        bool insert(const Key& x, const Value& v)
+        {
+            if(empty())
+            {
+                LeafNode* leaf = new LeafNode;
+                root_ = head_ = tail_ = leaf;
+            }
+            Key up_key;
+            Node* up_node = nullptr;
+            if(!insertProcess(root_, x, v, up_key, up_node))
+                return false;
+            ++size_;
+            if(up_node != nullptr) // 根节点分裂，树高加一
+            {
+                InnerNode* root = new InnerNode;
+                root->n_ = 1;
+                root->keys_[0] = up_key;
+                root->children_[0] = root_;
+                root->children_[1] = up_node;
+                root_ = root;
+            }
+            return true;
+        }
+
+        void remove(const Key& x)
+        {
+            if(empty() || !removeProcess(root_, x))
+                return;
+            --size_;
+            if(root_->n_ == 0)
+            {
+                Node* old = root_;
+                if(root_->is_leaf_)
+                {
+                    root_ = nullptr;
+                    head_ = tail_ = nullptr;
+                } else
+                    root_ = static_cast<InnerNode*>(root_)->children_[0];
+                delete old;
+            }
+        }
+
+        // 由严格递增的序列批量建树，每个节点尽量填满，O(n)
+        void buildFromSorted(const std::vector<Key>& sorted)
+        {
+            std::vector<Value> values(sorted.size());
+            bulkLoad(sorted, values);
+        }
+
+        void buildFromSorted(const std::vector<std::pair<Key, Value>>& sorted)
+        {
+            std::vector<Key> keys;
+            std::vector<Value> values;
+            keys.reserve(sorted.size());
+            values.reserve(sorted.size());
+            for(const auto& item : sorted)
+            {
+                keys.push_back(item.first);
+                values.push_back(item.second);
+            }
+            bulkLoad(keys, values);
+        }
+
+        const_iterator begin() const
+        { return const_iterator(head_, 0); }
+
+        const_iterator end() const
+        { return const_iterator(); }
+
+        const_iterator lowerBound(const Key& x) const
+        {
+            if(empty())
+                return end();
+            const LeafNode* leaf = findLeaf(x);
+            return makeIterator(leaf, countLess(leaf->keys_, leaf->n_, x));
+        }
+
+        const_iterator upperBound(const Key& x) const
+        {
+            if(empty())
+                return end();
+            const LeafNode* leaf = findLeaf(x);
+            return makeIterator(leaf, countLessEqual(leaf->keys_, leaf->n_, x));
+        }
+
+        // 对 [lo, hi] 中的每个关键字调用 fn(x)
+        template <typename Function>
+        void forEachInRange(const Key& lo, const Key& hi, Function fn) const
+        {
+            for(const_iterator it = lowerBound(lo); it != end() && !(hi < *it); ++it)
+                fn(*it);
+        }
+
+    private:
+        Node* root_;
+        LeafNode* head_; // 最小的叶子
+        LeafNode* tail_; // 最大的叶子
+        std::size_t size_;
+
+        // 节点中小于x的关键字个数，无分支，循环可以被向量化
+        static int countLess(const Key* keys, int n, const Key& x)
+        {
+            int count = 0;
+            for(int i = 0; i < n; ++i)
+                count += keys[i] < x;
+            return count;
+        }
+
+        // 节点中不大于x的关键字个数，即内部节点中x所在的儿子
+        static int countLessEqual(const Key* keys, int n, const Key& x)
+        {
+            int count = 0;
+            for(int i = 0; i < n; ++i)
+                count += !(x < keys[i]);
+            return count;
+        }
+
+        const LeafNode* findLeaf(const Key& x) const
+        {
+            const Node* node = root_;
+            while(!node->is_leaf_)
+            {
+                const InnerNode* inner = static_cast<const InnerNode*>(node);
+                node = inner->children_[countLessEqual(inner->keys_, inner->n_, x)];
+            }
+            return static_cast<const LeafNode*>(node);
+        }
+
+        // 叶子末尾的位置对应下一个叶子的开头
+        static const_iterator makeIterator(const LeafNode* leaf, int index)
+        {
+            if(index == leaf->n_)
+                return const_iterator(leaf->next_, 0);
+            return const_iterator(leaf, index);
+        }
+
+        void clearTree(Node* node)
+        {
+            if(node == nullptr)
+                return;
+            if(node->is_leaf_)
+            {
+                delete static_cast<LeafNode*>(node);
+                return;
+            }
+            InnerNode* inner = static_cast<InnerNode*>(node);
+            for(int i = 0; i <= inner->n_; ++i)
+                clearTree(inner->children_[i]);
+            delete inner;
+        }
+
+        // 递归插入，节点分裂时由up_key, up_node返回新的右兄弟及其分隔关键字
+        bool insertProcess(Node* node, const Key& x, const Value& v, Key& up_key, Node*& up_node)
+        {
+            if(node->is_leaf_)
+                return insertLeaf(static_cast<LeafNode*>(node), x, v, up_key, up_node);
+
+            InnerNode* inner = static_cast<InnerNode*>(node);
+            int i = countLessEqual(inner->keys_, inner->n_, x);
+            Key child_key;
+            Node* child_node = nullptr;
+            if(!insertProcess(inner->children_[i], x, v, child_key, child_node))
+                return false;
+            if(child_node == nullptr)
+                return true;
+
+            if(inner->n_ < MAX_KEYS)
+            {
+                for(int j = inner->n_; j > i; --j)
+                {
+                    inner->keys_[j] = std::move(inner->keys_[j - 1]);
+                    inner->children_[j + 1] = inner->children_[j];
+                }
+                inner->keys_[i] = std::move(child_key);
+                inner->children_[i + 1] = child_node;
+                ++inner->n_;
+                return true;
+            }
+
+            // 节点已满，先合在一起再从中间分开，中间的关键字上移
+            Key keys[MAX_KEYS + 1];
+            Node* children[MAX_KEYS + 2];
+            for(int j = 0, k = 0; j <= MAX_KEYS; ++j)
+                keys[j] = j == i ? child_key : std::move(inner->keys_[k++]);
+            for(int j = 0, k = 0; j <= MAX_KEYS + 1; ++j)
+                children[j] = j == i + 1 ? child_node : inner->children_[k++];
+
+            const int total = MAX_KEYS + 1;
+            const int mid = total / 2;
+            InnerNode* right = new InnerNode;
+            inner->n_ = mid;
+            right->n_ = total - mid - 1;
+            for(int j = 0; j < mid; ++j)
+                inner->keys_[j] = std::move(keys[j]);
+            for(int j = 0; j <= mid; ++j)
+                inner->children_[j] = children[j];
+            for(int j = 0; j < right->n_; ++j)
+                right->keys_[j] = std::move(keys[mid + 1 + j]);
+            for(int j = 0; j <= right->n_; ++j)
+                right->children_[j] = children[mid + 1 + j];
+            up_key = std::move(keys[mid]);
+            up_node = right;
+            return true;
+        }
+
+        bool insertLeaf(LeafNode* leaf, const Key& x, const Value& v, Key& up_key, Node*& up_node)
+        {
+            int pos = countLess(leaf->keys_, leaf->n_, x);
+            if(pos < leaf->n_ && !(x < leaf->keys_[pos]))
+                return false;
+
+            if(leaf->n_ == MAX_KEYS)
+            {
+                // 叶子已满，后一半移到新的右兄弟
+                const int mid = MAX_KEYS / 2;
+                LeafNode* right = new LeafNode;
+                for(int j = mid; j < MAX_KEYS; ++j)
+                {
+                    right->keys_[j - mid] = std::move(leaf->keys_[j]);
+                    right->values_[j - mid] = std::move(leaf->values_[j]);
+                }
+                right->n_ = MAX_KEYS - mid;
+                leaf->n_ = mid;
+
+                right->next_ = leaf->next_;
+                right->prev_ = leaf;
+                if(leaf->next_ != nullptr)
+                    leaf->next_->prev_ = right;
+                else
+                    tail_ = right;
+                leaf->next_ = right;
+
+                if(pos > mid)
+                {
+                    leaf = right;
+                    pos -= mid;
+                }
+                up_node = right;
+            }
+
+            for(int j = leaf->n_; j > pos; --j)
+            {
+                leaf->keys_[j] = std::move(leaf->keys_[j - 1]);
+                leaf->values_[j] = std::move(leaf->values_[j - 1]);
+            }
+            leaf->keys_[pos] = x;
+            leaf->values_[pos] = v;
+            ++leaf->n_;
+
+            if(up_node != nullptr)
+                up_key = static_cast<LeafNode*>(up_node)->keys_[0];
+            return true;
+        }
+
+        // 递归删除，儿子的关键字不足时向兄弟借或者与兄弟合并
+        // 分隔关键字不需要随删除更新，它仍然是左右两边的分界
+        bool removeProcess(Node* node, const Key& x)
+        {
+            if(node->is_leaf_)
+            {
+                LeafNode* leaf = static_cast<LeafNode*>(node);
+                int pos = countLess(leaf->keys_, leaf->n_, x);
+                if(pos == leaf->n_ || x < leaf->keys_[pos])
+                    return false;
+                for(int j = pos + 1; j < leaf->n_; ++j)
+                {
+                    leaf->keys_[j - 1] = std::move(leaf->keys_[j]);
+                    leaf->values_[j - 1] = std::move(leaf->values_[j]);
+                }
+                --leaf->n_;
+                return true;
+            }
+
+            InnerNode* inner = static_cast<InnerNode*>(node);
+            int i = countLessEqual(inner->keys_, inner->n_, x);
+            if(!removeProcess(inner->children_[i], x))
+                return false;
+            if(inner->children_[i]->n_ < MIN_KEYS)
+                rebalance(inner, i);
+            return true;
+        }
+
+        void rebalance(InnerNode* parent, int i)
+        {
+            Node* child = parent->children_[i];
+            Node* left = i > 0 ? parent->children_[i - 1] : nullptr;
+            Node* right = i < parent->n_ ? parent->children_[i + 1] : nullptr;
+
+            if(left != nullptr && left->n_ > MIN_KEYS)
+            {
+                if(child->is_leaf_)
+                    borrowFromLeftLeaf(parent, i);
+                else
+                    borrowFromLeftInner(parent, i);
+            } else if(right != nullptr && right->n_ > MIN_KEYS)
+            {
+                if(child->is_leaf_)
+                    borrowFromRightLeaf(parent, i);
+                else
+                    borrowFromRightInner(parent, i);
+            } else
+            {
+                int j = left != nullptr ? i - 1 : i; // 合并 children_[j] 和 children_[j + 1]
+                if(child->is_leaf_)
+                    mergeLeaves(parent, j);
+                else
+                    mergeInners(parent, j);
+            }
+        }
+
+        void borrowFromLeftLeaf(InnerNode* parent, int i)
+        {
+            LeafNode* child = static_cast<LeafNode*>(parent->children_[i]);
+            LeafNode* left = static_cast<LeafNode*>(parent->children_[i - 1]);
+            for(int j = child->n_; j > 0; --j)
+            {
+                child->keys_[j] = std::move(child->keys_[j - 1]);
+                child->values_[j] = std::move(child->values_[j - 1]);
+            }
+            --left->n_;
+            child->keys_[0] = std::move(left->keys_[left->n_]);
+            child->values_[0] = std::move(left->values_[left->n_]);
+            ++child->n_;
+            parent->keys_[i - 1] = child->keys_[0];
+        }
+
+        void borrowFromRightLeaf(InnerNode* parent, int i)
+        {
+            LeafNode* child = static_cast<LeafNode*>(parent->children_[i]);
+            LeafNode* right = static_cast<LeafNode*>(parent->children_[i + 1]);
+            child->keys_[child->n_] = std::move(right->keys_[0]);
+            child->values_[child->n_] = std::move(right->values_[0]);
+            ++child->n_;
+            for(int j = 1; j < right->n_; ++j)
+            {
+                right->keys_[j - 1] = std::move(right->keys_[j]);
+                right->values_[j - 1] = std::move(right->values_[j]);
+            }
+            --right->n_;
+            parent->keys_[i] = right->keys_[0];
+        }
+
+        // 父节点的分隔关键字下移到儿子，左兄弟的最大关键字上移到父节点
+        void borrowFromLeftInner(InnerNode* parent, int i)
+        {
+            InnerNode* child = static_cast<InnerNode*>(parent->children_[i]);
+            InnerNode* left = static_cast<InnerNode*>(parent->children_[i - 1]);
+            child->children_[child->n_ + 1] = child->children_[child->n_];
+            for(int j = child->n_; j > 0; --j)
+            {
+                child->keys_[j] = std::move(child->keys_[j - 1]);
+                child->children_[j] = child->children_[j - 1];
+            }
+            child->keys_[0] = std::move(parent->keys_[i - 1]);
+            child->children_[0] = left->children_[left->n_];
+            ++child->n_;
+            --left->n_;
+            parent->keys_[i - 1] = std::move(left->keys_[left->n_]);
+        }
+
+        void borrowFromRightInner(InnerNode* parent, int i)
+        {
+            InnerNode* child = static_cast<InnerNode*>(parent->children_[i]);
+            InnerNode* right = static_cast<InnerNode*>(parent->children_[i + 1]);
+            child->keys_[child->n_] = std::move(parent->keys_[i]);
+            child->children_[child->n_ + 1] = right->children_[0];
+            ++child->n_;
+            parent->keys_[i] = std::move(right->keys_[0]);
+            for(int j = 1; j < right->n_; ++j)
+            {
+                right->keys_[j - 1] = std::move(right->keys_[j]);
+                right->children_[j - 1] = right->children_[j];
+            }
+            right->children_[right->n_ - 1] = right->children_[right->n_];
+            --right->n_;
+        }
+
+        // 从父节点中删去 keys_[j] 和 children_[j + 1]
+        static void removeFromParent(InnerNode* parent, int j)
+        {
+            for(int k = j + 1; k < parent->n_; ++k)
+            {
+                parent->keys_[k - 1] = std::move(parent->keys_[k]);
+                parent->children_[k] = parent->children_[k + 1];
+            }
+            --parent->n_;
+        }
+
+        void mergeLeaves(InnerNode* parent, int j)
+        {
+            LeafNode* left = static_cast<LeafNode*>(parent->children_[j]);
+            LeafNode* right = static_cast<LeafNode*>(parent->children_[j + 1]);
+            for(int k = 0; k < right->n_; ++k)
+            {
+                left->keys_[left->n_ + k] = std::move(right->keys_[k]);
+                left->values_[left->n_ + k] = std::move(right->values_[k]);
+            }
+            left->n_ += right->n_;
+            left->next_ = right->next_;
+            if(right->next_ != nullptr)
+                right->next_->prev_ = left;
+            else
+                tail_ = left;
+            delete right;
+            removeFromParent(parent, j);
+        }
+
+        void mergeInners(InnerNode* parent, int j)
+        {
+            InnerNode* left = static_cast<InnerNode*>(parent->children_[j]);
+            InnerNode* right = static_cast<InnerNode*>(parent->children_[j + 1]);
+            left->keys_[left->n_] = std::move(parent->keys_[j]);
+            for(int k = 0; k < right->n_; ++k)
+                left->keys_[left->n_ + 1 + k] = std::move(right->keys_[k]);
+            for(int k = 0; k <= right->n_; ++k)
+                left->children_[left->n_ + 1 + k] = right->children_[k];
+            left->n_ += right->n_ + 1;
+            delete right;
+            removeFromParent(parent, j);
+        }
+
+        // 自底向上逐层建树，同一层的元素平均分到各个节点，保证每个非根节点不少于MIN_KEYS
+        void bulkLoad(const std::vector<Key>& keys, const std::vector<Value>& values)
+        {
+            for(std::size_t i = 1; i < keys.size(); ++i)
+                if(!(keys[i - 1] < keys[i]))
+                    throw IllegalArgumentException{};
+            clear();
+            const std::size_t n = keys.size();
+            if(n == 0)
+                return;
+
+            std::vector<Node*> level;
+            std::vector<Key> mins; // 每个节点子树中的最小关键字
+            std::size_t n_leaves = (n + MAX_KEYS - 1) / MAX_KEYS;
+            LeafNode* prev = nullptr;
+            for(std::size_t l = 0, next = 0; l < n_leaves; ++l)
+            {
+                LeafNode* leaf = new LeafNode;
+                int count = static_cast<int>(n / n_leaves + (l < n % n_leaves));
+                for(int k = 0; k < count; ++k, ++next)
+                {
+                    leaf->keys_[k] = keys[next];
+                    leaf->values_[k] = values[next];
+                }
+                leaf->n_ = count;
+                leaf->prev_ = prev;
+                if(prev != nullptr)
+                    prev->next_ = leaf;
+                else
+                    head_ = leaf;
+                prev = leaf;
+                level.push_back(leaf);
+                mins.push_back(leaf->keys_[0]);
+            }
+            tail_ = prev;
+
+            while(level.size() > 1)
+            {
+                std::vector<Node*> upper;
+                std::vector<Key> upper_mins;
+                std::size_t m = level.size();
+                std::size_t n_nodes = (m + MAX_KEYS) / (MAX_KEYS + 1);
+                for(std::size_t g = 0, next = 0; g < n_nodes; ++g)
+                {
+                    InnerNode* inner = new InnerNode;
+                    int count = static_cast<int>(m / n_nodes + (g < m % n_nodes)); // 儿子个数
+                    upper_mins.push_back(mins[next]);
+                    for(int k = 0; k < count; ++k, ++next)
+                    {
+                        inner->children_[k] = level[next];
+                        if(k > 0)
+                            inner->keys_[k - 1] = mins[next];
+                    }
+                    inner->n_ = count - 1;
+                    upper.push_back(inner);
+                }
+                level.swap(upper);
+                mins.swap(upper_mins);
+            }
+            root_ = level[0];
+            size_ = n;
+        }
+    };
+
+    template <typename Key, typename Value, std::size_t NODE_BYTES>
+    const int BPlusTree<Key, Value, NODE_BYTES>::MAX_KEYS;
+
+    template <typename Key, typename Value, std::size_t NODE_BYTES>
+    const int BPlusTree<Key, Value, NODE_BYTES>::MIN_KEYS;
+}
+
+#endif //__BPLUS_TREE_HPP__
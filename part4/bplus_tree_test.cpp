@@ -0,0 +1,140 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bplus_tree.hpp"
+using namespace std;
+using DS::BPlusTree;
+using DS::BPlusSetTag;
+
+// 节点很小的树，用于检查分裂、借用与合并
+typedef BPlusTree<int, BPlusSetTag, 16> SmallTree;
+
+template <typename Tree>
+void testSet(int NUMS)
+{
+    Tree t;
+    const int GAP = 37;
+    int i;
+
+    for(i = GAP; i != 0; i = (i + GAP) % NUMS)
+        t.insert(i);
+    t.remove(0);
+    for(i = 1; i < NUMS; i += 2)
+        t.remove(i);
+
+    if(NUMS < 40)
+        t.printTree();
+    if(t.findMin() != 2 || t.findMax() != NUMS - 2)
+        cout << "FindMin or FindMax error!" << endl;
+    if(t.size() != static_cast<size_t>(NUMS / 2 - 1))
+        cout << "Size error: " << t.size() << endl;
+
+    for(i = 2; i < NUMS; i += 2)
+        if(!t.contains(i))
+            cout << "Find error1: " << i << endl;
+
+    for(i = 1; i < NUMS; i += 2)
+    {
+        if(t.contains(i))
+            cout << "Find error2: " << i << endl;
+    }
+
+    // 叶子链表的顺序
+    int expect = 2;
+    for(auto it = t.begin(); it != t.end(); ++it, expect += 2)
+        if(*it != expect)
+            cout << "Iterator error: " << *it << endl;
+    if(expect != NUMS)
+        cout << "Iterator count error: " << expect << endl;
+
+    Tree t2;
+    t2 = t;
+
+    for(i = 2; i < NUMS; i += 2)
+        if(!t2.contains(i))
+            cout << "Find error1: " << i << endl;
+
+    for(i = 1; i < NUMS; i += 2)
+    {
+        if(t2.contains(i))
+            cout << "Find error2: " << i << endl;
+    }
+
+    // 删光之后树为空
+    for(i = 2; i < NUMS; i += 2)
+        t.remove(i);
+    if(!t.empty() || t.size() != 0)
+        cout << "Remove all error!" << endl;
+    for(i = 0; i < NUMS; ++i)
+        t.insert(i);
+    for(i = NUMS - 1; i >= 0; --i)
+        t.remove(i);
+    if(!t.empty())
+        cout << "Remove reverse error!" << endl;
+}
+
+int main()
+{
+    cout << "Checking... (no more output means success)" << endl;
+
+    testSet<BPlusTree<int>>(20000);
+    testSet<SmallTree>(20000);
+
+    // 范围查询
+    SmallTree r;
+    for(int i = 0; i < 1000; i += 3)
+        r.insert(i);
+    if(*r.lowerBound(10) != 12 || *r.lowerBound(12) != 12 || *r.upperBound(12) != 15)
+        cout << "Bound error!" << endl;
+    if(r.lowerBound(1000) != r.end() || *r.lowerBound(-5) != 0)
+        cout << "Bound end error!" << endl;
+    int sum = 0, count = 0;
+    r.forEachInRange(100, 200, [&](int x) { sum += x; ++count; });
+    if(count != 33 || sum != (102 + 198) * 33 / 2)
+        cout << "Range error: " << count << " " << sum << endl;
+
+    // 批量建树
+    vector<int> sorted;
+    for(int i = 0; i < 100000; ++i)
+        sorted.push_back(2 * i);
+    SmallTree b;
+    b.buildFromSorted(sorted);
+    if(b.size() != sorted.size() || b.findMin() != 0 || b.findMax() != 199998)
+        cout << "Bulk-load error!" << endl;
+    for(int i = 0; i < 200000; ++i)
+        if(b.contains(i) != (i % 2 == 0))
+            cout << "Bulk-load find error: " << i << endl;
+    for(int i = 1; i < 200000; i += 4)
+        b.insert(i);
+    for(int i = 0; i < 200000; i += 4)
+        b.remove(i);
+    for(int i = 0; i < 200000; ++i)
+        if(b.contains(i) != (i % 4 == 1 || i % 4 == 2))
+            cout << "Bulk-load update error: " << i << endl;
+
+    bool thrown = false;
+    try
+    {
+        sorted.push_back(0);
+        b.buildFromSorted(sorted);
+    } catch(const DS::IllegalArgumentException&)
+    {
+        thrown = true;
+    }
+    if(!thrown)
+        cout << "Unsorted input error!" << endl;
+
+    // 映射
+    BPlusTree<int, string> m;
+    for(int i = 0; i < 1000; ++i)
+        m.insert(i, to_string(i));
+    if(m.insert(5, "five") || *m.find(5) != "5")
+        cout << "Map insert error!" << endl;
+    *m.find(5) = "five";
+    m.remove(6);
+    if(*m.find(5) != "five" || m.find(6) != nullptr || m.lowerBound(6).value() != "7")
+        cout << "Map find error!" << endl;
+
+    cout << "End of test..." << endl;
+    return 0;
+}
@@ -0,0 +1,423 @@
+// 紧凑的平衡树
+
+#ifndef __COMPACT_AVL_TREE_HPP__
+#define __COMPACT_AVL_TREE_HPP__
+
+#include "../lib/dsexceptions.h"
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Compact AVL Tree ADT
+// 高吞吐量的AVL树，与AVLTree的区别:
+// 1. 节点放在树自己的数组(slab)中，儿子用32位下标代替指针，删除的节点进入空闲链表
+// 2. 不存高度，只存平衡因子 height(right) - height(left)，用两个下标的最高位表示(共2位)
+//    int元素的节点为12字节，AVLTree为32字节
+// 3. 插入删除不递归，下降时把路径记在固定大小的栈中，回溯时高度不再变化就立即停止
+//
+// ******************PUBLIC OPERATIONS*********************
+// void insert( x )       --> Insert x
+// void remove( x )       --> Remove x
+// bool contains( x )     --> Return true if x is present
+// Object findMin( )      --> Return smallest item
+// Object findMax( )      --> Return largest item
+// bool empty( )          --> Return true if empty; else false
+// size_t size( )         --> Return the number of items
+// void clear( )          --> Remove all items, O(1)
+// void reserve( n )      --> Reserve space for n nodes
+// void printTree( )      --> Print tree in sorted order
+// int height()           --> the height of the tree
+// ******************ERRORS********************************
+// Throws UnderflowException as warranted
+// Throws IllegalArgumentException if more than 2^31 - 1 nodes are allocated
+
+namespace DS
+{
+    template <typename Object>
+    class CompactAVLTree
+    {
+    private:
+        typedef uint32_t Index;
+
+        static const Index NIL = 0x7fffffff; // 空儿子
+        static const Index INDEX_MASK = 0x7fffffff;
+        static const Index TALL_BIT = 0x80000000; // 这一侧的子树更高
+        static const int MAX_DEPTH = 64; // 2^31个节点的AVL树高度不超过45
+
+        class TreeNode
+        {
+        public:
+            Object element_;
+            Index left_; // 最高位: 左子树更高
+            Index right_; // 最高位: 右子树更高
+
+            explicit TreeNode(const Object& element)
+            : element_{element}, left_{NIL}, right_{NIL}
+            {}
+
+            explicit TreeNode(Object&& element)
+            : element_{std::move(element)}, left_{NIL}, right_{NIL}
+            {}
+        };
+
+        std::vector<TreeNode> nodes_;
+        Index root_;
+        Index free_; // 空闲链表，通过left_连接
+        std::size_t size_;
+
+        Index left(Index n) const
+        { return nodes_[n].left_ & INDEX_MASK; }
+
+        Index right(Index n) const
+        { return nodes_[n].right_ & INDEX_MASK; }
+
+        Index child(Index n, int dir) const
+        { return dir ? right(n) : left(n); }
+
+        void setLeft(Index n, Index c)
+        { nodes_[n].left_ = (nodes_[n].left_ & TALL_BIT) | c; }
+
+        void setRight(Index n, Index c)
+        { nodes_[n].right_ = (nodes_[n].right_ & TALL_BIT) | c; }
+
+        void setChild(Index n, int dir, Index c)
+        {
+            if(dir)
+                setRight(n, c);
+            else
+                setLeft(n, c);
+        }
+
+        // 平衡因子 -1, 0, +1
+        int balanceOf(Index n) const
+        { return static_cast<int>(nodes_[n].right_ >> 31) - static_cast<int>(nodes_[n].left_ >> 31); }
+
+        void setBalance(Index n, int b)
+        {
+            nodes_[n].left_ = (nodes_[n].left_ & INDEX_MASK) | (b < 0 ? TALL_BIT : 0);
+            nodes_[n].right_ = (nodes_[n].right_ & INDEX_MASK) | (b > 0 ? TALL_BIT : 0);
+        }
+
+        template <typename X>
+        Index newNode(X&& x)
+        {
+            Index n;
+            if(free_ != NIL)
+            {
+                n = free_;
+                free_ = nodes_[n].left_;
+                nodes_[n].element_ = std::forward<X>(x);
+                nodes_[n].left_ = nodes_[n].right_ = NIL;
+            } else
+            {
+                if(nodes_.size() >= NIL)
+                    throw IllegalArgumentException{};
+                n = static_cast<Index>(nodes_.size());
+                nodes_.push_back(TreeNode(std::forward<X>(x)));
+            }
+            return n;
+        }
+
+        void freeNode(Index n)
+        {
+            nodes_[n].left_ = free_;
+            free_ = n;
+        }
+
+        // 以n为根的子树向dir的反方向旋转，dir一侧高2，返回新的根
+        // 单旋转时如果儿子原来平衡(只在删除中出现)，子树高度不变，shorter置为false
+        Index rotate(Index n, int dir, bool& shorter)
+        {
+            Index c = child(n, dir);
+            int sign = dir ? 1 : -1; // dir一侧更高时的平衡因子符号
+            int bc = balanceOf(c);
+            if(bc != -sign) // 单旋转
+            {
+                setChild(n, dir, child(c, !dir));
+                setChild(c, !dir, n);
+                if(bc == 0)
+                {
+                    setBalance(n, sign);
+                    setBalance(c, -sign);
+                    shorter = false;
+                } else
+                {
+                    setBalance(n, 0);
+                    setBalance(c, 0);
+                    shorter = true;
+                }
+                return c;
+            }
+            // 双旋转，孙子g成为新的根
+            Index g = child(c, !dir);
+            int bg = balanceOf(g);
+            setChild(n, dir, child(g, !dir));
+            setChild(c, !dir, child(g, dir));
+            setChild(g, !dir, n);
+            setChild(g, dir, c);
+            setBalance(n, bg == sign ? -sign : 0);
+            setBalance(c, bg == -sign ? sign : 0);
+            setBalance(g, 0);
+            shorter = true;
+            return g;
+        }
+
+        // 旋转后新的子树根挂到路径上的父节点
+        void relink(const Index* path, const int* dirs, int i, Index sub)
+        {
+            if(i == 0)
+                root_ = sub;
+            else
+                setChild(path[i - 1], dirs[i - 1], sub);
+        }
+
+        template <typename X>
+        void insertProcess(X&& x)
+        {
+            Index path[MAX_DEPTH];
+            int dirs[MAX_DEPTH];
+            int depth = 0;
+            Index n = root_;
+            while(n != NIL)
+            {
+                int dir;
+                if(x < nodes_[n].element_)
+                    dir = 0;
+                else if(nodes_[n].element_ < x)
+                    dir = 1;
+                else
+                    return; // 重复元素
+                path[depth] = n;
+                dirs[depth++] = dir;
+                n = child(n, dir);
+            }
+            Index added = newNode(std::forward<X>(x));
+            ++size_;
+            if(depth == 0)
+            {
+                root_ = added;
+                return;
+            }
+            setChild(path[depth - 1], dirs[depth - 1], added);
+
+            // 回溯: dirs[i]一侧的子树高度加一
+            for(int i = depth - 1; i >= 0; --i)
+            {
+                Index p = path[i];
+                int sign = dirs[i] ? 1 : -1;
+                int b = balanceOf(p) + sign;
+                if(b == 0) // 较矮的一侧长高，高度不变
+                {
+                    setBalance(p, 0);
+                    return;
+                }
+                if(b == sign) // 原来平衡，高度加一，继续向上
+                {
+                    setBalance(p, b);
+                    continue;
+                }
+                // 失衡，旋转后高度恢复到插入之前
+                bool shorter;
+                relink(path, dirs, i, rotate(p, dirs[i], shorter));
+                return;
+            }
+        }
+
+        void removeProcess(const Object& x)
+        {
+            Index path[MAX_DEPTH];
+            int dirs[MAX_DEPTH];
+            int depth = 0;
+            Index n = root_;
+            while(n != NIL)
+            {
+                int dir;
+                if(x < nodes_[n].element_)
+                    dir = 0;
+                else if(nodes_[n].element_ < x)
+                    dir = 1;
+                else
+                    break;
+                path[depth] = n;
+                dirs[depth++] = dir;
+                n = child(n, dir);
+            }
+            if(n == NIL)
+                return;
+
+            // 左右均非空时，用右子树的最小节点代替，改为删除那个节点
+            if(left(n) != NIL && right(n) != NIL)
+            {
+                Index target = n;
+                path[depth] = n;
+                dirs[depth++] = 1;
+                n = right(n);
+                while(left(n) != NIL)
+                {
+                    path[depth] = n;
+                    dirs[depth++] = 0;
+                    n = left(n);
+                }
+                nodes_[target].element_ = std::move(nodes_[n].element_);
+            }
+            Index replace = left(n) != NIL ? left(n) : right(n);
+            if(depth == 0)
+                root_ = replace;
+            else
+                setChild(path[depth - 1], dirs[depth - 1], replace);
+            freeNode(n);
+            --size_;
+
+            // 回溯: dirs[i]一侧的子树高度减一
+            for(int i = depth - 1; i >= 0; --i)
+            {
+                Index p = path[i];
+                int sign = dirs[i] ? 1 : -1;
+                int b = balanceOf(p) - sign;
+                if(b == -sign) // 原来平衡，高度不变
+                {
+                    setBalance(p, b);
+                    return;
+                }
+                if(b == 0) // 较高的一侧变矮，高度减一，继续向上
+                {
+                    setBalance(p, 0);
+                    continue;
+                }
+                // 另一侧高2，向这一侧旋转
+                bool shorter;
+                relink(path, dirs, i, rotate(p, !dirs[i], shorter));
+                if(!shorter)
+                    return;
+            }
+        }
+
+        void printTreeProcess(Index n, std::ostream& out, bool reverse) const
+        {
+            if(n == NIL)
+                return;
+            printTreeProcess(reverse ? right(n) : left(n), out, reverse);
+            out << nodes_[n].element_ << std::endl;
+            printTreeProcess(reverse ? left(n) : right(n), out, reverse);
+        }
+
+    public:
+        CompactAVLTree()
+        : root_{NIL}, free_{NIL}, size_{0}
+        {}
+
+        // 下标与指针不同，复制数组即得到一棵完整的树
+        CompactAVLTree(const CompactAVLTree& rhs) = default;
+
+        CompactAVLTree(CompactAVLTree&& rhs) noexcept
+        : nodes_{std::move(rhs.nodes_)}, root_{rhs.root_}, free_{rhs.free_}, size_{rhs.size_}
+        { rhs.clear(); }
+
+        CompactAVLTree& operator=(const CompactAVLTree& rhs) = default;
+
+        CompactAVLTree& operator=(CompactAVLTree&& rhs) noexcept
+        {
+            nodes_.swap(rhs.nodes_);
+            std::swap(root_, rhs.root_);
+            std::swap(free_, rhs.free_);
+            std::swap(size_, rhs.size_);
+            return *this;
+        }
+
+        bool empty() const
+        { return root_ == NIL; }
+
+        std::size_t size() const
+        { return size_; }
+
+        bool contains(const Object& x) const
+        {
+            Index n = root_;
+            while(n != NIL)
+            {
+                const Object& e = nodes_[n].element_;
+                if(x < e)
+                    n = left(n);
+                else if(e < x)
+                    n = right(n);
+                else
+                    return true;
+            }
+            return false;
+        }
+
+        const Object& findMin() const
+        {
+            if(empty())
+                throw UnderflowException{};
+            Index n = root_;
+            while(left(n) != NIL)
+                n = left(n);
+            return nodes_[n].element_;
+        }
+
+        const Object& findMax() const
+        {
+            if(empty())
+                throw UnderflowException{};
+            Index n = root_;
+            while(right(n) != NIL)
+                n = right(n);
+            return nodes_[n].element_;
+        }
+
+        // 沿较高的一侧下降
+        int height() const
+        {
+            int h = -1;
+            for(Index n = root_; n != NIL; ++h)
+                n = balanceOf(n) < 0 ? left(n) : right(n);
+            return h;
+        }
+
+        void printTree(std::ostream& out = std::cout, bool reverse = false) const
+        {
+            if(empty())
+                out << "Empty tree" << std::endl;
+            else
+                printTreeProcess(root_, out, reverse);
+        }
+
+        // 节点数组保留容量，不逐个释放
+        void clear()
+        {
+            nodes_.clear();
+            root_ = free_ = NIL;
+            size_ = 0;
+        }
+
+        void reserve(std::size_t n)
+        { nodes_.reserve(n); }
+
+        // 插入，重复项不考虑
+        void insert(const Object& x)
+        { insertProcess(x); }
+
+        void insert(Object&& x)
+        { insertProcess(std::move(x)); }
+
+        // 删除x，存在则删除，不存在则不进行操作
+        void remove(const Object& x)
+        { removeProcess(x); }
+    };
+
+    template <typename Object>
+    const uint32_t CompactAVLTree<Object>::NIL;
+
+    template <typename Object>
+    const uint32_t CompactAVLTree<Object>::INDEX_MASK;
+
+    template <typename Object>
+    const uint32_t CompactAVLTree<Object>::TALL_BIT;
+
+    template <typename Object>
+    const int CompactAVLTree<Object>::MAX_DEPTH;
+}
+
+#endif //__COMPACT_AVL_TREE_HPP__
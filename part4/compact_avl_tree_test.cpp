@@ -0,0 +1,69 @@
+#include <iostream>
+#include "compact_avl_tree.hpp"
+using namespace std;
+using DS::CompactAVLTree;
+
+// Test program
+int main()
+{
+    CompactAVLTree<int> t;
+    int NUMS = 20000;
+    const int GAP = 37;
+    int i;
+
+    cout << "Checking... (no more output means success)" << endl;
+
+    for(i = GAP; i != 0; i = (i + GAP) % NUMS)
+        t.insert(i);
+    t.remove(0);
+    for(i = 1; i < NUMS; i += 2)
+        t.remove(i);
+
+    if(NUMS < 40)
+        t.printTree();
+    if(t.findMin() != 2 || t.findMax() != NUMS - 2)
+        cout << "FindMin or FindMax error!" << endl;
+
+    for(i = 2; i < NUMS; i += 2)
+        if(!t.contains(i))
+            cout << "Find error1: " << i << endl;
+
+    for(i = 1; i < NUMS; i += 2)
+    {
+        if(t.contains(i))
+            cout << "Find error2: " << i << endl;
+    }
+
+    CompactAVLTree<int> t2;
+    t2 = t;
+
+    for(i = 2; i < NUMS; i += 2)
+        if(!t2.contains(i))
+            cout << "Find error1: " << i << endl;
+
+    for(i = 1; i < NUMS; i += 2)
+    {
+        if(t2.contains(i))
+            cout << "Find error2: " << i << endl;
+    }
+
+    // 删光之后重新插入，复用空闲链表中的节点
+    for(i = 2; i < NUMS; i += 2)
+        t.remove(i);
+    if(!t.empty() || t.size() != 0)
+        cout << "Remove all error!" << endl;
+    for(i = 0; i < NUMS; ++i)
+        t.insert(i);
+    if(t.size() != static_cast<size_t>(NUMS) || t.height() > 20)
+        cout << "Reinsert error: " << t.height() << endl;
+    for(i = 0; i < NUMS; ++i)
+        if(!t.contains(i))
+            cout << "Find error3: " << i << endl;
+    t.clear();
+    if(!t.empty() || t.contains(0))
+        cout << "Clear error!" << endl;
+
+    cout << "End of test..." << endl;
+    return 0;
+}
+
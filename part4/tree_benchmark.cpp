@@ -0,0 +1,213 @@
+// 各种有序集合的性能对比
+// BinarySearchTree / AVLTree / CompactAVLTree / SplayTree / RedBlackTree / Treap / BPlusTree / std::set
+// 对同样的随机关键字依次测量(百万次操作每秒):
+//   insert   逐个插入
+//   find     随机查找，一半命中
+//   scan     范围查询的总时间，只有BPlusTree和std::set支持
+//   remove   逐个删除
+// SplayTree (semi) 只在访问深度超过SPLAY_DEPTH时伸展
+// BPlusTree另外测量由有序序列批量建树(bulk-load)
+//
+// 用法: tree_benchmark [n] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstdlib>
+#include "binary_search_tree.hpp"
+#include "avl_tree.hpp"
+#include "compact_avl_tree.hpp"
+#include "bplus_tree.hpp"
+#include "../part11/splay_tree.hpp"
+#include "../part12/rb_tree.hpp"
+#include "../part12/treap.hpp"
+#include "../lib/uniform_random.h"
+
+const int N_SCANS = 1000;
+const int SCAN_WIDTH = 1 << 22; // 每次范围查询的关键字区间宽度
+const int SPLAY_DEPTH = 24;
+
+// std::set 适配到 insert/remove/contains 接口
+class StdSet
+{
+public:
+    void insert(int x)
+    { set_.insert(x); }
+
+    void remove(int x)
+    { set_.erase(x); }
+
+    bool contains(int x) const
+    { return set_.count(x) != 0; }
+
+    template <typename Function>
+    void forEachInRange(int lo, int hi, Function fn) const
+    {
+        for(auto it = set_.lower_bound(lo); it != set_.end() && *it <= hi; ++it)
+            fn(*it);
+    }
+
+private:
+    std::set<int> set_;
+};
+
+class SemiSplayTree : public DS::SplayTree<int>
+{
+public:
+    SemiSplayTree()
+    : DS::SplayTree<int>(SPLAY_DEPTH)
+    {}
+};
+
+struct Workload
+{
+    std::vector<int> keys; // 插入和删除的顺序
+    std::vector<int> queries; // 查找，一半在树中
+    std::vector<int> scan_starts;
+};
+
+Workload makeWorkload(std::size_t n, int seed)
+{
+    DS::UniformRandom r(seed);
+    Workload w;
+    std::set<int> used;
+    while(w.keys.size() < n)
+    {
+        int x = r.nextInt(0, 0x3fffffff);
+        if(used.insert(x).second)
+            w.keys.push_back(x);
+    }
+    for(std::size_t i = 0; i < n; ++i)
+        w.queries.push_back(i % 2 ? w.keys[r.nextInt(0, static_cast<int>(n) - 1)] : r.nextInt(0, 0x3fffffff));
+    for(int i = 0; i < N_SCANS; ++i)
+        w.scan_starts.push_back(r.nextInt(0, 0x3fffffff - SCAN_WIDTH));
+    return w;
+}
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template <typename Tree>
+uint64_t scan(const Tree& t, const Workload& w, std::true_type)
+{
+    uint64_t checksum = 0;
+    for(int lo : w.scan_starts)
+        t.forEachInRange(lo, lo + SCAN_WIDTH, [&](int x) { checksum += static_cast<uint32_t>(x); });
+    return checksum;
+}
+
+template <typename Tree>
+uint64_t scan(const Tree&, const Workload&, std::false_type)
+{ return 0; }
+
+void printRate(double sec, std::size_t n_ops)
+{
+    std::cout << std::setw(10) << std::fixed << std::setprecision(2) << n_ops / sec / 1e6;
+}
+
+struct Expect
+{
+    uint64_t found;
+    uint64_t scanned;
+};
+
+template <typename Tree, bool CAN_SCAN>
+void bench(const std::string& name, const Workload& w, Expect& expect)
+{
+    Tree* t = new Tree;
+    uint64_t found = 0;
+    uint64_t scanned = 0;
+    double t_insert = seconds([&]() {
+        for(int x : w.keys)
+            t->insert(x);
+    });
+    double t_find = seconds([&]() {
+        for(int x : w.queries)
+            found += t->contains(x);
+    });
+    double t_scan = seconds([&]() {
+        scanned = scan(*t, w, std::integral_constant<bool, CAN_SCAN>());
+    });
+    double t_remove = seconds([&]() {
+        for(int x : w.keys)
+            t->remove(x);
+    });
+    delete t;
+
+    bool ok = found == expect.found && (!CAN_SCAN || scanned == expect.scanned);
+    std::cout << "  " << std::left << std::setw(18) << name << std::right;
+    printRate(t_insert, w.keys.size());
+    printRate(t_find, w.queries.size());
+    if(CAN_SCAN)
+        std::cout << std::setw(8) << std::fixed << std::setprecision(1) << t_scan * 1000 << " ms";
+    else
+        std::cout << std::setw(11) << "-";
+    printRate(t_remove, w.keys.size());
+    std::cout << (ok ? "" : "  MISMATCH!") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000000;
+    int seed = argc > 2 ? atoi(argv[2]) : 1;
+    if(n < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [n >= 1] [seed]" << std::endl;
+        return 1;
+    }
+
+    Workload w = makeWorkload(n, seed);
+    Expect expect;
+    {
+        StdSet reference;
+        for(int x : w.keys)
+            reference.insert(x);
+        expect.found = 0;
+        for(int x : w.queries)
+            expect.found += reference.contains(x);
+        expect.scanned = scan(reference, w, std::true_type());
+    }
+
+    std::cout << n << " random keys (M ops/s, scan: " << N_SCANS << " range queries)" << std::endl;
+    std::cout << "  " << std::left << std::setw(18) << "" << std::right
+              << std::setw(10) << "insert" << std::setw(10) << "find"
+              << std::setw(11) << "scan" << std::setw(10) << "remove" << std::endl;
+    bench<DS::BinarySearchTree<int>, false>("BinarySearchTree", w, expect);
+    bench<DS::AVLTree<int>, false>("AVLTree", w, expect);
+    bench<DS::CompactAVLTree<int>, false>("CompactAVLTree", w, expect);
+    bench<DS::SplayTree<int>, false>("SplayTree", w, expect);
+    bench<SemiSplayTree, false>("SplayTree (semi)", w, expect);
+    bench<DS::RedBlackTree<int>, false>("RedBlackTree", w, expect);
+    bench<DS::Treap<int>, false>("Treap", w, expect);
+    bench<StdSet, true>("std::set", w, expect);
+    bench<DS::BPlusTree<int>, true>("BPlusTree", w, expect);
+    bench<DS::BPlusTree<int, DS::BPlusSetTag, 64>, true>("BPlusTree (64B)", w, expect);
+    bench<DS::BPlusTree<int, DS::BPlusSetTag, 1024>, true>("BPlusTree (1KB)", w, expect);
+
+    // 批量建树与逐个插入有序序列
+    std::vector<int> sorted(w.keys);
+    std::sort(sorted.begin(), sorted.end());
+    DS::BPlusTree<int> bulk;
+    double t_bulk = seconds([&]() { bulk.buildFromSorted(sorted); });
+    DS::BPlusTree<int> one_by_one;
+    double t_sorted = seconds([&]() {
+        for(int x : sorted)
+            one_by_one.insert(x);
+    });
+    std::cout << "BPlusTree from sorted input: bulk-load " << std::fixed << std::setprecision(1)
+              << t_bulk * 1000 << " ms (height " << bulk.height() << "), insert one by one "
+              << t_sorted * 1000 << " ms (height " << one_by_one.height() << ")" << std::endl;
+    return 0;
+}
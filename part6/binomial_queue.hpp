@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <vector>
+#include <cstdint>
 #include "../lib/dsexceptions.h"
 
 // Binomial queue class
@@ -18,6 +19,11 @@
 // void merge( rhs )      --> Absorb rhs into this heap
 // ******************ERRORS********************************
 // Throws UnderflowException as warranted
+//
+// 实现说明:
+// 节点存放在连续的节点池nodes_中，用32位下标代替指针，弹出的节点挂到空闲链表复用
+// mask_ 第i位为1表示秩为i的二项树存在，合并时用ctz跳过空的秩，只在有树的位置做进位
+// top_rank_ 缓存最小根所在的秩，top()为O(1)
 
 namespace DS
 {
@@ -37,49 +43,42 @@ namespace DS
     {
     public:
         explicit BinomialQueue(const Compare& comp = Compare())
-        : trees_(DEFAULT_TREES), size_{0}, compare_{comp}
-        {
-            for(auto& root : trees_)
-                root = nullptr;
-        }
+        : free_{NIL}, mask_{0}, top_rank_{0}, size_{0}, compare_{comp}
+        {}
 
         explicit BinomialQueue(const Object& item, const Compare& comp = Compare())
-        : trees_(1), size_{1}, compare_{comp}
-        {
-            trees_[0] = new BinomialNode(item, nullptr, nullptr);
-        }
+        : BinomialQueue(comp)
+        { insert(item); }
 
         explicit BinomialQueue(Object&& item, const Compare& comp = Compare())
-        : trees_(1), size_{1}, compare_{comp}
-        {
-            trees_[0] = new BinomialNode(std::move(item), nullptr, nullptr);
-        }
+        : BinomialQueue(comp)
+        { insert(std::move(item)); }
 
-        BinomialQueue(const BinomialQueue& rhs)
-        : trees_(rhs.trees_.size(), nullptr), size_{rhs.size_}, compare_{rhs.compare_}
-        {
-            for(int i = 0; i < rhs.trees_.size(); ++i)
-                clone(trees_[i], rhs.trees_[i]);
-        }
+        // 节点之间用下标相连，节点池直接拷贝即可
+        BinomialQueue(const BinomialQueue& rhs) = default;
 
         BinomialQueue(BinomialQueue&& rhs) noexcept
-        : trees_{std::move(rhs.trees_)}, size_{rhs.size_}, compare_{std::move(rhs.compare_)}
-        {}
+        : nodes_{std::move(rhs.nodes_)}, free_{rhs.free_}, mask_{rhs.mask_},
+          top_rank_{rhs.top_rank_}, size_{rhs.size_}, compare_{std::move(rhs.compare_)}
+        {
+            for(int i = 0; i < MAX_TREES; ++i)
+                trees_[i] = rhs.trees_[i];
+            rhs.reset();
+        }
 
-        ~BinomialQueue() noexcept
-        { clear(); }
+        ~BinomialQueue() noexcept = default;
 
         BinomialQueue& operator=(const BinomialQueue& rhs)
         {
             BinomialQueue copy(rhs);
-            std::swap(*this, copy);
+            swapContents(copy);
+            std::swap(compare_, copy.compare_);
             return *this;
         }
 
         BinomialQueue& operator=(BinomialQueue&& rhs) noexcept
         {
-            std::swap(size_, rhs.size_);
-            std::swap(trees_, rhs.trees_);
+            swapContents(rhs);
             std::swap(compare_, rhs.compare_);
             return *this;
         }
@@ -92,214 +91,282 @@ namespace DS
 
         void clear()
         {
-            size_ = 0;
-            for(auto& root : trees_)
-                clear(root);
+            nodes_.clear();
+            reset();
         }
 
         const Object& top() const
         {
             if(empty())
                 throw UnderflowException{};
-            return trees_[findTopIndex()]->element_;
+            return nodes_[trees_[top_rank_]].element_;
         }
 
         // 允许重复
-        // 插入即为特殊的合并
+        // 插入即为秩0的树与当前队列合并
         void insert(const Object& x)
-        {
-            BinomialQueue new_tree(x, compare_);
-            merge(new_tree);
-        }
+        { insertNode(allocate(x)); }
 
         void insert(Object&& x)
-        {
-            BinomialQueue new_tree(std::move(x), compare_);
-            merge(new_tree);
-        }
+        { insertNode(allocate(std::move(x))); }
 
         void pop()
         {
-            Object item;
-            pop(item);
+            if(empty())
+                throw UnderflowException{};
+            removeTop();
         }
 
         void pop(Object& item)
         {
             if(empty())
                 throw UnderflowException{};
-            int top_id = findTopIndex(); // 找到待删除的节点id
-            item = trees_[top_id]->element_;
-            BinomialNode* old = trees_[top_id];
-            BinomialNode* rest_tree = old->first_child_;
-
-            delete old; // 删除根
-            // 构造树H''
-            BinomialQueue rest_queue(compare_);
-            rest_queue.trees_.resize(top_id);
-            rest_queue.size_ = (1 << top_id) - 1;
-            for(int j = top_id - 1; j >= 0; --j)
-            {
-                rest_queue.trees_[j] = rest_tree;
-                rest_tree = rest_tree->next_sibling_;
-                rest_queue.trees_[j]->next_sibling_ = nullptr;
-            }
-            // 将当前树this构造成H'
-            trees_[top_id] = nullptr;
-            size_ -= rest_queue.size_ + 1;
-
-            // 合并h' h''
-            merge(rest_queue);
+            item = std::move(nodes_[trees_[top_rank_]].element_);
+            removeTop();
         }
 
         // 合并
+        // 两个队列的节点池不同，需要把较小队列的节点搬入较大队列的节点池(优先复用空闲节点)
+        // 代价为O(min(n1, n2))，之后的进位只访问mask中存在树的秩
         void merge(BinomialQueue& rhs)
         {
-            if(this == &rhs)
+            if(this == &rhs || rhs.empty())
                 return;
-            size_ += rhs.size_;
-
-            if(size_ > capacity()) // 表扩张
-            {
-                int old_n_trees = trees_.size();
-                // 新的表长=合并项中表长大者+1
-                int new_n_trees = std::max(trees_.size(), rhs.trees_.size()) + 1;
-                trees_.resize(new_n_trees);
-                for(int i = old_n_trees; i < new_n_trees; ++i)
-                {
-                    trees_[i] = nullptr; // 新的表节点初始化nullptr
-                }
-            }
-
-            BinomialNode* carry = nullptr; // 从循环上一步得到的树
-            BinomialNode* t1 = nullptr;
-            BinomialNode* t2 = nullptr;
-            for(int i = 0, j = 1; j <= size_; ++i, j *= 2)
-            {
-                // 用i遍历每棵树
-                t1 = trees_[i];
-                t2 = i < rhs.trees_.size() ? rhs.trees_[i] : nullptr;
+            if(size_ < rhs.size_)
+                swapContents(rhs); // 让节点多的一方作为合并结果的节点池
 
-                int which_case = t1 == nullptr ? 0 : 1;
-                which_case += t2 == nullptr ? 0 : 2;
-                which_case += carry == nullptr ? 0 : 4;
-
-                if(which_case < 2)
-                    continue;
+            uint32_t rhs_trees[MAX_TREES];
+            uint32_t rhs_mask = rhs.mask_;
+            importTrees(rhs, rhs_trees);
+            size_ += rhs.size_;
+            mergeRoots(rhs_trees, rhs_mask);
+            findTopRank();
 
-                switch(which_case)
-                {
-                    // case 0, 1 do nothing
-                    // case 0: // no trees
-                    // case 1: // only this
-                    case 2: /* Only rhs */
-                        trees_[i] = t2;
-                        rhs.trees_[i] = nullptr;
-                        break;
-                    case 4: /* Only carry */
-                        trees_[i] = carry;
-                        carry = nullptr;
-                        break;
-                    case 3: /* this and rhs */
-                        carry = combineTrees(t1, t2);
-                        trees_[i] = rhs.trees_[i] = nullptr;
-                        break;
-                    case 5: /* this and carry */
-                        carry = combineTrees(t1, carry);
-                        trees_[i] = nullptr;
-                        break;
-                    case 6: /* rhs and carry */
-                        carry = combineTrees(t2, carry);
-                        rhs.trees_[i] = nullptr;
-                        break;
-                    case 7: /* All three */
-                        trees_[i] = carry;
-                        carry = combineTrees(t1, t2);
-                        rhs.trees_[i] = nullptr;
-                        break;
-                    default:
-                        break;
-                }
-            }
-            // 消除rhs
-            for(auto& root : rhs.trees_)
-                root = nullptr;
-            rhs.size_ = 0;
+            rhs.clear();
         }
 
-
     private:
         class BinomialNode
         {
         public:
             Object element_;
-            BinomialNode* first_child_;
-            BinomialNode* next_sibling_; // 二项队列中的树不是二叉树，所有用孩子兄弟法表示
+            uint32_t first_child_;
+            uint32_t next_sibling_; // 二项队列中的树不是二叉树，所有用孩子兄弟法表示，空闲节点用它串成空闲链表
 
-            explicit BinomialNode(const Object& e, BinomialNode* lt = nullptr, BinomialNode* rt = nullptr)
+            explicit BinomialNode(const Object& e, uint32_t lt = NIL, uint32_t rt = NIL)
             : element_{e}, first_child_{lt}, next_sibling_{rt}
             {}
 
-            explicit BinomialNode(Object&& e, BinomialNode* lt = nullptr, BinomialNode* rt = nullptr)
+            explicit BinomialNode(Object&& e, uint32_t lt = NIL, uint32_t rt = NIL)
             : element_{std::move(e)}, first_child_{lt}, next_sibling_{rt}
             {}
         };
 
-        const static int DEFAULT_TREES = 1;
+        const static uint32_t NIL = 0xffffffffu; // 空下标
+        const static int MAX_TREES = 32; // size_为int，秩不会超过31
 
-        std::vector<BinomialNode*> trees_; // 二项树列表
+        std::vector<BinomialNode> nodes_; // 节点池
+        uint32_t trees_[MAX_TREES]; // 二项树列表，只有mask_中置位的秩有效
+        uint32_t free_; // 空闲链表头
+        uint32_t mask_; // 二项树占用位图
+        int top_rank_; // 最小根所在的秩
         int size_; // 记录队列中项数
         Compare compare_; // 比较函数
 
-        int findTopIndex() const
+        static int lowestBit(uint32_t m)
+        { return __builtin_ctz(m); }
+
+        void reset()
+        {
+            free_ = NIL;
+            mask_ = 0;
+            top_rank_ = 0;
+            size_ = 0;
+        }
+
+        void swapContents(BinomialQueue& rhs)
         {
-            int i;
-            int top_id;
-            for(i = 0; trees_[i] == nullptr; ++i) // 找到树表中第一个不为null的根
-                ;
-            for(top_id = i; i < trees_.size(); ++i)
+            std::swap(nodes_, rhs.nodes_);
+            std::swap(trees_, rhs.trees_);
+            std::swap(free_, rhs.free_);
+            std::swap(mask_, rhs.mask_);
+            std::swap(top_rank_, rhs.top_rank_);
+            std::swap(size_, rhs.size_);
+        }
+
+        template <typename T>
+        uint32_t allocate(T&& x)
+        {
+            if(free_ != NIL)
             {
-                if(trees_[i] != nullptr && compare_(trees_[i]->element_, trees_[top_id]->element_))
-                    top_id = i;
+                uint32_t id = free_;
+                free_ = nodes_[id].next_sibling_;
+                nodes_[id].element_ = std::forward<T>(x);
+                nodes_[id].first_child_ = NIL;
+                nodes_[id].next_sibling_ = NIL;
+                return id;
             }
-            return top_id;
+            nodes_.emplace_back(std::forward<T>(x));
+            return static_cast<uint32_t>(nodes_.size() - 1);
         }
 
-        // 返回二项队列的容量 2^k - 1, k = 队列长度
-        int capacity() const
-        { return (1 << trees_.size()) - 1;}
+        void release(uint32_t id)
+        {
+            nodes_[id].next_sibling_ = free_;
+            free_ = id;
+        }
 
-        void clear(BinomialNode*& node)
+        // 把rhs中的所有树搬入本节点池，新的根下标写入trees
+        // 先按深度优先顺序逐个分配节点并记录新下标，再改写孩子兄弟链接
+        void importTrees(BinomialQueue& rhs, uint32_t* trees)
         {
-            if(nullptr == node)
-                return;
-            BinomialNode* lt = node->first_child_;
-            BinomialNode* rt = node->next_sibling_;
-            delete node;
-            node = nullptr;
-            clear(rt);
-            clear(lt);
+            std::vector<uint32_t> order; // rhs中的节点
+            std::vector<uint32_t> remap(rhs.nodes_.size(), NIL); // rhs下标 -> 本节点池下标
+            order.reserve(rhs.size_);
+            for(uint32_t m = rhs.mask_; m != 0; m &= m - 1)
+            {
+                int rank = lowestBit(m);
+                std::size_t first = order.size();
+                order.push_back(rhs.trees_[rank]);
+                for(std::size_t i = first; i < order.size(); ++i)
+                {
+                    const BinomialNode& node = rhs.nodes_[order[i]];
+                    if(node.first_child_ != NIL)
+                        order.push_back(node.first_child_);
+                    if(node.next_sibling_ != NIL && i != first)
+                        order.push_back(node.next_sibling_);
+                }
+                for(std::size_t i = first; i < order.size(); ++i)
+                    remap[order[i]] = allocate(std::move(rhs.nodes_[order[i]].element_));
+                trees[rank] = remap[rhs.trees_[rank]];
+            }
+            for(uint32_t id : order)
+            {
+                const BinomialNode& node = rhs.nodes_[id];
+                BinomialNode& copy = nodes_[remap[id]];
+                copy.first_child_ = node.first_child_ == NIL ? NIL : remap[node.first_child_];
+                copy.next_sibling_ = node.next_sibling_ == NIL ? NIL : remap[node.next_sibling_];
+            }
         }
 
-        void clone(BinomialNode*& node, BinomialNode* rhs)
+        // 单节点插入，相当于二进制加1，进位链结束的秩为rank
+        // 如果原最小根所在的树被并入了进位链，新的最小值一定是rank上的根
+        void insertNode(uint32_t id)
         {
-            if(nullptr == rhs)
+            bool was_empty = empty();
+            ++size_;
+            int rank = 0;
+            uint32_t carry = id;
+            bool top_absorbed = false;
+            for(; mask_ & (1u << rank); ++rank)
+            {
+                if(rank == top_rank_)
+                    top_absorbed = true;
+                carry = combineTrees(trees_[rank], carry);
+                mask_ &= ~(1u << rank);
+            }
+            trees_[rank] = carry;
+            mask_ |= 1u << rank;
+
+            if(was_empty || top_absorbed
+               || compare_(nodes_[carry].element_, nodes_[trees_[top_rank_]].element_))
+                top_rank_ = rank;
+        }
+
+        // 删除最小根，它的孩子恰好是秩为top_rank_-1 ... 0的二项树
+        void removeTop()
+        {
+            int rank = top_rank_;
+            uint32_t old = trees_[rank];
+            uint32_t child = nodes_[old].first_child_;
+            uint32_t rest_trees[MAX_TREES];
+            for(int j = rank - 1; j >= 0; --j)
+            {
+                rest_trees[j] = child;
+                child = nodes_[child].next_sibling_;
+                nodes_[rest_trees[j]].next_sibling_ = NIL;
+            }
+            release(old);
+            mask_ &= ~(1u << rank);
+            --size_;
+
+            mergeRoots(rest_trees, (1u << rank) - 1);
+            findTopRank();
+        }
+
+        // 二项树按秩从低到高的带进位加法，rhs_trees中的树已经在本节点池中
+        // 只访问rhs_mask中置位的秩以及进位产生的秩
+        void mergeRoots(const uint32_t* rhs_trees, uint32_t rhs_mask)
+        {
+            uint32_t carry = NIL; // 从上一步得到的树
+            int carry_rank = 0;
+            while(rhs_mask != 0 || carry != NIL)
+            {
+                uint32_t t;
+                int rank;
+                if(carry != NIL && (rhs_mask == 0 || carry_rank < lowestBit(rhs_mask)))
+                {
+                    t = carry;
+                    rank = carry_rank;
+                    carry = NIL;
+                } else
+                {
+                    rank = lowestBit(rhs_mask);
+                    rhs_mask &= rhs_mask - 1;
+                    t = rhs_trees[rank];
+                    if(carry != NIL && carry_rank == rank)
+                    {
+                        // rhs与carry同秩，合并后向上进位，本队列该秩的树保持不动
+                        carry = combineTrees(t, carry);
+                        carry_rank = rank + 1;
+                        continue;
+                    }
+                }
+
+                if(mask_ & (1u << rank))
+                {
+                    carry = combineTrees(trees_[rank], t);
+                    carry_rank = rank + 1;
+                    mask_ &= ~(1u << rank);
+                } else
+                {
+                    trees_[rank] = t;
+                    mask_ |= 1u << rank;
+                }
+            }
+        }
+
+        // 只遍历存在的树，找到最小根
+        void findTopRank()
+        {
+            if(mask_ == 0)
+            {
+                top_rank_ = 0;
                 return;
-            node = new BinomialNode(rhs->element_, nullptr, nullptr);
-            clone(node->next_sibling_, rhs->next_sibling_);
-            clone(node->first_child_, rhs->first_child_);
+            }
+            uint32_t m = mask_;
+            top_rank_ = lowestBit(m);
+            for(m &= m - 1; m != 0; m &= m - 1)
+            {
+                int rank = lowestBit(m);
+                if(compare_(nodes_[trees_[rank]].element_, nodes_[trees_[top_rank_]].element_))
+                    top_rank_ = rank;
+            }
         }
 
         // Return the result of merging equal-sized t1 and t2.
         // 合并两棵同样大小的树
-        BinomialNode* combineTrees(BinomialNode* t1, BinomialNode* t2)
+        uint32_t combineTrees(uint32_t t1, uint32_t t2)
         {
-            if(compare_(t2->element_, t1->element_))
-                return combineTrees(t2, t1);
-            t2->next_sibling_ = t1->first_child_;
-            t1->first_child_ = t2;
+            if(compare_(nodes_[t2].element_, nodes_[t1].element_))
+                std::swap(t1, t2);
+            nodes_[t2].next_sibling_ = nodes_[t1].first_child_;
+            nodes_[t1].first_child_ = t2;
             return t1;
         }
     };
+
+    template <typename Object, class Compare>
+    const uint32_t BinomialQueue<Object, Compare>::NIL;
 }
 #endif //BINOMIAL_QUEUE_HPP
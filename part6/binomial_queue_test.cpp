@@ -38,6 +38,26 @@ int main()
     if(!h1.empty())
         cout << "Oops! h1 should have been empty!" << endl;
 
+    // 小队列并入大队列，以及交替的插入删除，检查缓存的最小根
+    BinomialQueue<int> small;
+    small.insert(-1);
+    small.insert(-2);
+    h.merge(small);
+    if(!small.empty() || h.top() != -2 || h.size() != numItems + 1)
+        cout << "Oops! merge small queue" << endl;
+    h.pop();
+    h.pop();
+    for(i = 1; i < numItems; ++i)
+    {
+        h.insert(i); // 重复元素
+        if(h.top() != i)
+            cout << "Oops! top " << i << endl;
+        h.pop();
+        h.pop();
+    }
+    if(!h.empty())
+        cout << "Oops! h should have been empty!" << endl;
+
     cout << "End of test... no output is good" << endl;
 
     return 0;
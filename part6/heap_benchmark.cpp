@@ -0,0 +1,148 @@
+// 各种优先队列在相同操作序列下的性能对比
+// trace: push-heavy / pop-heavy / mixed / merge-heavy / decreaseKey-heavy / monotone
+// 每个(堆, trace)在fork出的子进程中执行，分别统计:
+//   ops/s        每秒操作数
+//   peak RSS     子进程常驻内存峰值相对开始执行时的增量
+//   allocs       operator new 调用次数
+//   peak heap    operator new 分配的内存峰值
+// 所有堆弹出的关键字序列用校验和与std::priority_queue比较
+//
+// 用法: heap_benchmark [n_ops] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "heap_driver.hpp"
+#include "binary_heap.hpp"
+#include "left_heap.hpp"
+#include "binomial_queue.hpp"
+#include "radix_heap.hpp"
+#include "timing_wheel.hpp"
+#include "../part12/pairing_heap.hpp"
+#include "../lib/alloc_counter.h"
+
+using namespace std;
+using DS::HeapTrace;
+
+struct Result
+{
+    double seconds;
+    long peak_rss_kb;
+    size_t n_allocs;
+    size_t peak_bytes;
+    uint64_t checksum;
+};
+
+static long maxRssKb()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template <typename Driver, typename... Args>
+Result measure(const HeapTrace& trace, Args... args)
+{
+    Result result;
+    long base_rss = maxRssKb();
+    DS::AllocCounter::reset();
+    size_t base_bytes = DS::AllocCounter::liveBytes();
+    uint64_t checksum = 0;
+
+    auto start = chrono::steady_clock::now();
+    {
+        Driver driver(trace.n_ids, args...);
+        DS::runTrace(driver, trace, [&](size_t i, uint64_t key) {
+            checksum += key * (i + 1);
+        });
+    }
+    auto end = chrono::steady_clock::now();
+
+    result.seconds = chrono::duration<double>(end - start).count();
+    result.peak_rss_kb = maxRssKb() - base_rss;
+    result.n_allocs = DS::AllocCounter::allocations();
+    result.peak_bytes = DS::AllocCounter::peakBytes() - base_bytes;
+    result.checksum = checksum;
+    return result;
+}
+
+// 在子进程中执行，保证每次测量的RSS峰值互不影响
+template <typename Driver, typename... Args>
+void bench(const string& name, const HeapTrace& trace, uint64_t expect, Args... args)
+{
+    int fds[2];
+    if(pipe(fds) != 0)
+        return;
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+        close(fds[0]);
+        Result result = measure<Driver>(trace, args...);
+        ssize_t n = write(fds[1], &result, sizeof(result));
+        _exit(n == sizeof(result) ? 0 : 1);
+    }
+    close(fds[1]);
+    Result result;
+    ssize_t n = read(fds[0], &result, sizeof(result));
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    if(n != sizeof(result))
+    {
+        cout << "  " << name << ": failed" << endl;
+        return;
+    }
+
+    cout << "  " << left << setw(26) << name << right
+         << setw(9) << fixed << setprecision(2) << trace.ops.size() / result.seconds / 1e6 << " Mops/s"
+         << setw(9) << result.peak_rss_kb / 1024.0 << " MB rss"
+         << setw(11) << result.n_allocs << " allocs"
+         << setw(9) << result.peak_bytes / 1048576.0 << " MB heap"
+         << (result.checksum == expect ? "" : "  MISMATCH!") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n_ops = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1000000;
+    int seed = argc > 2 ? atoi(argv[2]) : 1;
+
+    typedef DS::HeapItem Item;
+    typedef DS::PairingHeap<Item> Pairing;
+
+    DS::TraceKind kinds[] = {DS::TRACE_PUSH_HEAVY, DS::TRACE_POP_HEAVY, DS::TRACE_MIXED,
+                             DS::TRACE_MERGE_HEAVY, DS::TRACE_DECREASE_HEAVY, DS::TRACE_MONOTONE};
+    for(DS::TraceKind kind : kinds)
+    {
+        DS::HeapTrace trace = DS::makeTrace(kind, n_ops, seed);
+        cout << trace.name << ": " << trace.ops.size() << " ops" << endl;
+
+        uint64_t expect = 0;
+        {
+            DS::LazyHeapDriver<DS::StdPriorityQueue<Item>, false> reference(trace.n_ids);
+            DS::runTrace(reference, trace, [&](size_t i, uint64_t key) {
+                expect += key * (i + 1);
+            });
+        }
+
+        bench<DS::LazyHeapDriver<DS::StdPriorityQueue<Item>, false>>("std::priority_queue", trace, expect);
+        bench<DS::LazyHeapDriver<DS::BinaryHeap<Item>, false>>("BinaryHeap", trace, expect);
+        bench<DS::LazyHeapDriver<DS::LeftistHeap<Item>, true>>("LeftistHeap", trace, expect);
+        bench<DS::LazyHeapDriver<DS::BinomialQueue<Item>, true>>("BinomialQueue", trace, expect);
+        bench<DS::LazyHeapDriver<Pairing, false>>("PairingHeap (lazy)", trace, expect);
+        bench<DS::DecreaseKeyHeapDriver<Pairing>>("PairingHeap two-pass", trace, expect, Pairing::TWO_PASS);
+        bench<DS::DecreaseKeyHeapDriver<Pairing>>("PairingHeap multi-pass", trace, expect, Pairing::MULTI_PASS);
+        bench<DS::DecreaseKeyHeapDriver<Pairing>>("PairingHeap backward", trace, expect, Pairing::BACKWARD_ONE_PASS);
+        if(trace.monotone)
+        {
+            bench<DS::LazyHeapDriver<DS::RadixHeap<Item>, false>>("RadixHeap", trace, expect);
+            bench<DS::LazyHeapDriver<DS::TimingWheel<Item>, false>>("TimingWheel", trace, expect);
+        }
+    }
+    return 0;
+}
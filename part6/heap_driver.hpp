@@ -0,0 +1,344 @@
+#ifndef HEAP_DRIVER_HPP
+#define HEAP_DRIVER_HPP
+
+#include <vector>
+#include <queue>
+#include <set>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <limits>
+#include "../lib/uniform_random.h"
+
+// 堆的统一驱动，供heap_benchmark和heap_fuzz_test使用
+// 所有堆存放同样的元素 (关键字, 编号)，按同一个操作序列(trace)驱动
+//
+// ******************TRACE*********************************
+// PUSH  id key          --> 插入编号为id、关键字为key的元素
+// POP                   --> 弹出最小元素
+// MERGE n               --> 之后的n个MERGE_ITEM组成一个新堆，合并进来
+// DECREASE id key       --> 把编号为id的元素的关键字减小到key
+//
+// 不支持merge的堆逐个插入，不支持decreaseKey的堆采用惰性删除:
+// 插入新的 (key, id)，弹出时跳过关键字已经过期的项
+
+namespace DS
+{
+    typedef std::pair<uint64_t, uint32_t> HeapItem; // (关键字, 编号)
+
+    enum HeapOpType
+    {
+        HEAP_PUSH,
+        HEAP_POP,
+        HEAP_MERGE,
+        HEAP_MERGE_ITEM,
+        HEAP_DECREASE
+    };
+
+    struct HeapOp
+    {
+        HeapOpType type;
+        uint32_t id; // MERGE时为合并的元素个数
+        uint64_t key;
+    };
+
+    enum TraceKind
+    {
+        TRACE_PUSH_HEAVY, // 90% push, 10% pop
+        TRACE_POP_HEAVY, // 先插入n个，再90% pop, 10% push
+        TRACE_MIXED, // 50% push, 50% pop
+        TRACE_MERGE_HEAVY, // 每次合并64个元素，再弹出32个
+        TRACE_DECREASE_HEAVY, // 60% decreaseKey, 20% push, 20% pop
+        TRACE_MONOTONE // 弹出的关键字单调不减，可以驱动RadixHeap/TimingWheel
+    };
+
+    struct HeapTrace
+    {
+        std::string name;
+        std::vector<HeapOp> ops;
+        uint32_t n_ids; // 使用过的编号数
+        bool monotone;
+    };
+
+    inline const char* traceName(TraceKind kind)
+    {
+        switch(kind)
+        {
+            case TRACE_PUSH_HEAVY: return "push-heavy";
+            case TRACE_POP_HEAVY: return "pop-heavy";
+            case TRACE_MIXED: return "mixed";
+            case TRACE_MERGE_HEAVY: return "merge-heavy";
+            case TRACE_DECREASE_HEAVY: return "decreaseKey-heavy";
+            case TRACE_MONOTONE: return "monotone";
+        }
+        return "";
+    }
+
+    // 生成大约n_ops个操作的trace，用std::set模拟堆的内容以保证每个操作都合法
+    inline HeapTrace makeTrace(TraceKind kind, std::size_t n_ops, int seed)
+    {
+        UniformRandom r(seed);
+        HeapTrace trace;
+        trace.name = traceName(kind);
+        trace.n_ids = 0;
+        trace.monotone = kind == TRACE_MONOTONE;
+        std::set<HeapItem> model;
+        std::vector<uint64_t> current; // 每个编号当前的关键字
+        std::vector<uint32_t> live; // 堆中的编号
+        std::vector<uint32_t> live_pos; // 编号在live中的位置
+        uint64_t last_popped = 0;
+
+        auto randomKey = [&]() -> uint64_t {
+            uint64_t key = static_cast<uint32_t>(r.nextInt());
+            return trace.monotone ? last_popped + (key & 0xffff) : key;
+        };
+        auto push = [&](HeapOpType type, uint64_t key) {
+            uint32_t id = trace.n_ids++;
+            HeapOp op = {type, id, key};
+            trace.ops.push_back(op);
+            model.insert(HeapItem(key, id));
+            current.push_back(key);
+            live_pos.push_back(static_cast<uint32_t>(live.size()));
+            live.push_back(id);
+        };
+        auto pop = [&]() {
+            if(model.empty())
+                return;
+            HeapItem top = *model.begin();
+            model.erase(model.begin());
+            last_popped = top.first;
+            uint32_t pos = live_pos[top.second];
+            live[pos] = live.back();
+            live_pos[live[pos]] = pos;
+            live.pop_back();
+            HeapOp op = {HEAP_POP, 0, 0};
+            trace.ops.push_back(op);
+        };
+        auto decrease = [&]() {
+            if(live.empty())
+                return push(HEAP_PUSH, randomKey());
+            uint32_t id = live[r.nextInt(0, static_cast<int>(live.size()) - 1)];
+            uint64_t low = trace.monotone ? last_popped : 0;
+            if(current[id] <= low)
+                return pop();
+            uint64_t range = current[id] - low;
+            uint64_t key = low + static_cast<uint32_t>(r.nextInt()) % range;
+            model.erase(HeapItem(current[id], id));
+            model.insert(HeapItem(key, id));
+            current[id] = key;
+            HeapOp op = {HEAP_DECREASE, id, key};
+            trace.ops.push_back(op);
+        };
+
+        std::size_t prefill = 0;
+        int push_percent = 50;
+        int decrease_percent = 0;
+        switch(kind)
+        {
+            case TRACE_PUSH_HEAVY: push_percent = 90; break;
+            case TRACE_POP_HEAVY: prefill = n_ops / 2; push_percent = 10; break;
+            case TRACE_MIXED: prefill = n_ops / 10; break;
+            case TRACE_DECREASE_HEAVY: prefill = n_ops / 10; push_percent = 20; decrease_percent = 60; break;
+            case TRACE_MONOTONE: prefill = n_ops / 10; push_percent = 40; decrease_percent = 20; break;
+            case TRACE_MERGE_HEAVY: break;
+        }
+
+        for(std::size_t i = 0; i < prefill; ++i)
+            push(HEAP_PUSH, randomKey());
+        if(kind == TRACE_MERGE_HEAVY)
+        {
+            const uint32_t BATCH = 64;
+            while(trace.ops.size() < n_ops)
+            {
+                HeapOp op = {HEAP_MERGE, BATCH, 0};
+                trace.ops.push_back(op);
+                for(uint32_t j = 0; j < BATCH; ++j)
+                    push(HEAP_MERGE_ITEM, randomKey());
+                for(uint32_t j = 0; j < BATCH / 2; ++j)
+                    pop();
+            }
+        } else
+        {
+            while(trace.ops.size() < n_ops)
+            {
+                int dice = r.nextInt(0, 99);
+                if(dice < decrease_percent)
+                    decrease();
+                else if(dice < decrease_percent + push_percent || model.empty())
+                    push(HEAP_PUSH, randomKey());
+                else
+                    pop();
+            }
+        }
+        return trace;
+    }
+
+    // std::priority_queue 适配到 insert/top/pop/empty 接口
+    template <typename Object>
+    class StdPriorityQueue
+    {
+    public:
+        bool empty() const
+        { return queue_.empty(); }
+
+        const Object& top() const
+        { return queue_.top(); }
+
+        void insert(const Object& x)
+        { queue_.push(x); }
+
+        void pop()
+        { queue_.pop(); }
+
+        void pop(Object& x)
+        {
+            x = queue_.top();
+            queue_.pop();
+        }
+
+    private:
+        std::priority_queue<Object, std::vector<Object>, std::greater<Object>> queue_;
+    };
+
+    // 用惰性删除模拟decreaseKey的驱动，CAN_MERGE表示Heap有merge(Heap&)
+    template <typename Heap, bool CAN_MERGE>
+    class LazyHeapDriver
+    {
+    public:
+        explicit LazyHeapDriver(uint32_t n_ids)
+        : current_(n_ids, DEAD)
+        {}
+
+        bool empty()
+        {
+            skipStale();
+            return heap_.empty();
+        }
+
+        void insert(const HeapItem& x)
+        {
+            current_[x.second] = x.first;
+            heap_.insert(x);
+        }
+
+        void merge(const HeapOp* first, uint32_t n)
+        {
+            mergeImpl(first, n, std::integral_constant<bool, CAN_MERGE>());
+        }
+
+        void decreaseKey(uint32_t id, uint64_t key)
+        {
+            current_[id] = key;
+            heap_.insert(HeapItem(key, id));
+        }
+
+        uint64_t popKey()
+        {
+            skipStale();
+            HeapItem x;
+            heap_.pop(x);
+            current_[x.second] = DEAD;
+            return x.first;
+        }
+
+    private:
+        static const uint64_t DEAD = std::numeric_limits<uint64_t>::max();
+
+        Heap heap_;
+        std::vector<uint64_t> current_; // 每个编号当前的关键字，DEAD表示不在堆中
+
+        void skipStale()
+        {
+            while(!heap_.empty() && current_[heap_.top().second] != heap_.top().first)
+                heap_.pop();
+        }
+
+        void mergeImpl(const HeapOp* first, uint32_t n, std::true_type)
+        {
+            Heap other;
+            for(uint32_t i = 0; i < n; ++i)
+            {
+                current_[first[i].id] = first[i].key;
+                other.insert(HeapItem(first[i].key, first[i].id));
+            }
+            heap_.merge(other);
+        }
+
+        void mergeImpl(const HeapOp* first, uint32_t n, std::false_type)
+        {
+            for(uint32_t i = 0; i < n; ++i)
+                insert(HeapItem(first[i].key, first[i].id));
+        }
+    };
+
+    template <typename Heap, bool CAN_MERGE>
+    const uint64_t LazyHeapDriver<Heap, CAN_MERGE>::DEAD;
+
+    // 使用真正decreaseKey的驱动，Heap为PairingHeap
+    template <typename Heap>
+    class DecreaseKeyHeapDriver
+    {
+    public:
+        explicit DecreaseKeyHeapDriver(uint32_t n_ids, typename Heap::CombineMode mode = Heap::TWO_PASS)
+        : heap_(mode), pos_(n_ids)
+        {}
+
+        bool empty()
+        { return heap_.empty(); }
+
+        void insert(const HeapItem& x)
+        { pos_[x.second] = heap_.insert(x); }
+
+        void merge(const HeapOp* first, uint32_t n)
+        {
+            for(uint32_t i = 0; i < n; ++i)
+                insert(HeapItem(first[i].key, first[i].id));
+        }
+
+        void decreaseKey(uint32_t id, uint64_t key)
+        { heap_.decreaseKey(pos_[id], HeapItem(key, id)); }
+
+        uint64_t popKey()
+        {
+            HeapItem x;
+            heap_.pop(x);
+            return x.first;
+        }
+
+    private:
+        Heap heap_;
+        std::vector<typename Heap::Position> pos_;
+    };
+
+    // 执行trace，on_pop(序号, 关键字)在每次弹出时调用
+    template <typename Driver, typename OnPop>
+    void runTrace(Driver& driver, const HeapTrace& trace, OnPop on_pop)
+    {
+        std::size_t n_pops = 0;
+        const std::vector<HeapOp>& ops = trace.ops;
+        for(std::size_t i = 0; i < ops.size(); ++i)
+        {
+            const HeapOp& op = ops[i];
+            switch(op.type)
+            {
+                case HEAP_PUSH:
+                    driver.insert(HeapItem(op.key, op.id));
+                    break;
+                case HEAP_POP:
+                    on_pop(n_pops++, driver.popKey());
+                    break;
+                case HEAP_MERGE:
+                    driver.merge(&ops[i + 1], op.id);
+                    i += op.id;
+                    break;
+                case HEAP_DECREASE:
+                    driver.decreaseKey(op.id, op.key);
+                    break;
+                case HEAP_MERGE_ITEM:
+                    break;
+            }
+        }
+    }
+}
+#endif //HEAP_DRIVER_HPP
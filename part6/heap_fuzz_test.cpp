@@ -0,0 +1,78 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include "heap_driver.hpp"
+#include "binary_heap.hpp"
+#include "left_heap.hpp"
+#include "binomial_queue.hpp"
+#include "radix_heap.hpp"
+#include "timing_wheel.hpp"
+#include "../part12/pairing_heap.hpp"
+using namespace std;
+
+typedef DS::HeapItem Item;
+typedef DS::PairingHeap<Item> Pairing;
+
+// 差分测试: 每个堆弹出的关键字序列必须与std::priority_queue完全相同
+template <typename Driver, typename... Args>
+void check(const string& name, const DS::HeapTrace& trace, const vector<uint64_t>& expect,
+        int seed, Args... args)
+{
+    Driver driver(trace.n_ids, args...);
+    vector<uint64_t> popped;
+    DS::runTrace(driver, trace, [&](size_t, uint64_t key) {
+        popped.push_back(key);
+    });
+    if(popped != expect)
+        cout << "Oops! " << name << " " << trace.name << " seed " << seed << endl;
+    // 剩下的元素也要一致
+    DS::LazyHeapDriver<DS::StdPriorityQueue<Item>, false> reference(trace.n_ids);
+    DS::runTrace(reference, trace, [](size_t, uint64_t) {});
+    while(!reference.empty())
+    {
+        if(driver.empty() || driver.popKey() != reference.popKey())
+        {
+            cout << "Oops! " << name << " " << trace.name << " drain seed " << seed << endl;
+            return;
+        }
+    }
+    if(!driver.empty())
+        cout << "Oops! " << name << " " << trace.name << " not empty seed " << seed << endl;
+}
+
+int main()
+{
+    DS::TraceKind kinds[] = {DS::TRACE_PUSH_HEAVY, DS::TRACE_POP_HEAVY, DS::TRACE_MIXED,
+                             DS::TRACE_MERGE_HEAVY, DS::TRACE_DECREASE_HEAVY, DS::TRACE_MONOTONE};
+    int n_seeds = 50;
+
+    cout << "Begin fuzz test..." << endl;
+    for(int seed = 1; seed <= n_seeds; ++seed)
+    {
+        for(DS::TraceKind kind : kinds)
+        {
+            size_t n_ops = 10 + seed * 97 % 3000;
+            DS::HeapTrace trace = DS::makeTrace(kind, n_ops, seed);
+            vector<uint64_t> expect;
+            DS::LazyHeapDriver<DS::StdPriorityQueue<Item>, false> reference(trace.n_ids);
+            DS::runTrace(reference, trace, [&](size_t, uint64_t key) {
+                expect.push_back(key);
+            });
+
+            check<DS::LazyHeapDriver<DS::BinaryHeap<Item>, false>>("BinaryHeap", trace, expect, seed);
+            check<DS::LazyHeapDriver<DS::LeftistHeap<Item>, true>>("LeftistHeap", trace, expect, seed);
+            check<DS::LazyHeapDriver<DS::BinomialQueue<Item>, true>>("BinomialQueue", trace, expect, seed);
+            check<DS::LazyHeapDriver<Pairing, false>>("PairingHeap lazy", trace, expect, seed);
+            check<DS::DecreaseKeyHeapDriver<Pairing>>("PairingHeap two-pass", trace, expect, seed, Pairing::TWO_PASS);
+            check<DS::DecreaseKeyHeapDriver<Pairing>>("PairingHeap multi-pass", trace, expect, seed, Pairing::MULTI_PASS);
+            check<DS::DecreaseKeyHeapDriver<Pairing>>("PairingHeap backward", trace, expect, seed, Pairing::BACKWARD_ONE_PASS);
+            if(trace.monotone)
+            {
+                check<DS::LazyHeapDriver<DS::RadixHeap<Item>, false>>("RadixHeap", trace, expect, seed);
+                check<DS::LazyHeapDriver<DS::TimingWheel<Item>, false>>("TimingWheel", trace, expect, seed);
+            }
+        }
+    }
+    cout << "End fuzz test... no other output is good" << endl;
+    return 0;
+}
@@ -0,0 +1,161 @@
+// 单调整数关键字场景下各种堆的性能对比
+// 工作负载:
+//   hold-narrow  事件调度的hold模型: 弹出时间t，插入 t + [0, 1000) 的新事件
+//   hold-wide    同上，延迟为 [0, 2^32)
+//   sort         插入全部随机关键字后依次弹出
+// 所有堆必须弹出相同的关键字序列，用校验和检查
+//
+// 用法: monotone_heap_benchmark [n_pending] [n_operations] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include "binary_heap.hpp"
+#include "left_heap.hpp"
+#include "binomial_queue.hpp"
+#include "radix_heap.hpp"
+#include "timing_wheel.hpp"
+#include "../part12/pairing_heap.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+
+// std::priority_queue 适配到 insert/top/pop/empty 接口
+class StdQueue
+{
+public:
+    bool empty() const
+    { return queue_.empty(); }
+
+    const uint64_t& top() const
+    { return queue_.top(); }
+
+    void insert(uint64_t x)
+    { queue_.push(x); }
+
+    void pop(uint64_t& x)
+    {
+        x = queue_.top();
+        queue_.pop();
+    }
+
+private:
+    priority_queue<uint64_t, vector<uint64_t>, greater<uint64_t>> queue_;
+};
+
+struct Workload
+{
+    string name;
+    vector<uint64_t> initial; // 初始插入的关键字
+    vector<uint64_t> delays; // hold模型: 每次弹出后插入 t + delay
+    bool drain; // 最后是否弹出全部元素
+};
+
+Workload makeHold(const string& name, size_t n_pending, size_t n_ops, uint64_t max_delay, int seed)
+{
+    DS::UniformRandom r(seed);
+    Workload w;
+    w.name = name;
+    w.drain = false;
+    for(size_t i = 0; i < n_pending; ++i)
+        w.initial.push_back(static_cast<uint64_t>(r.nextInt()) % max_delay);
+    for(size_t i = 0; i < n_ops; ++i)
+    {
+        uint64_t delay = (static_cast<uint64_t>(static_cast<uint32_t>(r.nextInt())) << 32)
+                         | static_cast<uint32_t>(r.nextInt());
+        w.delays.push_back(delay % max_delay);
+    }
+    return w;
+}
+
+Workload makeSort(size_t n, int seed)
+{
+    DS::UniformRandom r(seed);
+    Workload w;
+    w.name = "sort";
+    w.drain = true;
+    for(size_t i = 0; i < n; ++i)
+        w.initial.push_back(static_cast<uint32_t>(r.nextInt()));
+    return w;
+}
+
+template <typename Heap>
+uint64_t runWorkload(const Workload& w)
+{
+    Heap heap;
+    uint64_t checksum = 0;
+    uint64_t count = 0;
+    for(uint64_t key : w.initial)
+        heap.insert(key);
+    for(uint64_t delay : w.delays)
+    {
+        uint64_t t;
+        heap.pop(t);
+        checksum += t * (++count);
+        heap.insert(t + delay);
+    }
+    if(w.drain)
+    {
+        while(!heap.empty())
+        {
+            uint64_t t;
+            heap.pop(t);
+            checksum += t * (++count);
+        }
+    }
+    return checksum;
+}
+
+template <typename Heap>
+void bench(const string& name, const Workload& w, uint64_t& expect)
+{
+    auto start = chrono::steady_clock::now();
+    uint64_t checksum = runWorkload<Heap>(w);
+    auto end = chrono::steady_clock::now();
+    double sec = chrono::duration<double>(end - start).count();
+    size_t n_ops = w.initial.size() + 2 * w.delays.size() + (w.drain ? w.initial.size() : 0);
+    if(expect == 0)
+        expect = checksum;
+    cout << "  " << left << setw(16) << name
+         << right << setw(10) << fixed << setprecision(1) << sec * 1000 << " ms"
+         << setw(10) << setprecision(2) << n_ops / sec / 1e6 << " Mops/s"
+         << (checksum == expect ? "" : "  MISMATCH!") << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n_pending = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 100000;
+    size_t n_ops = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 2000000;
+    int seed = argc > 3 ? atoi(argv[3]) : 1;
+    if(n_pending < 1)
+    {
+        cout << "usage: " << argv[0] << " [n_pending >= 1] [n_operations] [seed]" << endl;
+        return 1;
+    }
+
+    vector<Workload> workloads;
+    workloads.push_back(makeHold("hold-narrow", n_pending, n_ops, 1000, seed));
+    workloads.push_back(makeHold("hold-wide", n_pending, n_ops, uint64_t(1) << 32, seed));
+    workloads.push_back(makeSort(n_ops, seed));
+
+    for(const Workload& w : workloads)
+    {
+        cout << w.name << ": " << w.initial.size() << " initial, "
+             << w.delays.size() << " pop+insert" << endl;
+        uint64_t expect = 0;
+        bench<DS::BinaryHeap<uint64_t>>("BinaryHeap", w, expect);
+        bench<StdQueue>("priority_queue", w, expect);
+        bench<DS::LeftistHeap<uint64_t>>("LeftistHeap", w, expect);
+        bench<DS::BinomialQueue<uint64_t>>("BinomialQueue", w, expect);
+        bench<DS::PairingHeap<uint64_t>>("PairingHeap", w, expect);
+        bench<DS::RadixHeap<uint64_t>>("RadixHeap", w, expect);
+        bench<DS::TimingWheel<uint64_t>>("TimingWheel", w, expect);
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "../lib/dsexceptions.h"
+
+// 基数堆 单调整数优先队列
+// RadixHeap class
+// 关键字为uint64_t，且弹出的关键字序列单调不减(最短路径、事件调度)
+// CONSTRUCTION: with no parameters
+//
+// ******************PUBLIC OPERATIONS*********************
+// void insert( x )       --> Insert x, allowing duplicates
+// pop( minItem )   --> Remove (and optionally return) top item
+// Comparable top( )  --> Return the top item
+// bool empty( )        --> Return true if empty; else false
+// void clear( )      --> Remove all items
+// ******************ERRORS********************************
+// Throws UnderflowException as warranted
+// Throws IllegalArgumentException if key < key of the last top()/pop()
+//
+// 实现说明:
+// last_ 为最近一次top()/pop()得到的关键字，插入的关键字不能小于last_
+// 关键字k放入第 bucketIndex(k) 个桶: k == last_ 放入0号桶，否则放入 k ^ last_ 最高位+1 号桶
+// 0号桶为空时，取第一个非空桶中的最小值作为新的last_，把该桶中的元素重新分配到更低的桶
+// 每个元素只会往更低的桶移动，插入、删除均摊O(log C)，C为关键字的范围
+
+namespace DS
+{
+    // 从元素中取出uint64_t关键字，默认元素本身就是关键字
+    template <typename Object>
+    class RadixKey
+    {
+    public:
+        uint64_t operator() (const Object& x) const
+        {
+            return static_cast<uint64_t>(x);
+        }
+    };
+
+    // pair以first作为关键字，例如 (距离, 顶点)
+    template <typename Key, typename Value>
+    class RadixKey<std::pair<Key, Value>>
+    {
+    public:
+        uint64_t operator() (const std::pair<Key, Value>& x) const
+        {
+            return static_cast<uint64_t>(x.first);
+        }
+    };
+
+    template <typename Object = uint64_t, class KeyOf = RadixKey<Object>>
+    class RadixHeap
+    {
+    public:
+        explicit RadixHeap(const KeyOf& key_of = KeyOf())
+        : last_{0}, mask_{0}, size_{0}, key_of_{key_of}
+        {}
+
+        bool empty() const
+        { return size_ == 0; }
+
+        std::size_t size() const
+        { return size_; }
+
+        // 找堆顶元素，如果空堆则抛出异常
+        const Object& top() const
+        {
+            if(empty())
+                throw UnderflowException{};
+            settle();
+            return buckets_[0].back();
+        }
+
+        // 删除堆顶元素
+        void pop()
+        {
+            if(empty())
+                throw UnderflowException{};
+            settle();
+            buckets_[0].pop_back();
+            --size_;
+        }
+
+        // 删除堆顶元素，并将其放在min_item中
+        void pop(Object& min_item)
+        {
+            if(empty())
+                throw UnderflowException{};
+            settle();
+            min_item = std::move(buckets_[0].back());
+            buckets_[0].pop_back();
+            --size_;
+        }
+
+        void insert(const Object& x)
+        {
+            Object copy(x);
+            insert(std::move(copy));
+        }
+
+        void insert(Object&& x)
+        {
+            uint64_t key = key_of_(x);
+            if(key < last_)
+                throw IllegalArgumentException{};
+            push(std::move(x), key);
+            ++size_;
+        }
+
+        // 桶的容量保留，last_重置为0
+        void clear()
+        {
+            for(auto& bucket : buckets_)
+                bucket.clear();
+            last_ = 0;
+            mask_ = 0;
+            size_ = 0;
+        }
+
+    private:
+        const static int N_BUCKETS = 65;
+
+        // 惰性重分配发生在top()/pop()中，所以桶和last_是mutable的
+        mutable std::vector<Object> buckets_[N_BUCKETS];
+        mutable uint64_t last_;
+        mutable uint64_t mask_; // 第i位为1表示第i+1号桶非空
+        std::size_t size_;
+        KeyOf key_of_;
+
+        int bucketIndex(uint64_t key) const
+        { return key == last_ ? 0 : 64 - __builtin_clzll(key ^ last_); }
+
+        void push(Object&& x, uint64_t key) const
+        {
+            int b = bucketIndex(key);
+            buckets_[b].push_back(std::move(x));
+            if(b != 0)
+                mask_ |= uint64_t(1) << (b - 1);
+        }
+
+        // 保证0号桶非空，调用时堆不能为空
+        void settle() const
+        {
+            if(!buckets_[0].empty())
+                return;
+            int b = __builtin_ctzll(mask_) + 1;
+            std::vector<Object>& bucket = buckets_[b];
+            uint64_t min_key = key_of_(bucket[0]);
+            for(std::size_t i = 1; i < bucket.size(); ++i)
+            {
+                uint64_t key = key_of_(bucket[i]);
+                if(key < min_key)
+                    min_key = key;
+            }
+            last_ = min_key;
+            mask_ &= ~(uint64_t(1) << (b - 1));
+            // 与新的last_相比，桶中元素的最高不同位一定低于b，全部移到更低的桶
+            for(auto& x : bucket)
+                push(std::move(x), key_of_(x));
+            bucket.clear();
+        }
+    };
+}
+#endif //RADIX_HEAP_HPP
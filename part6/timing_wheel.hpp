@@ -0,0 +1,177 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "../lib/dsexceptions.h"
+#include "radix_heap.hpp"
+
+// 分层时间轮 单调整数优先队列
+// TimingWheel class
+// 关键字为uint64_t时间戳，且弹出的时间戳序列单调不减(事件调度)
+// CONSTRUCTION: with no parameters
+//
+// ******************PUBLIC OPERATIONS*********************
+// void insert( x )       --> Insert x, allowing duplicates
+// pop( minItem )   --> Remove (and optionally return) top item
+// Comparable top( )  --> Return the top item
+// bool empty( )        --> Return true if empty; else false
+// void clear( )      --> Remove all items
+// ******************ERRORS********************************
+// Throws UnderflowException as warranted
+// Throws IllegalArgumentException if key < key of the last top()/pop()
+//
+// 实现说明:
+// 共11层，每层64个槽，第L层的槽对应时间戳的第[6L, 6L + 6)位
+// now_ 为时间轮的当前时间(最近一次top()/pop()得到的时间戳)，时间戳k放在 k ^ now_ 最高位所在的层，槽号为k在该层的6位
+// 第0层的槽对应唯一的时间戳，第0层为空时把最低的非空层的第一个非空槽展开(cascade)到下面的层
+// 每层用一个64位的占用位图，查找非空槽只需要ctz
+
+namespace DS
+{
+    template <typename Object = uint64_t, class KeyOf = RadixKey<Object>>
+    class TimingWheel
+    {
+    public:
+        explicit TimingWheel(const KeyOf& key_of = KeyOf())
+        : now_{0}, size_{0}, key_of_{key_of}
+        {
+            for(auto& mask : masks_)
+                mask = 0;
+        }
+
+        bool empty() const
+        { return size_ == 0; }
+
+        std::size_t size() const
+        { return size_; }
+
+        // 当前时间，不大于堆中所有的时间戳
+        uint64_t now() const
+        { return now_; }
+
+        // 找堆顶元素，如果空堆则抛出异常
+        const Object& top() const
+        {
+            if(empty())
+                throw UnderflowException{};
+            settle();
+            return slots_[0][__builtin_ctzll(masks_[0])].back();
+        }
+
+        // 删除堆顶元素
+        void pop()
+        {
+            if(empty())
+                throw UnderflowException{};
+            settle();
+            popFront();
+        }
+
+        // 删除堆顶元素，并将其放在min_item中
+        void pop(Object& min_item)
+        {
+            if(empty())
+                throw UnderflowException{};
+            settle();
+            min_item = std::move(slots_[0][__builtin_ctzll(masks_[0])].back());
+            popFront();
+        }
+
+        void insert(const Object& x)
+        {
+            Object copy(x);
+            insert(std::move(copy));
+        }
+
+        void insert(Object&& x)
+        {
+            uint64_t key = key_of_(x);
+            if(key < now_)
+                throw IllegalArgumentException{};
+            push(std::move(x), key);
+            ++size_;
+        }
+
+        // 槽的容量保留，当前时间重置为0
+        void clear()
+        {
+            for(int level = 0; level < N_LEVELS; ++level)
+            {
+                for(auto& slot : slots_[level])
+                    slot.clear();
+                masks_[level] = 0;
+            }
+            now_ = 0;
+            size_ = 0;
+        }
+
+    private:
+        const static int SLOT_BITS = 6;
+        const static int N_SLOTS = 1 << SLOT_BITS;
+        const static int N_LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+        // 展开发生在top()/pop()中，所以槽和当前时间是mutable的
+        mutable std::vector<Object> slots_[N_LEVELS][N_SLOTS];
+        mutable uint64_t masks_[N_LEVELS]; // 每层的槽占用位图
+        mutable uint64_t now_;
+        std::size_t size_;
+        KeyOf key_of_;
+
+        static int slotOf(uint64_t key, int level)
+        { return static_cast<int>((key >> (SLOT_BITS * level)) & (N_SLOTS - 1)); }
+
+        int levelOf(uint64_t key) const
+        {
+            uint64_t diff = key ^ now_;
+            return diff == 0 ? 0 : (63 - __builtin_clzll(diff)) / SLOT_BITS;
+        }
+
+        void push(Object&& x, uint64_t key) const
+        {
+            int level = levelOf(key);
+            int slot = slotOf(key, level);
+            slots_[level][slot].push_back(std::move(x));
+            masks_[level] |= uint64_t(1) << slot;
+        }
+
+        void popFront()
+        {
+            int slot = __builtin_ctzll(masks_[0]);
+            slots_[0][slot].pop_back();
+            if(slots_[0][slot].empty())
+                masks_[0] &= ~(uint64_t(1) << slot);
+            --size_;
+        }
+
+        // 保证第0层非空，调用时堆不能为空
+        void settle() const
+        {
+            while(masks_[0] == 0)
+            {
+                int level = 1;
+                while(masks_[level] == 0)
+                    ++level;
+                int slot = __builtin_ctzll(masks_[level]);
+                masks_[level] &= ~(uint64_t(1) << slot);
+
+                // 当前时间前进到该槽的起点: 保留该层以上的位，该层取槽号，以下清零
+                int high_shift = SLOT_BITS * (level + 1);
+                uint64_t high = high_shift >= 64 ? 0 : (now_ >> high_shift) << high_shift;
+                now_ = high | (static_cast<uint64_t>(slot) << (SLOT_BITS * level));
+
+                std::vector<Object> items;
+                items.swap(slots_[level][slot]);
+                for(auto& x : items)
+                    push(std::move(x), key_of_(x));
+                // 把容量还给槽，避免反复分配
+                items.clear();
+                slots_[level][slot].swap(items);
+            }
+            // 第0层的最小槽即为堆顶的时间戳，同一层的位不变，其他元素所在的层也不变
+            now_ = (now_ & ~static_cast<uint64_t>(N_SLOTS - 1)) | __builtin_ctzll(masks_[0]);
+        }
+    };
+}
+#endif //TIMING_WHEEL_HPP
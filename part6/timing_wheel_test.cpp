@@ -0,0 +1,79 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <utility>
+#include "timing_wheel.hpp"
+#include "../lib/uniform_random.h"
+using namespace std;
+using DS::TimingWheel;
+
+// Test program
+int main()
+{
+    TimingWheel<uint64_t> h;
+    priority_queue<uint64_t, vector<uint64_t>, greater<uint64_t>> pq;
+    DS::UniformRandom r(7);
+    int numItems = 100000;
+
+    cout << "Begin test... " << endl;
+
+    // 模拟事件调度: 弹出时间t，再插入 t + 随机延迟
+    for(int i = 0; i < 1000; ++i)
+    {
+        uint64_t t = r.nextInt(0, 1 << 20);
+        h.insert(t);
+        pq.push(t);
+    }
+    for(int i = 0; i < numItems; ++i)
+    {
+        if(h.top() != pq.top())
+            cout << "Oops! top " << i << endl;
+        uint64_t t;
+        h.pop(t);
+        pq.pop();
+        int n_new = r.nextInt(0, 2);
+        for(int j = 0; j < n_new; ++j)
+        {
+            uint64_t delay = j == 0 ? 0 : static_cast<uint64_t>(r.nextInt(0, 1 << 16)) << r.nextInt(0, 40);
+            h.insert(t + delay);
+            pq.push(t + delay);
+        }
+        if(h.empty())
+            break;
+    }
+    while(!h.empty())
+    {
+        if(h.top() != pq.top())
+            cout << "Oops! drain" << endl;
+        h.pop();
+        pq.pop();
+    }
+    if(!pq.empty())
+        cout << "Oops! size" << endl;
+
+    // (关键字, 数据) 对
+    TimingWheel<pair<uint64_t, int>> ph;
+    for(int i = 37; i != 0; i = (i + 37) % numItems)
+        ph.insert(make_pair(static_cast<uint64_t>(i), -i));
+    for(int i = 1; i < numItems; ++i)
+    {
+        pair<uint64_t, int> x;
+        ph.pop(x);
+        if(x.first != static_cast<uint64_t>(i) || x.second != -i)
+            cout << "Oops! " << i << endl;
+    }
+
+    // 插入比上次弹出更小的关键字
+    ph.insert(make_pair(uint64_t(numItems + 10), 0));
+    ph.pop();
+    try
+    {
+        ph.insert(make_pair(uint64_t(numItems + 9), 0));
+        cout << "Oops! non-monotone insert accepted" << endl;
+    } catch(const DS::IllegalArgumentException&)
+    {}
+
+    cout << "End test... no other output is good" << endl;
+    return 0;
+}
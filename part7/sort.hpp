@@ -4,6 +4,10 @@
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
 namespace DS
 {
@@ -30,11 +34,11 @@ namespace DS
     void insertionSort(std::vector<Object>& arr, ds_size left, ds_size right,
             const Compare& cmp = Compare())
     {
-        for(ds_size i = left; i <= right; ++i)
+        for(ds_size i = left + 1; i <= right; ++i)
         {
             Object tmp = std::move(arr[i]);
-            int j = i;
-            for(; j != 0 && cmp(tmp, arr[j - 1]); --j)
+            ds_size j = i;
+            for(; j != left && cmp(tmp, arr[j - 1]); --j)
                 arr[j] = std::move(arr[j - 1]);
             arr[j] = std::move(tmp);
         }
@@ -288,9 +292,9 @@ namespace DS
 
             // 相比快速排序，快速选择只重新排其中一部分
             if(k <= i)
-                quickSelect(arr, left, i - 1, k);
+                quickSelect(arr, left, i - 1, k, cmp);
             else if(k > i + 1)
-                quickSelect(arr, i + 1, right, k);
+                quickSelect(arr, i + 1, right, k, cmp);
         } else{
             insertionSort(arr, left, right, cmp);
         }
@@ -305,5 +309,65 @@ namespace DS
     {
         quickSelect(arr, 0, arr.size() - 1, k, cmp);
     }
+
+    // 计数基数排序(LSD)，按无符号整数关键字key(x)从小到大排序，稳定
+    // 每趟按8位分桶，一次遍历统计所有趟的计数，所有元素在某一位上都相同时跳过这一趟
+    template<typename RandomIterator, class KeyOf>
+    void radixSort(const RandomIterator& begin, const RandomIterator& end, const KeyOf& key)
+    {
+        typedef typename std::iterator_traits<RandomIterator>::value_type Object;
+        typedef typename std::decay<decltype(key(*begin))>::type Key;
+        static_assert(std::is_unsigned<Key>::value, "radixSort needs unsigned keys");
+        const int BUCKETS = 256;
+        const int PASSES = sizeof(Key);
+        ds_size n_total = end - begin;
+        if(n_total < 2)
+            return;
+
+        std::vector<ds_size> count(PASSES * BUCKETS, 0);
+        for(RandomIterator p = begin; p != end; ++p)
+        {
+            Key k = key(*p);
+            for(int pass = 0; pass < PASSES; ++pass)
+                ++count[pass * BUCKETS + ((k >> (8 * pass)) & (BUCKETS - 1))];
+        }
+
+        std::vector<Object> buffer(n_total);
+        bool in_buffer = false; // 当前的数据在buffer中
+        for(int pass = 0; pass < PASSES; ++pass)
+        {
+            ds_size* c = &count[pass * BUCKETS];
+            Key first = key(in_buffer ? buffer[0] : *begin);
+            if(c[(first >> (8 * pass)) & (BUCKETS - 1)] == n_total)
+                continue;
+            // 每个桶的起始位置
+            ds_size sum = 0;
+            for(int b = 0; b < BUCKETS; ++b)
+            {
+                ds_size tmp = c[b];
+                c[b] = sum;
+                sum += tmp;
+            }
+            if(in_buffer)
+            {
+                for(auto& x : buffer)
+                    *(begin + c[(key(x) >> (8 * pass)) & (BUCKETS - 1)]++) = std::move(x);
+            } else
+            {
+                for(RandomIterator p = begin; p != end; ++p)
+                    buffer[c[(key(*p) >> (8 * pass)) & (BUCKETS - 1)]++] = std::move(*p);
+            }
+            in_buffer = !in_buffer;
+        }
+        if(in_buffer)
+            std::move(buffer.begin(), buffer.end(), begin);
+    }
+
+    // 无符号整数的基数排序
+    template<typename Object>
+    void radixSort(std::vector<Object>& arr)
+    {
+        radixSort(arr.begin(), arr.end(), [](const Object& x) { return x; });
+    }
 }
 #endif //SORT_HPP
@@ -82,5 +82,21 @@ int main()
         if (b[i] != i)
             cout << "OOPS!!" << endl;
 
+    cout << "Checking radixSort" << endl;
+    vector<unsigned> c(b.begin(), b.end());
+    permute(c);
+    radixSort(c);
+    for (int i = 0; i < N; ++i)
+        if (c[i] != static_cast<unsigned>(i))
+            cout << "OOPS!!" << endl;
+    // 按低16位排序，高位相同的元素保持原来的先后顺序
+    vector<unsigned long long> d(N);
+    for (int i = 0; i < N; ++i)
+        d[i] = static_cast<unsigned long long>(i) << 16 | (i * 7919u & 0xffff);
+    radixSort(d.begin(), d.end(), [](unsigned long long x) { return static_cast<unsigned short>(x); });
+    for (int i = 1; i < N; ++i)
+        if ((d[i - 1] & 0xffff) > (d[i] & 0xffff) || ((d[i - 1] & 0xffff) == (d[i] & 0xffff) && d[i - 1] > d[i]))
+            cout << "OOPS!! radixSort is not stable" << endl;
+
     return 0;
 }
\ No newline at end of file
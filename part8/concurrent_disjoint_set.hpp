@@ -0,0 +1,150 @@
+#ifndef CONCURRENT_DISJOINT_SET_HPP
+#define CONCURRENT_DISJOINT_SET_HPP
+
+// ConcurrentDisjSets class
+// 无锁并查集(Jayanti-Tarjan的随机链接)，元素为 0 ~ n-1，可以被多个线程同时合并和查找
+// 父节点数组的每一项都是原子的，根的父节点是自己:
+//   find      路径分裂，用CAS把经过的节点指向祖父，CAS失败说明别的线程已经改过，直接继续
+//   unite     找到两个根后用CAS把优先级低的根指向优先级高的根，根已被别的线程链接时重试
+// 优先级为编号的哈希(相当于一个固定的随机排列)，链接总是从低到高，不会成环；
+// 随机排列下树高期望为O(log n)
+//
+// parallelConnectedComponents( n, edges, n_threads )
+// 把边表分成n_threads段，各线程同时合并，最后并行求每个顶点所在集合的代表元
+//
+// CONSTRUCTION: with the number of elements, each in its own set
+//
+// ******************PUBLIC OPERATIONS*********************
+// uint32_t find( x )         --> Return the root of the set containing x
+// bool unite( x, y )         --> Merge the sets of x and y, return false if already merged
+// bool sameSet( x, y )       --> Return true if x and y are in the same set
+// uint32_t size( )           --> Return the number of elements
+// uint32_t countSets( )      --> Count the roots, O(n)
+// ******************ERRORS********************************
+// No error checking is performed on ids
+//
+// find, unite, sameSet 都是可线性化的，可以并发调用；countSets只在没有并发合并时准确
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "../lib/fork_join.h"
+
+namespace DS
+{
+    class ConcurrentDisjSets
+    {
+    public:
+        explicit ConcurrentDisjSets(uint32_t n)
+        : n_{n}, parent_{new std::atomic<uint32_t>[n]}
+        {
+            for(uint32_t i = 0; i < n; ++i)
+                parent_[i].store(i, std::memory_order_relaxed);
+        }
+
+        ConcurrentDisjSets(const ConcurrentDisjSets& rhs) = delete;
+
+        ConcurrentDisjSets& operator=(const ConcurrentDisjSets& rhs) = delete;
+
+        uint32_t size() const
+        { return n_; }
+
+        // Perform a find with path splitting.
+        // Return the set containing x.
+        uint32_t find(uint32_t x)
+        {
+            while(true)
+            {
+                uint32_t parent = parent_[x].load(std::memory_order_acquire);
+                uint32_t grand = parent_[parent].load(std::memory_order_acquire);
+                if(parent == grand)
+                    return parent;
+                // 失败说明x已经指向更高的祖先，同样可以继续
+                parent_[x].compare_exchange_weak(parent, grand, std::memory_order_acq_rel);
+                x = parent;
+            }
+        }
+
+        bool unite(uint32_t x, uint32_t y)
+        {
+            while(true)
+            {
+                x = find(x);
+                y = find(y);
+                if(x == y)
+                    return false;
+                if(higher(x, y))
+                    std::swap(x, y);
+                // x的优先级低，指向y；x已经不是根时重新查找
+                uint32_t expected = x;
+                if(parent_[x].compare_exchange_strong(expected, y, std::memory_order_acq_rel))
+                    return true;
+            }
+        }
+
+        // 两个根不同且x仍是根时，这一刻x与y不在同一集合
+        bool sameSet(uint32_t x, uint32_t y)
+        {
+            while(true)
+            {
+                x = find(x);
+                y = find(y);
+                if(x == y)
+                    return true;
+                if(parent_[x].load(std::memory_order_acquire) == x)
+                    return false;
+            }
+        }
+
+        uint32_t countSets() const
+        {
+            uint32_t count = 0;
+            for(uint32_t i = 0; i < n_; ++i)
+                count += parent_[i].load(std::memory_order_relaxed) == i;
+            return count;
+        }
+
+    private:
+        uint32_t n_;
+        std::unique_ptr<std::atomic<uint32_t>[]> parent_;
+
+        // 编号的哈希作为随机优先级，相同时比较编号
+        static uint32_t priority(uint32_t x)
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352dU;
+            x ^= x >> 15;
+            x *= 0x846ca68bU;
+            x ^= x >> 16;
+            return x;
+        }
+
+        static bool higher(uint32_t x, uint32_t y)
+        {
+            uint32_t px = priority(x), py = priority(y);
+            return px > py || (px == py && x > y);
+        }
+    };
+
+    // 无向图的连通分量，顶点为 0 ~ n-1，返回每个顶点所在分量的代表顶点
+    inline std::vector<uint32_t> parallelConnectedComponents(
+            uint32_t n, const std::vector<std::pair<uint32_t, uint32_t>>& edges, unsigned n_threads)
+    {
+        ConcurrentDisjSets sets(n);
+        std::vector<uint32_t> label(n);
+        parallelFor(n_threads, edges.size(), [&](unsigned, std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; ++i)
+                sets.unite(edges[i].first, edges[i].second);
+        });
+        parallelFor(n_threads, n, [&](unsigned, std::size_t begin, std::size_t end) {
+            for(std::size_t v = begin; v < end; ++v)
+                label[v] = sets.find(static_cast<uint32_t>(v));
+        });
+        return label;
+    }
+}
+
+#endif //CONCURRENT_DISJOINT_SET_HPP
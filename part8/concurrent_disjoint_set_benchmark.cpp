@@ -0,0 +1,99 @@
+// 并行连通分量的扩展性
+// n个顶点、m条边的两种图:
+//   uniform     端点均匀随机
+//   skewed      一个端点取自前1%的顶点(少数高度数顶点，类似网页图的入链)
+// 对照: 单线程的DenseDisjSets，同样最后求每个顶点的代表元
+// ConcurrentDisjSets: parallelConnectedComponents，线程数取1, 2, 4, ... max_threads
+// 结果用分量个数比较
+//
+// 用法: concurrent_disjoint_set_benchmark [n] [m] [max_threads] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "concurrent_disjoint_set.hpp"
+#include "disjoint_set.hpp"
+#include "../lib/uniform_random.h"
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> EdgeList;
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+EdgeList makeEdges(uint32_t n, std::size_t m, bool skewed, DS::UniformRandom& r)
+{
+    EdgeList edges(m);
+    int hot = skewed ? std::max(1, static_cast<int>(n / 100)) : static_cast<int>(n);
+    for(auto& e : edges)
+    {
+        e.first = static_cast<uint32_t>(r.nextInt(0, hot - 1));
+        e.second = static_cast<uint32_t>(r.nextInt(0, static_cast<int>(n - 1)));
+    }
+    return edges;
+}
+
+uint32_t countComponents(const std::vector<uint32_t>& label)
+{
+    uint32_t count = 0;
+    for(uint32_t v = 0; v < label.size(); ++v)
+        count += label[v] == v;
+    return count;
+}
+
+void bench(const std::string& name, uint32_t n, const EdgeList& edges, unsigned max_threads)
+{
+    uint32_t expect = 0;
+    double t_dense = seconds([&]() {
+        DS::DenseDisjSets sets(n);
+        for(auto& e : edges)
+            sets.unionSets(e.first, e.second);
+        std::vector<uint32_t> label(n);
+        for(uint32_t v = 0; v < n; ++v)
+            label[v] = sets.find(v);
+        expect = countComponents(label);
+    });
+    std::cout << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << "DenseDisjSets " << edges.size() / t_dense / 1e6 << ", parallel";
+    bool ok = true;
+    for(unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+    {
+        std::vector<uint32_t> label;
+        double t = seconds([&]() { label = DS::parallelConnectedComponents(n, edges, n_threads); });
+        ok = ok && countComponents(label) == expect;
+        std::cout << std::setw(8) << edges.size() / t / 1e6;
+    }
+    std::cout << (ok ? "" : "  MISMATCH!") << "  (" << expect << " components)" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 2000000;
+    std::size_t m = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : 2 * n;
+    unsigned max_threads = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : 8;
+    int seed = argc > 4 ? atoi(argv[4]) : 1;
+    if(n < 1 || n > INT32_MAX || max_threads < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [1 <= n < 2^31] [m] [max_threads >= 1] [seed]" << std::endl;
+        return 1;
+    }
+
+    std::cout << n << " vertices, " << m << " edges (M edges/s, including labeling), threads:";
+    for(unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        std::cout << " " << n_threads;
+    std::cout << std::endl;
+    DS::UniformRandom r(seed);
+    uint32_t vertices = static_cast<uint32_t>(n);
+    bench("uniform", vertices, makeEdges(vertices, m, false, r), max_threads);
+    bench("skewed", vertices, makeEdges(vertices, m, true, r), max_threads);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include "concurrent_disjoint_set.hpp"
+#include "disjoint_set.hpp"
+#include "../lib/uniform_random.h"
+using namespace std;
+using namespace DS;
+
+typedef vector<pair<uint32_t, uint32_t>> EdgeList;
+
+EdgeList randomEdges(uint32_t n, size_t m, int seed)
+{
+    UniformRandom r{seed};
+    EdgeList edges(m);
+    for (auto& e : edges)
+        e = make_pair(r.nextInt(0, n - 1), r.nextInt(0, n - 1));
+    return edges;
+}
+
+// Test program
+int main()
+{
+    const uint32_t N = 100000;
+    const int N_THREADS = 4;
+
+    cout << "Checking... (no more output means success)" << endl;
+
+    // 单线程时与DenseDisjSets一致
+    EdgeList edges = randomEdges(N, N / 2, 1);
+    ConcurrentDisjSets c(N);
+    DenseDisjSets d(N);
+    for (auto& e : edges)
+        if (c.unite(e.first, e.second) != d.unionSets(e.first, e.second))
+            cout << "Unite error!" << endl;
+    for (uint32_t i = 0; i + 1 < N; ++i)
+        if (c.sameSet(i, i + 1) != d.connected(i, i + 1))
+            cout << "SameSet error!" << endl;
+    if (c.countSets() != d.setCount())
+        cout << "Count error!" << endl;
+
+    // 多线程连通分量，两个顶点同属一个分量当且仅当代表顶点相同
+    for (unsigned n_threads = 1; n_threads <= 8; n_threads *= 2)
+    {
+        vector<uint32_t> label = parallelConnectedComponents(N, edges, n_threads);
+        for (uint32_t i = 0; i + 1 < N; ++i)
+            if ((label[i] == label[i + 1]) != d.connected(i, i + 1) || !d.connected(i, label[i]))
+                cout << "Components error!" << endl;
+    }
+
+    // 多个线程同时合并与查询: 每个线程合并的成功次数之和等于集合减少的个数，
+    // 同一线程看到的sameSet结果不会由真变假
+    ConcurrentDisjSets s(N);
+    edges = randomEdges(N, N, 2);
+    vector<uint32_t> merged(N_THREADS, 0);
+    vector<thread> threads;
+    for (int id = 0; id < N_THREADS; ++id)
+    {
+        threads.emplace_back([&, id]() {
+            for (size_t i = id; i < edges.size(); i += N_THREADS)
+            {
+                merged[id] += s.unite(edges[i].first, edges[i].second);
+                if (!s.sameSet(edges[i].first, edges[i].second))
+                    cout << "Concurrent sameSet error!" << endl;
+                uint32_t root = s.find(edges[i].first);
+                if (!s.sameSet(root, edges[i].second))
+                    cout << "Concurrent find error!" << endl;
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    uint32_t total = 0;
+    for (uint32_t x : merged)
+        total += x;
+    DenseDisjSets expect(N);
+    for (auto& e : edges)
+        expect.unionSets(e.first, e.second);
+    if (s.countSets() != N - total || s.countSets() != expect.setCount())
+        cout << "Concurrent count error!" << endl;
+    for (uint32_t i = 0; i + 1 < N; ++i)
+        if (s.sameSet(i, i + 1) != expect.connected(i, i + 1))
+            cout << "Concurrent result error!" << endl;
+
+    cout << "Test finished" << endl;
+    return 0;
+}
@@ -1,111 +1,194 @@
 #ifndef DISJOINT_SET_HPP
 #define DISJOINT_SET_HPP
 
+// DenseDisjSets class
+// 元素为 0 ~ n-1 的整数，所有信息存在一个int32_t数组中:
+// s_[x] >= 0 时为x的父节点，s_[x] < 0 时x为根，-s_[x] - 1 为树的秩(高度的上界)
+// 按秩合并，find用路径减半(每个经过的节点指向祖父)，迭代实现，不会因为链长而栈溢出
+//
+// CONSTRUCTION: with the initial number of elements, each in its own set
+//
+// ******************PUBLIC OPERATIONS*********************
+// uint32_t add( )            --> Add a new element in its own set, return its id
+// uint32_t find( x )         --> Return the root of the set containing x
+// bool unionSets( x, y )     --> Merge the sets containing x and y, return false if already merged
+// void link( root1, root2 )  --> Merge two distinct roots
+// bool connected( x, y )     --> Return true if x and y are in the same set
+// uint32_t size( )           --> Return the number of elements
+// uint32_t setCount( )       --> Return the number of sets
+// void reset( n )            --> n elements, each in its own set
+// ******************ERRORS********************************
+// No error checking is performed on ids
+//
 // DisjSets class
+// 任意可哈希的元素，元素先映射为连续的编号再交给DenseDisjSets，每次操作只查一次哈希表
 //
-// CONSTRUCTION: with int representing initial number of sets
+// CONSTRUCTION: with the initial elements, each in its own set
 //
 // ******************PUBLIC OPERATIONS*********************
-// void union( root1, root2 ) --> Merge two sets
-// int find( x )              --> Return set containing x
+// bool add( x )              --> Add x in its own set, return false if present
+// const Object& find( x )    --> Return the representative of the set containing x
+// bool unionSets( x, y )     --> Merge the sets containing x and y
+// bool connected( x, y )     --> Return true if x and y are in the same set
+// uint32_t id( x )           --> Return the dense id of x
+// const Object& element( id ) --> Return the element with the given id
 // ******************ERRORS********************************
-// No error checking is performed
+// find, connected and id throw IllegalArgumentException for unknown elements
 
 #include <unordered_map>
 #include <vector>
 #include <utility>
+#include <functional>
+#include <cstdint>
 #include "../lib/dsexceptions.h"
 
 namespace DS
 {
-    template <typename Object>
-    class DisjSets
+    class DenseDisjSets
     {
     public:
-        // init disjoint sets
         // 一开始所有的元素都互相独立
-        explicit DisjSets(const std::vector<Object>& elements)
+        explicit DenseDisjSets(uint32_t n = 0)
+        : s_(n, -1), sets_{n}
+        {}
+
+        void reset(uint32_t n)
         {
-            for(auto& x : elements)
-            {
-                s_[x].flag_ = true;
-                s_[x].value_.height_ = 0;
-            }
+            s_.assign(n, -1);
+            sets_ = n;
+        }
+
+        uint32_t add()
+        {
+            s_.push_back(-1);
+            ++sets_;
+            return static_cast<uint32_t>(s_.size() - 1);
         }
 
-//        // Perform a find.
-//        // Return the set containing x.
-//        const Object& find(const Object& x) const
-//        {
-//            auto iter = s_.find(x);
-//            if(iter == s_.end())
-//                throw IllegalArgumentException{};
-//            if(iter == nullptr)
-//                return s_[x];
-//            else
-//                return find(s_[x]);
-//        }
-
-        // Perform a find with path compression.
+        uint32_t size() const
+        { return static_cast<uint32_t>(s_.size()); }
+
+        uint32_t setCount() const
+        { return sets_; }
+
+        // Perform a find with path halving.
         // Return the set containing x.
-        // 使用路径压缩实时优化的find
-        const Object& find(const Object& x)
+        uint32_t find(uint32_t x)
         {
-            // 判断存在性
-            auto iter = s_.find(x); // &{x, s_[x]}
-            if(iter == s_.end())
-                throw IllegalArgumentException{};
-            // 主要流程
-            if(iter->second.flag_) // x为集合的根，返回x本身
-                return x;
-            else // 找到x所在集合的根，s[x]指向根
+            while(s_[x] >= 0)
             {
-                return iter->second.value_.root_ = find(iter->second.value_.root_);
+                int32_t parent = s_[x];
+                if(s_[parent] >= 0) // 指向祖父，路径长度减半
+                    s_[x] = s_[parent];
+                x = static_cast<uint32_t>(s_[x]);
             }
+            return x;
+        }
+
+        bool connected(uint32_t x, uint32_t y)
+        { return find(x) == find(y); }
+
+        bool unionSets(uint32_t x, uint32_t y)
+        {
+            uint32_t root1 = find(x);
+            uint32_t root2 = find(y);
+            if(root1 == root2)
+                return false;
+            link(root1, root2);
+            return true;
         }
 
         // Union two disjoint sets.
-        // For simplicity, we assume root1 and root2
-        // are distinct and represent set names.
-        // root1 is the root of set 1.
-        // root2 is the root of set 2.
-        void unionSets(const Object& root1, const Object& root2)
+        // root1 and root2 must be distinct roots.
+        void link(uint32_t root1, uint32_t root2)
         {
-            auto iter1 = s_.find(root1);
-            auto iter2 = s_.find(root2);
-            if(iter1 == s_.end() || iter2 == s_.end())
-                return;
-            // 不是根
-            if(false == iter1->second.flag_ || false == iter2->second.flag_)
-                throw IllegalArgumentException{};
-            // 主要流程
-            // root2 is deeper, make root2 new root
-            if(iter1->second.value_.height_ < iter2->second.value_.height_)
-            {
-                iter1->second.flag_ = false;
-                iter1->second.value_.root_ = root2;
-            } // root1 is deeper or equal height, make root1 new root
+            // 秩越大s_越小
+            if(s_[root2] < s_[root1]) // root2 is deeper, make root2 new root
+                s_[root1] = static_cast<int32_t>(root2);
             else
             {
-                // 如果高度相等高度，root1增高
-                if(iter1->second.value_.height_ == iter2->second.value_.height_)
-                    ++(iter1->second.value_.height_);
-                iter2->second.flag_ = false;
-                iter2->second.value_.root_ = root1;
+                if(s_[root1] == s_[root2]) // 秩相等，root1的秩加一
+                    --s_[root1];
+                s_[root2] = static_cast<int32_t>(root1);
             }
+            --sets_;
         }
+
     private:
-        union Value
+        std::vector<int32_t> s_;
+        uint32_t sets_;
+    };
+
+    template <typename Object, typename Hash = std::hash<Object>>
+    class DisjSets
+    {
+    public:
+        DisjSets() = default;
+
+        // init disjoint sets
+        // 一开始所有的元素都互相独立，重复的元素只保留一个
+        explicit DisjSets(const std::vector<Object>& elements)
+        {
+            ids_.reserve(elements.size());
+            elements_.reserve(elements.size());
+            for(auto& x : elements)
+                add(x);
+        }
+
+        bool add(const Object& x)
         {
-            int height_;
-            Object root_;
-        };
-        struct Element
+            if(!ids_.emplace(x, sets_.size()).second)
+                return false;
+            elements_.push_back(x);
+            sets_.add();
+            return true;
+        }
+
+        uint32_t size() const
+        { return sets_.size(); }
+
+        uint32_t setCount() const
+        { return sets_.setCount(); }
+
+        uint32_t id(const Object& x) const
         {
-            bool flag_; // 标记是否是根
-            Value value_;
-        };
-        std::unordered_map<Object, Element> s_;
+            auto iter = ids_.find(x);
+            if(iter == ids_.end())
+                throw IllegalArgumentException{};
+            return iter->second;
+        }
+
+        // 引用在下一次add之前有效
+        const Object& element(uint32_t id) const
+        { return elements_[id]; }
+
+        // Return the set containing x.
+        // 集合的代表元，引用在下一次add之前有效
+        const Object& find(const Object& x)
+        { return elements_[sets_.find(id(x))]; }
+
+        bool connected(const Object& x, const Object& y)
+        { return sets_.connected(id(x), id(y)); }
+
+        // Union the sets containing x and y.
+        // 有未知元素或已在同一集合时返回false
+        bool unionSets(const Object& x, const Object& y)
+        {
+            auto iter1 = ids_.find(x);
+            auto iter2 = ids_.find(y);
+            if(iter1 == ids_.end() || iter2 == ids_.end())
+                return false;
+            return sets_.unionSets(iter1->second, iter2->second);
+        }
+
+        // 底层按编号操作的并查集，批量处理时可以先把元素换成编号
+        DenseDisjSets& dense()
+        { return sets_; }
+
+    private:
+        std::unordered_map<Object, uint32_t, Hash> ids_;
+        std::vector<Object> elements_; // 编号到元素
+        DenseDisjSets sets_;
     };
 }
 
@@ -0,0 +1,172 @@
+// 并查集的合并与查找
+// n个元素，关键字为分散的64位整数，m条随机边依次合并(聚类)，然后对每个元素find一次
+//   hash per hop    每个节点存在unordered_map中，find递归，每跳一次查一次哈希表(原先的实现)
+//   DisjSets        关键字先映射为编号，每次操作查一次哈希表
+//   DenseDisjSets   直接使用编号
+// 结果用集合数和查找结果的校验和比较
+//
+// 用法: disjoint_set_benchmark [n] [m] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "disjoint_set.hpp"
+#include "../lib/uniform_random.h"
+
+// 原先的做法: 父节点存在哈希表中，按秩合并，递归的路径压缩
+class HashDisjSets
+{
+public:
+    explicit HashDisjSets(const std::vector<uint64_t>& elements)
+    : sets_(elements.size())
+    {
+        for(uint64_t x : elements)
+            s_[x] = Element{true, 0, 0};
+    }
+
+    uint64_t find(uint64_t x)
+    {
+        Element& e = s_.at(x);
+        if(e.root_flag_)
+            return x;
+        return e.parent_ = find(e.parent_);
+    }
+
+    bool unionSets(uint64_t x, uint64_t y)
+    {
+        uint64_t root1 = find(x);
+        uint64_t root2 = find(y);
+        if(root1 == root2)
+            return false;
+        Element& e1 = s_.at(root1);
+        Element& e2 = s_.at(root2);
+        if(e1.height_ < e2.height_)
+            e1 = Element{false, 0, root2};
+        else
+        {
+            if(e1.height_ == e2.height_)
+                ++e1.height_;
+            e2 = Element{false, 0, root1};
+        }
+        --sets_;
+        return true;
+    }
+
+    std::size_t setCount() const
+    { return sets_; }
+
+private:
+    struct Element
+    {
+        bool root_flag_;
+        int height_;
+        uint64_t parent_;
+    };
+    std::unordered_map<uint64_t, Element> s_;
+    std::size_t sets_;
+};
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+struct Result
+{
+    double union_time;
+    double find_time;
+    uint64_t sets;
+    uint64_t checksum; // 每个元素与其代表元是否为同一个元素的计数
+};
+
+void report(const std::string& name, const Result& r, const Result& expect, std::size_t m, std::size_t n)
+{
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << r.union_time * 1000 << std::setw(10) << m / r.union_time / 1e6
+              << std::setw(10) << r.find_time * 1000 << std::setw(10) << n / r.find_time / 1e6
+              << (r.sets == expect.sets && r.checksum == expect.checksum ? "" : "  MISMATCH!") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000000;
+    std::size_t m = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : n;
+    int seed = argc > 3 ? atoi(argv[3]) : 1;
+    if(n < 1 || n > UINT32_MAX)
+    {
+        std::cout << "usage: " << argv[0] << " [1 <= n < 2^32] [m] [seed]" << std::endl;
+        return 1;
+    }
+
+    // 编号i的关键字为keys[i]
+    std::vector<uint64_t> keys(n);
+    for(std::size_t i = 0; i < n; ++i)
+        keys[i] = (i + 1) * 0x9e3779b97f4a7c15ull;
+    DS::UniformRandom r(seed);
+    std::vector<std::pair<uint32_t, uint32_t>> edges(m);
+    for(auto& e : edges)
+    {
+        e.first = static_cast<uint32_t>(r.nextInt(0, static_cast<int>(n - 1)));
+        e.second = static_cast<uint32_t>(r.nextInt(0, static_cast<int>(n - 1)));
+    }
+    std::cout << n << " elements, " << m << " edges" << std::endl;
+    std::cout << "  " << std::left << std::setw(16) << "" << std::right << std::setw(10) << "union ms"
+              << std::setw(10) << "M/s" << std::setw(10) << "find ms" << std::setw(10) << "M/s" << std::endl;
+
+    Result dense{0, 0, 0, 0};
+    {
+        DS::DenseDisjSets ds(static_cast<uint32_t>(n));
+        dense.union_time = seconds([&]() {
+            for(auto& e : edges)
+                ds.unionSets(e.first, e.second);
+        });
+        dense.find_time = seconds([&]() {
+            for(uint32_t i = 0; i < n; ++i)
+                dense.checksum += ds.find(i) == i;
+        });
+        dense.sets = ds.setCount();
+    }
+
+    Result keyed{0, 0, 0, 0};
+    {
+        DS::DisjSets<uint64_t> ds(keys);
+        keyed.union_time = seconds([&]() {
+            for(auto& e : edges)
+                ds.unionSets(keys[e.first], keys[e.second]);
+        });
+        keyed.find_time = seconds([&]() {
+            for(uint64_t x : keys)
+                keyed.checksum += ds.find(x) == x;
+        });
+        keyed.sets = ds.setCount();
+    }
+
+    Result hashed{0, 0, 0, 0};
+    {
+        HashDisjSets ds(keys);
+        hashed.union_time = seconds([&]() {
+            for(auto& e : edges)
+                ds.unionSets(keys[e.first], keys[e.second]);
+        });
+        hashed.find_time = seconds([&]() {
+            for(uint64_t x : keys)
+                hashed.checksum += ds.find(x) == x;
+        });
+        hashed.sets = ds.setCount();
+    }
+
+    report("hash per hop", hashed, dense, m, n);
+    report("DisjSets", keyed, dense, m, n);
+    report("DenseDisjSets", dense, dense, m, n);
+    std::cout << "  " << dense.sets << " sets" << std::endl;
+    return 0;
+}
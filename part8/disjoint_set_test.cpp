@@ -1,9 +1,75 @@
 #include <iostream>
 #include <vector>
+#include <string>
 #include "disjoint_set.hpp"
+#include "../lib/uniform_random.h"
 using namespace std;
 using namespace DS;
 
+// 与朴素的标号数组比较: label[x]为x所在集合的编号，合并时改写整个集合
+void checkDense()
+{
+    const uint32_t N = 2000;
+    DenseDisjSets ds(N);
+    vector<uint32_t> label(N);
+    for (uint32_t i = 0; i < N; ++i)
+        label[i] = i;
+    UniformRandom r{7};
+    uint32_t sets = N;
+    for (int op = 0; op < 3000; ++op)
+    {
+        uint32_t x = r.nextInt(0, N - 1), y = r.nextInt(0, N - 1);
+        bool merged = label[x] != label[y];
+        if (ds.unionSets(x, y) != merged)
+            cout << "Union error!" << endl;
+        if (merged)
+        {
+            uint32_t old = label[y];
+            for (auto& l : label)
+                if (l == old)
+                    l = label[x];
+            --sets;
+        }
+        uint32_t a = r.nextInt(0, N - 1), b = r.nextInt(0, N - 1);
+        if (ds.connected(a, b) != (label[a] == label[b]))
+            cout << "Connected error!" << endl;
+    }
+    if (ds.setCount() != sets || ds.size() != N)
+        cout << "Count error!" << endl;
+
+    // 一百万个元素合并成一个集合
+    const uint32_t CHAIN = 1000000;
+    ds.reset(CHAIN);
+    for (uint32_t i = 1; i < CHAIN; ++i)
+        ds.link(ds.find(i - 1), i);
+    for (uint32_t i = 0; i < CHAIN; i += 1000)
+        if (!ds.connected(0, i))
+            cout << "Chain error!" << endl;
+    if (ds.setCount() != 1 || ds.add() != CHAIN || ds.setCount() != 2)
+        cout << "Chain count error!" << endl;
+}
+
+void checkStrings()
+{
+    vector<string> words{"apple", "pear", "plum", "fig", "kiwi", "apple"};
+    DisjSets<string> ds{words};
+    if (ds.size() != 5 || !ds.unionSets("apple", "pear") || ds.unionSets("pear", "apple") ||
+        ds.unionSets("apple", "grape") || !ds.unionSets("fig", "kiwi"))
+        cout << "String union error!" << endl;
+    if (!ds.connected("apple", "pear") || ds.connected("apple", "fig") || ds.find("pear") != ds.find("apple"))
+        cout << "String find error!" << endl;
+    if (!ds.add("grape") || ds.add("fig") || ds.setCount() != 4 || ds.element(ds.id("grape")) != "grape")
+        cout << "String add error!" << endl;
+    try
+    {
+        ds.find("melon");
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+}
+
 // Test main; all finds on same output line should be identical
 int main()
 {
@@ -37,5 +103,10 @@ int main()
     }
     cout << endl;
 
+    cout << "Checking... (no more output means success)" << endl;
+    checkDense();
+    checkStrings();
+    cout << "Test finished" << endl;
+
     return 0;
 }
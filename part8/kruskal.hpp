@@ -0,0 +1,257 @@
+#ifndef KRUSKAL_HPP
+#define KRUSKAL_HPP
+
+// Kruskal最小生成树(森林)与单链接聚类
+// 顶点为 0 ~ n-1，边为 WeightedEdge<Weight>{u, v, w}，用DenseDisjSets判断边是否成环
+//
+// kruskal( n, edges )         按权重基数排序后依次扫描
+// filterKruskal( n, edges )   快速排序式的划分: 先递归处理不大于枢轴的边，
+//                             再把较重的一半中两端已经连通的边过滤掉，只对剩下的边递归，
+//                             边远多于顶点时大部分重边不需要排序
+// 两者都返回按权重从小到大排列的生成森林
+// 权重映射为保序的无符号整数后用part7的radixSort排序，整数与浮点数权重都可以
+//
+// singleLinkage( n, forest, k )   按生成森林的边从轻到重合并，剩下k个簇时停止，返回每个顶点的簇代表
+//
+// StreamingKruskal   分批输入的边: MSF(E1 ∪ E2) = MSF(MSF(E1) ∪ E2)，
+//                    每批与当前的生成森林合并后重新求生成森林，内存为 O(n + 批大小)
+//
+// 边文件: WeightedEdge<Weight>数组的二进制形式(本机字节序)，没有文件头
+// writeEdgeFile( path, edges )   写入
+// EdgeFileReader                 按批读取
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <algorithm>
+#include "disjoint_set.hpp"
+#include "../part7/sort.hpp"
+#include "../lib/dsexceptions.h"
+
+namespace DS
+{
+    template <typename Weight>
+    struct WeightedEdge
+    {
+        uint32_t u;
+        uint32_t v;
+        Weight w;
+    };
+
+    // 权重映射为同样顺序的无符号整数
+    // 有符号整数翻转符号位；浮点数为正时翻转符号位，为负时翻转所有位
+    template <typename Weight>
+    typename std::enable_if<std::is_integral<Weight>::value, typename std::make_unsigned<Weight>::type>::type
+    orderedKey(Weight w)
+    {
+        typedef typename std::make_unsigned<Weight>::type Key;
+        const Key SIGN = std::is_signed<Weight>::value ? static_cast<Key>(Key(1) << (8 * sizeof(Key) - 1)) : 0;
+        return static_cast<Key>(static_cast<Key>(w) ^ SIGN);
+    }
+
+    inline uint32_t orderedKey(float w)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &w, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+
+    inline uint64_t orderedKey(double w)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &w, sizeof(bits));
+        return (bits & 0x8000000000000000ull) ? ~bits : bits | 0x8000000000000000ull;
+    }
+
+    // 按权重排序 [begin, end)
+    template <typename Weight>
+    void sortByWeight(typename std::vector<WeightedEdge<Weight>>::iterator begin,
+                      typename std::vector<WeightedEdge<Weight>>::iterator end)
+    {
+        radixSort(begin, end, [](const WeightedEdge<Weight>& e) { return orderedKey(e.w); });
+    }
+
+    // 按顺序扫描已排好序的边，不成环的加入forest
+    template <typename Weight>
+    void kruskalScan(typename std::vector<WeightedEdge<Weight>>::const_iterator begin,
+                     typename std::vector<WeightedEdge<Weight>>::const_iterator end,
+                     DenseDisjSets& sets, std::vector<WeightedEdge<Weight>>& forest)
+    {
+        for(auto p = begin; p != end && sets.setCount() > 1; ++p)
+            if(sets.unionSets(p->u, p->v))
+                forest.push_back(*p);
+    }
+
+    template <typename Weight>
+    std::vector<WeightedEdge<Weight>> kruskal(uint32_t n, std::vector<WeightedEdge<Weight>> edges)
+    {
+        std::vector<WeightedEdge<Weight>> forest;
+        if(n == 0)
+            return forest;
+        forest.reserve(n - 1);
+        DenseDisjSets sets(n);
+        sortByWeight<Weight>(edges.begin(), edges.end());
+        kruskalScan<Weight>(edges.begin(), edges.end(), sets, forest);
+        return forest;
+    }
+
+    // 边数不超过这个值时直接排序
+    const std::size_t FILTER_KRUSKAL_CUTOFF = 1024;
+
+    template <typename Weight>
+    void filterKruskalProcess(typename std::vector<WeightedEdge<Weight>>::iterator begin,
+                              typename std::vector<WeightedEdge<Weight>>::iterator end,
+                              DenseDisjSets& sets, std::vector<WeightedEdge<Weight>>& forest)
+    {
+        typedef WeightedEdge<Weight> Edge;
+        if(sets.setCount() <= 1)
+            return;
+        if(static_cast<std::size_t>(end - begin) <= FILTER_KRUSKAL_CUTOFF)
+        {
+            sortByWeight<Weight>(begin, end);
+            kruskalScan<Weight>(begin, end, sets, forest);
+            return;
+        }
+
+        // 三个样本的中值作为枢轴
+        auto a = orderedKey(begin->w);
+        auto b = orderedKey((begin + (end - begin) / 2)->w);
+        auto c = orderedKey((end - 1)->w);
+        auto pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        auto mid = std::partition(begin, end, [pivot](const Edge& e) { return orderedKey(e.w) <= pivot; });
+        if(mid == end)
+        {
+            // 枢轴是最大值，改为分出严格小于枢轴的边
+            mid = std::partition(begin, end, [pivot](const Edge& e) { return orderedKey(e.w) < pivot; });
+            if(mid == begin) // 所有边权重相同，不需要排序
+            {
+                kruskalScan<Weight>(begin, end, sets, forest);
+                return;
+            }
+        }
+        filterKruskalProcess<Weight>(begin, mid, sets, forest);
+        // 较重的边中两端已经连通的不可能进入生成森林
+        end = std::remove_if(mid, end, [&sets](const Edge& e) { return sets.find(e.u) == sets.find(e.v); });
+        filterKruskalProcess<Weight>(mid, end, sets, forest);
+    }
+
+    template <typename Weight>
+    std::vector<WeightedEdge<Weight>> filterKruskal(uint32_t n, std::vector<WeightedEdge<Weight>> edges)
+    {
+        std::vector<WeightedEdge<Weight>> forest;
+        if(n == 0)
+            return forest;
+        forest.reserve(n - 1);
+        DenseDisjSets sets(n);
+        filterKruskalProcess<Weight>(edges.begin(), edges.end(), sets, forest);
+        return forest;
+    }
+
+    // 单链接聚类: forest为按权重从小到大排列的生成森林，合并到剩下k个簇为止
+    // 返回每个顶点所在簇的代表顶点
+    template <typename Weight>
+    std::vector<uint32_t> singleLinkage(uint32_t n, const std::vector<WeightedEdge<Weight>>& forest, uint32_t k)
+    {
+        DenseDisjSets sets(n);
+        for(auto p = forest.begin(); p != forest.end() && sets.setCount() > k; ++p)
+            sets.unionSets(p->u, p->v);
+        std::vector<uint32_t> label(n);
+        for(uint32_t v = 0; v < n; ++v)
+            label[v] = sets.find(v);
+        return label;
+    }
+
+    // StreamingKruskal class
+    //
+    // CONSTRUCTION: with the number of vertices
+    //
+    // ******************PUBLIC OPERATIONS*********************
+    // void add( batch )          --> Merge a batch of edges into the current forest
+    // forest( )                  --> Return the spanning forest so far, in increasing weight
+    // uint64_t edgeCount( )      --> Return the number of edges added so far
+    template <typename Weight>
+    class StreamingKruskal
+    {
+    public:
+        explicit StreamingKruskal(uint32_t n)
+        : n_{n}, edges_{0}
+        {}
+
+        // batch会被用作工作空间
+        void add(std::vector<WeightedEdge<Weight>>& batch)
+        {
+            edges_ += batch.size();
+            batch.insert(batch.end(), forest_.begin(), forest_.end());
+            forest_.clear();
+            if(n_ == 0)
+                return;
+            DenseDisjSets sets(n_);
+            filterKruskalProcess<Weight>(batch.begin(), batch.end(), sets, forest_);
+        }
+
+        const std::vector<WeightedEdge<Weight>>& forest() const
+        { return forest_; }
+
+        uint64_t edgeCount() const
+        { return edges_; }
+
+    private:
+        uint32_t n_;
+        uint64_t edges_;
+        std::vector<WeightedEdge<Weight>> forest_;
+    };
+
+    // 写入失败时抛出IllegalArgumentException
+    template <typename Weight>
+    void writeEdgeFile(const std::string& path, const std::vector<WeightedEdge<Weight>>& edges)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if(file == nullptr)
+            throw IllegalArgumentException{};
+        std::size_t written = std::fwrite(edges.data(), sizeof(WeightedEdge<Weight>), edges.size(), file);
+        if(std::fclose(file) != 0 || written != edges.size())
+            throw IllegalArgumentException{};
+    }
+
+    // EdgeFileReader class
+    //
+    // CONSTRUCTION: with the path of an edge file
+    //
+    // ******************PUBLIC OPERATIONS*********************
+    // bool read( batch, max_edges )  --> Replace batch with up to max_edges edges, false at end of file
+    // ******************ERRORS********************************
+    // Throws IllegalArgumentException if the file cannot be opened
+    template <typename Weight>
+    class EdgeFileReader
+    {
+    public:
+        explicit EdgeFileReader(const std::string& path)
+        : file_{std::fopen(path.c_str(), "rb")}
+        {
+            if(file_ == nullptr)
+                throw IllegalArgumentException{};
+        }
+
+        EdgeFileReader(const EdgeFileReader& rhs) = delete;
+
+        EdgeFileReader& operator=(const EdgeFileReader& rhs) = delete;
+
+        ~EdgeFileReader()
+        { std::fclose(file_); }
+
+        bool read(std::vector<WeightedEdge<Weight>>& batch, std::size_t max_edges)
+        {
+            batch.resize(max_edges);
+            batch.resize(std::fread(batch.data(), sizeof(WeightedEdge<Weight>), max_edges, file_));
+            return !batch.empty();
+        }
+
+    private:
+        std::FILE* file_;
+    };
+}
+
+#endif //KRUSKAL_HPP
@@ -0,0 +1,110 @@
+// 最小生成树
+// n个顶点、m条随机边，权重为32位无符号整数
+//   std::sort        std::sort按权重排序后扫描
+//   kruskal          基数排序后扫描
+//   filterKruskal    划分并过滤成环的重边
+//   streaming        从边文件按批读取(每批batch条)，StreamingKruskal合并，包含读文件的时间
+// 报告每秒处理的边数，结果用生成森林的边数和总权重比较
+// 边文件写在当前目录，结束后删除
+//
+// 用法: kruskal_benchmark [n] [m] [batch] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include "kruskal.hpp"
+#include "../lib/uniform_random.h"
+
+typedef DS::WeightedEdge<uint32_t> Edge;
+typedef std::vector<Edge> EdgeList;
+
+const char* EDGE_FILE = "kruskal_benchmark_edges.bin";
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+uint64_t totalWeight(const EdgeList& forest)
+{
+    uint64_t total = 0;
+    for(auto& e : forest)
+        total += e.w;
+    return total;
+}
+
+void report(const std::string& name, double t, std::size_t m, const EdgeList& forest, const EdgeList& expect)
+{
+    bool ok = forest.size() == expect.size() && totalWeight(forest) == totalWeight(expect);
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << t * 1000 << " ms" << std::setw(10) << m / t / 1e6 << " M edges/s"
+              << (ok ? "" : "  MISMATCH!") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000000;
+    std::size_t m = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : 16 * n;
+    std::size_t batch = argc > 3 ? static_cast<std::size_t>(atol(argv[3])) : 4 * n;
+    int seed = argc > 4 ? atoi(argv[4]) : 1;
+    if(n < 2 || n > INT32_MAX || batch < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [2 <= n < 2^31] [m] [batch >= 1] [seed]" << std::endl;
+        return 1;
+    }
+
+    uint32_t vertices = static_cast<uint32_t>(n);
+    EdgeList edges(m);
+    uint64_t state = static_cast<uint64_t>(seed) * 0x9e3779b97f4a7c15ull + 1;
+    for(auto& e : edges)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        e = Edge{static_cast<uint32_t>((state >> 32) % n), static_cast<uint32_t>(state % n),
+                 static_cast<uint32_t>(state >> 16)};
+    }
+    std::cout << n << " vertices, " << m << " edges, batch " << batch << std::endl;
+
+    EdgeList expect;
+    double t = seconds([&]() {
+        EdgeList sorted = edges;
+        std::sort(sorted.begin(), sorted.end(), [](const Edge& a, const Edge& b) { return a.w < b.w; });
+        DS::DenseDisjSets sets(vertices);
+        for(auto& e : sorted)
+            if(sets.unionSets(e.u, e.v))
+                expect.push_back(e);
+    });
+    report("std::sort", t, m, expect, expect);
+
+    EdgeList forest;
+    t = seconds([&]() { forest = DS::kruskal(vertices, edges); });
+    report("kruskal", t, m, forest, expect);
+    t = seconds([&]() { forest = DS::filterKruskal(vertices, edges); });
+    report("filterKruskal", t, m, forest, expect);
+
+    DS::writeEdgeFile(EDGE_FILE, edges);
+    edges.clear();
+    edges.shrink_to_fit();
+    DS::StreamingKruskal<uint32_t> stream(vertices);
+    t = seconds([&]() {
+        DS::EdgeFileReader<uint32_t> reader(EDGE_FILE);
+        EdgeList buffer;
+        while(reader.read(buffer, batch))
+            stream.add(buffer);
+    });
+    std::remove(EDGE_FILE);
+    report("streaming", t, m, stream.forest(), expect);
+    std::cout << "  forest: " << expect.size() << " edges, weight " << totalWeight(expect) << std::endl;
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <cstdio>
+#include "kruskal.hpp"
+#include "../lib/uniform_random.h"
+using namespace std;
+using namespace DS;
+
+// Prim算法(邻接矩阵，O(n^2))求最小生成森林的总权重
+template <typename Weight>
+double primWeight(uint32_t n, const vector<WeightedEdge<Weight>>& edges)
+{
+    const double INF = numeric_limits<double>::infinity();
+    vector<vector<double>> w(n, vector<double>(n, INF));
+    for (auto& e : edges)
+        if (e.u != e.v && e.w < w[e.u][e.v])
+            w[e.u][e.v] = w[e.v][e.u] = e.w;
+    vector<double> dist(n, INF);
+    vector<bool> done(n, false);
+    double total = 0;
+    for (uint32_t round = 0; round < n; ++round)
+    {
+        uint32_t best = n;
+        for (uint32_t v = 0; v < n; ++v)
+            if (!done[v] && (best == n || dist[v] < dist[best]))
+                best = v;
+        done[best] = true;
+        if (dist[best] != INF) // 否则为新连通分量的第一个顶点
+            total += dist[best];
+        for (uint32_t v = 0; v < n; ++v)
+            if (!done[v] && w[best][v] < dist[v])
+                dist[v] = w[best][v];
+    }
+    return total;
+}
+
+template <typename Weight>
+double totalWeight(const vector<WeightedEdge<Weight>>& forest)
+{
+    double total = 0;
+    for (size_t i = 0; i < forest.size(); ++i)
+    {
+        total += forest[i].w;
+        if (i > 0 && forest[i].w < forest[i - 1].w)
+            cout << "Order error!" << endl;
+    }
+    return total;
+}
+
+// 与Prim比较总权重，与DenseDisjSets比较边数
+template <typename Weight>
+void check(uint32_t n, const vector<WeightedEdge<Weight>>& edges)
+{
+    DenseDisjSets sets(n);
+    for (auto& e : edges)
+        sets.unionSets(e.u, e.v);
+    double expect = primWeight(n, edges);
+    auto a = kruskal(n, edges);
+    auto b = filterKruskal(n, edges);
+    if (a.size() != n - sets.setCount() || b.size() != a.size())
+        cout << "Forest size error!" << endl;
+    if (totalWeight(a) != expect || totalWeight(b) != expect)
+        cout << "Weight error!" << endl;
+
+    // 分批输入，经过边文件
+    const char* PATH = "kruskal_test_edges.bin";
+    writeEdgeFile(PATH, edges);
+    StreamingKruskal<Weight> stream(n);
+    EdgeFileReader<Weight> reader(PATH);
+    vector<WeightedEdge<Weight>> batch;
+    while (reader.read(batch, 333))
+        stream.add(batch);
+    remove(PATH);
+    if (stream.edgeCount() != edges.size() || stream.forest().size() != a.size() || totalWeight(stream.forest()) != expect)
+        cout << "Streaming error!" << endl;
+}
+
+template <typename Weight>
+vector<WeightedEdge<Weight>> randomEdges(uint32_t n, size_t m, int low, int high, UniformRandom& r)
+{
+    vector<WeightedEdge<Weight>> edges(m);
+    for (auto& e : edges)
+        e = WeightedEdge<Weight>{static_cast<uint32_t>(r.nextInt(0, n - 1)), static_cast<uint32_t>(r.nextInt(0, n - 1)),
+                                 static_cast<Weight>(r.nextInt(low, high))};
+    return edges;
+}
+
+// Test program
+int main()
+{
+    UniformRandom r{3};
+
+    cout << "Checking... (no more output means success)" << endl;
+    check(300, randomEdges<uint32_t>(300, 5000, 0, 1000000, r));
+    check(300, randomEdges<int>(300, 5000, -1000, 1000, r));
+    check(300, randomEdges<uint16_t>(300, 5000, 0, 3, r)); // 大量相同的权重
+    check(500, randomEdges<int64_t>(500, 600, -5, 5, r));  // 不连通
+    auto halves = randomEdges<float>(400, 8000, -1000, 1000, r);
+    for (auto& e : halves)
+        e.w /= 4; // 分数与负数
+    check(400, halves);
+    check(200, randomEdges<double>(200, 3000, -1000000, 1000000, r));
+
+    // 单链接聚类: 直线上的三组点，组内间距1，组间间距100
+    const uint32_t N = 30;
+    vector<WeightedEdge<int>> line;
+    for (uint32_t i = 0; i + 1 < N; ++i)
+        line.push_back(WeightedEdge<int>{i, i + 1, (i + 1) % 10 == 0 ? 100 : 1});
+    auto label = singleLinkage(N, filterKruskal(N, line), 3);
+    for (uint32_t i = 0; i < N; ++i)
+        if ((label[i] == label[i / 10 * 10]) != true || (i >= 10 && label[i] == label[0]))
+            cout << "Single linkage error!" << endl;
+
+    cout << "Test finished" << endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+// 广度优先搜索
+// 两种无向图，n个顶点、约degree*n/2条随机边(每条边存两个方向)
+//   uniform     两端均匀随机
+//   rmat        R-MAT(a=0.57, b=c=0.19)，度数分布很不均匀，直径小
+// 对每个图从同一组源点出发:
+//   bfs         graph.hpp中的串行bfs(队列)
+//   parallel    ParallelBfs，线程数从1翻倍到threads，同时报告其中自底向上的层数
+// 报告平均每次的时间和MTEPS(每秒遍历的百万条边，按源点所在分量的边数计)，层数与串行结果比较
+//
+// 用法: bfs_benchmark [n] [degree] [threads] [sources] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstdlib>
+#include "parallel_bfs.hpp"
+#include "graph_generator.hpp"
+
+typedef DS::CsrGraph<uint32_t> Graph;
+using DS::XorShift;
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+Graph uniformGraph(uint32_t n, uint64_t m, XorShift& r)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> edges(m);
+    for(auto& e : edges)
+    {
+        uint64_t x = r.next();
+        e = {static_cast<uint32_t>((x >> 32) % n), static_cast<uint32_t>(x % n)};
+    }
+    return Graph::fromEdges(n, edges, true);
+}
+
+Graph rmatGraph(uint32_t n, uint64_t m, XorShift& r)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    edges.reserve(m);
+    DS::rmatEdges(n, m, r, [&edges](uint32_t u, uint32_t v) { edges.emplace_back(u, v); });
+    return Graph::fromEdges(n, edges, true);
+}
+
+// 被访问的顶点的度数之和
+uint64_t traversedEdges(const Graph& g, const std::vector<uint32_t>& level)
+{
+    uint64_t total = 0;
+    for(uint32_t v = 0; v < g.vertexCount(); ++v)
+        if(level[v] != DS::NO_VERTEX)
+            total += g.degree(v);
+    return total;
+}
+
+void report(const std::string& name, double t, uint64_t edges, bool ok, unsigned bottom_up)
+{
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << t * 1000 << " ms" << std::setw(10) << edges / t / 1e6 << " MTEPS";
+    if(bottom_up > 0)
+        std::cout << "  (" << bottom_up << " bottom-up levels)";
+    std::cout << (ok ? "" : "  MISMATCH!") << std::endl;
+}
+
+void benchmark(const std::string& name, const Graph& g, unsigned max_threads, int n_sources, XorShift& r)
+{
+    std::cout << name << ": " << g.vertexCount() << " vertices, " << g.edgeCount() << " directed edges" << std::endl;
+    std::vector<uint32_t> sources;
+    // 跳过孤立的顶点
+    while(static_cast<int>(sources.size()) < n_sources)
+    {
+        uint32_t s = static_cast<uint32_t>(r.next() % g.vertexCount());
+        if(g.degree(s) > 0)
+            sources.push_back(s);
+    }
+
+    std::vector<std::vector<uint32_t>> expect(sources.size());
+    std::vector<uint32_t> parent;
+    uint64_t edges = 0;
+    double t = seconds([&]() {
+        for(std::size_t i = 0; i < sources.size(); ++i)
+            expect[i] = DS::bfs(g, sources[i], parent);
+    });
+    for(auto& level : expect)
+        edges += traversedEdges(g, level);
+    report("bfs", t / n_sources, edges / n_sources, true, 0);
+
+    for(unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        DS::ParallelBfs<uint32_t> engine(g, threads);
+        bool ok = true;
+        unsigned bottom_up = 0;
+        t = 0;
+        for(std::size_t i = 0; i < sources.size(); ++i)
+        {
+            t += seconds([&]() { engine.run(sources[i]); });
+            ok = ok && engine.levels() == expect[i];
+            bottom_up += engine.bottomUpSteps();
+        }
+        report("parallel x" + std::to_string(threads), t / n_sources, edges / n_sources, ok,
+               (bottom_up + n_sources - 1) / n_sources);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000000;
+    std::size_t degree = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : 16;
+    unsigned hardware = std::thread::hardware_concurrency();
+    unsigned threads = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : (hardware == 0 ? 4 : hardware);
+    int n_sources = argc > 4 ? atoi(argv[4]) : 8;
+    int seed = argc > 5 ? atoi(argv[5]) : 1;
+    if(n < 2 || n > INT32_MAX || degree < 2 || threads < 1 || n_sources < 1)
+    {
+        std::cout << "usage: " << argv[0] << " [2 <= n < 2^31] [degree >= 2] [threads >= 1] [sources >= 1] [seed]"
+                  << std::endl;
+        return 1;
+    }
+
+    XorShift r{static_cast<uint64_t>(seed)};
+    uint32_t vertices = static_cast<uint32_t>(n);
+    uint64_t m = degree * n / 2;
+    benchmark("uniform", uniformGraph(vertices, m, r), threads, n_sources, r);
+    benchmark("rmat", rmatGraph(vertices, m, r), threads, n_sources, r);
+    return 0;
+}
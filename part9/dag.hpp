@@ -0,0 +1,313 @@
+#ifndef DAG_HPP
+#define DAG_HPP
+
+// 有向图的强连通分量、拓扑排序与关键路径，全部是迭代实现，百万级顶点的长链也不会栈溢出
+//
+// tarjanScc( g, component )             Tarjan，用显式栈保存(顶点, 下一条边)代替递归；
+//                                       返回分量数，分量按逆拓扑序编号(没有出边的分量为0)
+// kosarajuScc( g, reverse, component )  Kosaraju，先在g上求DFS完成序，再按完成序从后向前在反向图上搜索；
+//                                       分量按拓扑序编号
+// condensation( g, component, count )   把每个分量缩成一个顶点的DAG，重复的边只保留一条
+//
+// topologicalSort( g, order )           Kahn，返回false表示有环(order中只有不在环上也不在环之后的顶点)
+// topologicalLevels( g, n_threads )     并行的分层Kahn: 第0层为入度为0的顶点，
+//                                       删去前i层后入度变为0的顶点为第i+1层，每一层的顶点分给各线程，
+//                                       入度为原子计数；第i层就是距最远的源点i条边的顶点，同一层的顶点可以同时执行
+//                                       依赖图往往很深、大多数层很窄，每个线程至少分到LEVEL_GRAIN个顶点，窄的层由当前线程处理
+// earliestFinish( reverse, levels, cost, parent, n_threads )
+//                                       顶点v的最早完成时间 = cost[v] + 所有前驱的最早完成时间的最大值，
+//                                       按层并行计算(只读前面层的结果)，parent为取到最大值的前驱
+// criticalPath( finish, parent )        完成时间最晚的顶点及其parent链，即关键路径
+//
+// 权重不参与这些算法，任意CsrGraph<Weight>都可以
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "graph.hpp"
+#include "../lib/fork_join.h"
+#include "../lib/dsexceptions.h"
+
+namespace DS
+{
+    // 分层的拓扑序: 第i层为 order[offsets[i], offsets[i + 1])
+    // 有环时环上和环之后的顶点不出现在order中
+    struct TopologicalLevels
+    {
+        std::vector<uint32_t> order;
+        std::vector<uint64_t> offsets;
+
+        std::size_t levelCount() const
+        { return offsets.size() - 1; }
+
+        ArrayRange<uint32_t> level(std::size_t i) const
+        { return ArrayRange<uint32_t>(order.data() + offsets[i], order.data() + offsets[i + 1]); }
+    };
+
+    const std::size_t LEVEL_GRAIN = 4096;
+
+    // 处理有size个顶点的一层使用的线程数
+    inline unsigned levelThreads(unsigned n_threads, std::size_t size)
+    { return grainThreads(n_threads, size, LEVEL_GRAIN); }
+
+    template <typename Weight>
+    uint32_t tarjanScc(const CsrGraph<Weight>& g, std::vector<uint32_t>& component)
+    {
+        uint32_t n = g.vertexCount();
+        const auto& offsets = g.offsets();
+        const auto& targets = g.targets();
+        // index为DFS的访问序号(从1开始，0表示未访问)；low为能到达的栈中顶点的最小序号
+        std::vector<uint32_t> index(n, 0);
+        std::vector<uint32_t> low(n, 0);
+        std::vector<uint32_t> stack;                     // Tarjan的顶点栈
+        std::vector<std::pair<uint32_t, uint64_t>> path; // 代替递归: (顶点, 下一条要看的边)
+        component.assign(n, NO_VERTEX);
+        uint32_t next_index = 1;
+        uint32_t count = 0;
+
+        for(uint32_t root = 0; root < n; ++root)
+        {
+            if(index[root] != 0)
+                continue;
+            index[root] = low[root] = next_index++;
+            stack.push_back(root);
+            path.push_back(std::make_pair(root, offsets[root]));
+            while(!path.empty())
+            {
+                uint32_t u = path.back().first;
+                uint64_t& e = path.back().second;
+                if(e < offsets[u + 1])
+                {
+                    uint32_t v = targets[e++];
+                    if(index[v] == 0) // 相当于递归访问v
+                    {
+                        index[v] = low[v] = next_index++;
+                        stack.push_back(v);
+                        path.push_back(std::make_pair(v, offsets[v]));
+                    } else if(component[v] == NO_VERTEX) // v还在栈中
+                        low[u] = std::min(low[u], index[v]);
+                    continue;
+                }
+                // u的边都看完了，相当于递归返回
+                path.pop_back();
+                if(!path.empty())
+                    low[path.back().first] = std::min(low[path.back().first], low[u]);
+                if(low[u] == index[u]) // u是分量的根，弹出整个分量
+                {
+                    uint32_t v;
+                    do
+                    {
+                        v = stack.back();
+                        stack.pop_back();
+                        component[v] = count;
+                    } while(v != u);
+                    ++count;
+                }
+            }
+        }
+        return count;
+    }
+
+    template <typename Weight>
+    uint32_t kosarajuScc(const CsrGraph<Weight>& g, const CsrGraph<Weight>& reverse, std::vector<uint32_t>& component)
+    {
+        if(reverse.vertexCount() != g.vertexCount() || reverse.edgeCount() != g.edgeCount())
+            throw IllegalArgumentException{};
+        uint32_t n = g.vertexCount();
+        const auto& offsets = g.offsets();
+        const auto& targets = g.targets();
+
+        // 第一遍: g上的DFS完成序
+        std::vector<uint32_t> finished;
+        finished.reserve(n);
+        std::vector<bool> visited(n, false);
+        std::vector<std::pair<uint32_t, uint64_t>> path;
+        for(uint32_t root = 0; root < n; ++root)
+        {
+            if(visited[root])
+                continue;
+            visited[root] = true;
+            path.push_back(std::make_pair(root, offsets[root]));
+            while(!path.empty())
+            {
+                uint32_t u = path.back().first;
+                uint64_t& e = path.back().second;
+                if(e < offsets[u + 1])
+                {
+                    uint32_t v = targets[e++];
+                    if(!visited[v])
+                    {
+                        visited[v] = true;
+                        path.push_back(std::make_pair(v, offsets[v]));
+                    }
+                    continue;
+                }
+                path.pop_back();
+                finished.push_back(u);
+            }
+        }
+
+        // 第二遍: 按完成序从后向前，在反向图上搜索未分配的顶点，搜到的就是一个分量
+        component.assign(n, NO_VERTEX);
+        std::vector<uint32_t> stack;
+        uint32_t count = 0;
+        for(std::size_t i = n; i-- > 0;)
+        {
+            uint32_t root = finished[i];
+            if(component[root] != NO_VERTEX)
+                continue;
+            component[root] = count;
+            stack.push_back(root);
+            while(!stack.empty())
+            {
+                uint32_t u = stack.back();
+                stack.pop_back();
+                for(uint32_t v : reverse.neighbors(u))
+                    if(component[v] == NO_VERTEX)
+                    {
+                        component[v] = count;
+                        stack.push_back(v);
+                    }
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    template <typename Weight>
+    CsrGraph<> condensation(const CsrGraph<Weight>& g, const std::vector<uint32_t>& component, uint32_t count)
+    {
+        GraphBuilder<> builder;
+        builder.reserveVertices(count);
+        for(uint32_t u = 0; u < g.vertexCount(); ++u)
+            for(uint32_t v : g.neighbors(u))
+                if(component[u] != component[v])
+                    builder.addEdge(component[u], component[v]);
+        return builder.build(true);
+    }
+
+    template <typename Weight>
+    bool topologicalSort(const CsrGraph<Weight>& g, std::vector<uint32_t>& order)
+    {
+        uint32_t n = g.vertexCount();
+        std::vector<uint32_t> in_degree(n, 0);
+        for(uint32_t v : g.targets())
+            ++in_degree[v];
+        // order同时是队列，head之前的顶点已出队
+        order.clear();
+        order.reserve(n);
+        for(uint32_t v = 0; v < n; ++v)
+            if(in_degree[v] == 0)
+                order.push_back(v);
+        for(std::size_t head = 0; head < order.size(); ++head)
+            for(uint32_t v : g.neighbors(order[head]))
+                if(--in_degree[v] == 0)
+                    order.push_back(v);
+        return order.size() == n;
+    }
+
+    template <typename Weight>
+    TopologicalLevels topologicalLevels(const CsrGraph<Weight>& g, unsigned n_threads = 1)
+    {
+        n_threads = std::max(1u, n_threads);
+        uint32_t n = g.vertexCount();
+        const auto& offsets = g.offsets();
+        const auto& targets = g.targets();
+        std::vector<std::atomic<uint32_t>> in_degree(n);
+        parallelFor(n_threads, n, [&](unsigned, std::size_t begin, std::size_t end) {
+            for(std::size_t v = begin; v < end; ++v)
+                in_degree[v].store(0, std::memory_order_relaxed);
+        });
+        parallelFor(n_threads, n, [&](unsigned, std::size_t begin, std::size_t end) {
+            for(uint64_t e = offsets[begin]; e < offsets[end]; ++e)
+                in_degree[targets[e]].fetch_add(1, std::memory_order_relaxed);
+        });
+
+        // 各线程找到的下一层顶点，最后按线程顺序拼接
+        std::vector<std::vector<uint32_t>> local(n_threads);
+        TopologicalLevels levels;
+        levels.order.reserve(n);
+        levels.offsets.push_back(0);
+        auto append = [&]() {
+            for(auto& next : local)
+            {
+                levels.order.insert(levels.order.end(), next.begin(), next.end());
+                next.clear();
+            }
+            if(levels.order.size() > levels.offsets.back())
+                levels.offsets.push_back(levels.order.size());
+        };
+
+        parallelFor(n_threads, n, [&](unsigned id, std::size_t begin, std::size_t end) {
+            for(std::size_t v = begin; v < end; ++v)
+                if(in_degree[v].load(std::memory_order_relaxed) == 0)
+                    local[id].push_back(static_cast<uint32_t>(v));
+        });
+        append();
+        for(std::size_t i = 0; i < levels.levelCount(); ++i)
+        {
+            uint64_t first = levels.offsets[i];
+            uint64_t size = levels.offsets[i + 1] - first;
+            parallelFor(levelThreads(n_threads, size), size, [&](unsigned id, std::size_t begin, std::size_t end) {
+                for(std::size_t k = first + begin; k < first + end; ++k)
+                    for(uint32_t v : g.neighbors(levels.order[k]))
+                        if(in_degree[v].fetch_sub(1, std::memory_order_relaxed) == 1)
+                            local[id].push_back(v);
+            });
+            append();
+        }
+        return levels;
+    }
+
+    // cost[v]为顶点v自身的用时；levels由g的topologicalLevels得到，reverse为g的反向图
+    // 只计算levels中的顶点，其余顶点的完成时间为0、parent为NO_VERTEX
+    template <typename Weight>
+    std::vector<uint64_t> earliestFinish(const CsrGraph<Weight>& reverse, const TopologicalLevels& levels,
+                                         const std::vector<uint64_t>& cost, std::vector<uint32_t>& parent,
+                                         unsigned n_threads = 1)
+    {
+        if(cost.size() != reverse.vertexCount())
+            throw IllegalArgumentException{};
+        std::vector<uint64_t> finish(reverse.vertexCount(), 0);
+        parent.assign(reverse.vertexCount(), NO_VERTEX);
+        for(std::size_t i = 0; i < levels.levelCount(); ++i)
+        {
+            ArrayRange<uint32_t> level = levels.level(i);
+            parallelFor(levelThreads(n_threads, level.size()), level.size(), [&](unsigned, std::size_t begin, std::size_t end) {
+                for(std::size_t k = begin; k < end; ++k)
+                {
+                    uint32_t v = level[k];
+                    uint64_t start = 0;
+                    uint32_t latest = NO_VERTEX;
+                    for(uint32_t u : reverse.neighbors(v))
+                        if(latest == NO_VERTEX || finish[u] > start)
+                        {
+                            start = finish[u];
+                            latest = u;
+                        }
+                    finish[v] = start + cost[v];
+                    parent[v] = latest;
+                }
+            });
+        }
+        return finish;
+    }
+
+    // 从完成时间最晚的顶点沿parent回到起点，返回从起点开始的关键路径
+    inline std::vector<uint32_t> criticalPath(const std::vector<uint64_t>& finish, const std::vector<uint32_t>& parent)
+    {
+        std::vector<uint32_t> path;
+        if(finish.empty())
+            return path;
+        uint32_t v = static_cast<uint32_t>(std::max_element(finish.begin(), finish.end()) - finish.begin());
+        for(; v != NO_VERTEX; v = parent[v])
+            path.push_back(v);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+}
+
+#endif //DAG_HPP
@@ -0,0 +1,168 @@
+// 依赖图的拓扑排序、强连通分量与关键路径
+// 生成类似构建系统的依赖图: 顶点按生成顺序编号后随机打乱，
+// 每个顶点依赖degree个更早生成的顶点，其中80%在最近window个顶点中(同一模块内)，其余在全部更早的顶点中
+// 边u -> v表示v依赖u，每个顶点的用时为1~1000
+//   dag       上面的无环图: tarjan / kosaraju / kahn / levels xT / finish xT
+//   cyclic    再加入vertices/1000条随机的边形成环: tarjan / kosaraju / condensation
+// 每一项报告时间与执行期间operator new分配的内存峰值(不含输入的图)，最后报告进程的常驻内存峰值
+// 线程数从1翻倍到threads
+//
+// 用法: dag_benchmark [vertices] [degree] [window] [threads] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <sys/resource.h>
+#include "dag.hpp"
+#include "graph_generator.hpp"
+#include "../lib/alloc_counter.h"
+
+typedef DS::CsrGraph<> Graph;
+using DS::XorShift;
+
+// 执行func，返回时间，extra为执行期间新分配内存的峰值
+template <typename Func>
+double measure(Func func, std::size_t& extra)
+{
+    DS::AllocCounter::reset();
+    std::size_t base = DS::AllocCounter::liveBytes();
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    extra = DS::AllocCounter::peakBytes() - base;
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, double t, std::size_t bytes, const std::string& note)
+{
+    std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << t * 1000 << " ms" << std::setw(10) << bytes / 1048576.0 << " MB  " << note
+              << std::endl;
+}
+
+double megabytes(const Graph& g)
+{
+    return (g.offsets().size() * sizeof(uint64_t) + g.targets().size() * sizeof(uint32_t)) / 1048576.0;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> dependencies(uint32_t n, uint32_t degree, uint32_t window, XorShift& r)
+{
+    std::vector<uint32_t> label(n);
+    for(uint32_t i = 0; i < n; ++i)
+        label[i] = i;
+    for(uint32_t i = n - 1; i > 0; --i)
+        std::swap(label[i], label[r.next() % (i + 1)]);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    edges.reserve(static_cast<std::size_t>(n) * degree);
+    for(uint32_t v = 1; v < n; ++v)
+        for(uint32_t k = 0; k < degree; ++k)
+        {
+            uint32_t range = r.next() % 5 == 0 ? v : std::min(v, window);
+            uint32_t u = v - 1 - static_cast<uint32_t>(r.next() % range);
+            edges.emplace_back(label[u], label[v]);
+        }
+    return edges;
+}
+
+// 两种SCC的分量数相同，返回最大分量的大小
+uint32_t benchmarkScc(const Graph& g, const Graph& reverse, std::size_t& count)
+{
+    std::vector<uint32_t> tarjan, kosaraju;
+    uint32_t n_tarjan = 0, n_kosaraju = 0;
+    std::size_t bytes;
+    double t = measure([&]() { n_tarjan = DS::tarjanScc(g, tarjan); }, bytes);
+    report("tarjan", t, bytes, std::to_string(n_tarjan) + " components");
+    t = measure([&]() { n_kosaraju = DS::kosarajuScc(g, reverse, kosaraju); }, bytes);
+    report("kosaraju", t, bytes, n_kosaraju == n_tarjan ? "" : "MISMATCH!");
+    count = n_tarjan;
+    std::vector<uint32_t> size(n_tarjan, 0);
+    for(uint32_t c : tarjan)
+        ++size[c];
+    return *std::max_element(size.begin(), size.end());
+}
+
+int main(int argc, char* argv[])
+{
+    long vertices = argc > 1 ? atol(argv[1]) : 2000000;
+    int degree = argc > 2 ? atoi(argv[2]) : 4;
+    long window = argc > 3 ? atol(argv[3]) : 1000;
+    unsigned hardware = std::thread::hardware_concurrency();
+    unsigned threads = argc > 4 ? static_cast<unsigned>(atoi(argv[4])) : (hardware == 0 ? 4 : hardware);
+    int seed = argc > 5 ? atoi(argv[5]) : 1;
+    if(vertices < 2 || vertices > 100000000 || degree < 1 || window < 1 || threads < 1)
+    {
+        std::cout << "usage: " << argv[0]
+                  << " [2 <= vertices <= 100000000] [degree >= 1] [window >= 1] [threads >= 1] [seed]" << std::endl;
+        return 1;
+    }
+
+    XorShift r{static_cast<uint64_t>(seed)};
+    uint32_t n = static_cast<uint32_t>(vertices);
+    auto edges = dependencies(n, static_cast<uint32_t>(degree), static_cast<uint32_t>(window), r);
+    Graph g = Graph::fromEdges(n, edges);
+    Graph reverse = g.transpose();
+    std::vector<uint64_t> cost(n);
+    for(auto& c : cost)
+        c = 1 + r.next() % 1000;
+    std::cout << "dag: " << g.vertexCount() << " vertices, " << g.edgeCount() << " edges, " << std::fixed
+              << std::setprecision(1) << megabytes(g) << " MB per direction" << std::endl;
+    std::cout << "  " << std::left << std::setw(14) << "" << std::right << std::setw(13) << "time"
+              << std::setw(13) << "extra heap" << std::endl;
+
+    std::size_t count;
+    benchmarkScc(g, reverse, count);
+
+    std::vector<uint32_t> order;
+    std::size_t bytes;
+    bool acyclic = false;
+    double t = measure([&]() { acyclic = DS::topologicalSort(g, order); }, bytes);
+    report("kahn", t, bytes, acyclic ? "" : "MISMATCH!");
+
+    std::vector<uint64_t> expect(n, 0);
+    for(uint32_t u : order)
+    {
+        expect[u] += cost[u];
+        for(uint32_t v : g.neighbors(u))
+            expect[v] = std::max(expect[v], expect[u]);
+    }
+    for(unsigned k = 1; k <= threads; k *= 2)
+    {
+        DS::TopologicalLevels levels;
+        t = measure([&]() { levels = DS::topologicalLevels(g, k); }, bytes);
+        report("levels x" + std::to_string(k), t, bytes,
+               std::to_string(levels.levelCount()) + " levels" + (levels.order.size() == n ? "" : "  MISMATCH!"));
+
+        std::vector<uint32_t> parent;
+        std::vector<uint64_t> finish;
+        t = measure([&]() { finish = DS::earliestFinish(reverse, levels, cost, parent, k); }, bytes);
+        std::vector<uint32_t> path = DS::criticalPath(finish, parent);
+        report("finish x" + std::to_string(k), t, bytes,
+               "critical path " + std::to_string(path.size()) + " vertices, length "
+               + std::to_string(finish[path.back()]) + (finish == expect ? "" : "  MISMATCH!"));
+    }
+
+    // 随机的边约有一半与依赖方向相反，形成环
+    for(long i = 0; i < vertices / 1000; ++i)
+        edges.emplace_back(static_cast<uint32_t>(r.next() % n), static_cast<uint32_t>(r.next() % n));
+    g = Graph::fromEdges(n, edges);
+    reverse = g.transpose();
+    std::cout << "cyclic: " << g.edgeCount() << " edges" << std::endl;
+    uint32_t largest = benchmarkScc(g, reverse, count);
+    std::cout << "  largest component " << largest << " vertices" << std::endl;
+    std::vector<uint32_t> component;
+    DS::tarjanScc(g, component);
+    Graph dag;
+    t = measure([&]() { dag = DS::condensation(g, component, static_cast<uint32_t>(count)); }, bytes);
+    report("condensation", t, bytes, std::to_string(dag.edgeCount()) + " edges");
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "peak RSS " << usage.ru_maxrss / 1024.0 << " MB" << std::endl;
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "dag.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+using namespace DS;
+
+typedef CsrGraph<> Graph;
+
+Graph randomGraph(uint32_t n, uint32_t m, int seed)
+{
+    UniformRandom r{seed};
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < m; ++i)
+        edges.emplace_back(r.nextInt(0, n - 1), r.nextInt(0, n - 1));
+    return Graph::fromEdges(n, edges);
+}
+
+// 顶点打乱编号后，只有从前往后的边
+Graph randomDag(uint32_t n, uint32_t m, int seed)
+{
+    UniformRandom r{seed};
+    vector<uint32_t> label(n);
+    for (uint32_t i = 0; i < n; ++i)
+        label[i] = i;
+    for (uint32_t i = n - 1; i > 0; --i)
+        swap(label[i], label[r.nextInt(0, i)]);
+    vector<pair<uint32_t, uint32_t>> edges;
+    while (edges.size() < m)
+    {
+        uint32_t u = r.nextInt(0, n - 1), v = r.nextInt(0, n - 1);
+        if (u != v)
+            edges.emplace_back(label[min(u, v)], label[max(u, v)]);
+    }
+    return Graph::fromEdges(n, edges);
+}
+
+// 每个顶点可以到达的顶点
+vector<vector<bool>> reachable(const Graph& g)
+{
+    vector<vector<bool>> reach(g.vertexCount());
+    vector<uint32_t> parent;
+    for (uint32_t s = 0; s < g.vertexCount(); ++s)
+    {
+        vector<uint32_t> dist = bfs(g, s, parent);
+        for (uint32_t d : dist)
+            reach[s].push_back(d != NO_VERTEX);
+    }
+    return reach;
+}
+
+// 同一分量 <=> 互相可达；分量编号的顺序与分量间的边一致(Tarjan逆序，Kosaraju正序)
+void checkScc(const Graph& g, const vector<vector<bool>>& reach, const vector<uint32_t>& component,
+              uint32_t count, bool forward)
+{
+    for (uint32_t u = 0; u < g.vertexCount(); ++u)
+    {
+        if (component[u] >= count)
+            cout << "Component id error!" << endl;
+        for (uint32_t v = 0; v < g.vertexCount(); ++v)
+            if ((component[u] == component[v]) != (reach[u][v] && reach[v][u]))
+                cout << "Component error " << u << " " << v << endl;
+        for (uint32_t v : g.neighbors(u))
+            if (component[u] != component[v] && (component[u] < component[v]) != forward)
+                cout << "Component order error!" << endl;
+    }
+}
+
+// 每条边的起点都在终点之前
+void checkOrder(const Graph& g, const vector<uint32_t>& order)
+{
+    vector<uint32_t> position(g.vertexCount(), NO_VERTEX);
+    for (size_t i = 0; i < order.size(); ++i)
+        position[order[i]] = static_cast<uint32_t>(i);
+    for (uint32_t u = 0; u < g.vertexCount(); ++u)
+    {
+        if (position[u] == NO_VERTEX)
+            cout << "Order missing error!" << endl;
+        for (uint32_t v : g.neighbors(u))
+            if (position[u] >= position[v])
+                cout << "Order error!" << endl;
+    }
+}
+
+int main()
+{
+    cout << "Checking... (no more output means success)" << endl;
+
+    // 强连通分量: 与可达性比较，缩点后是DAG
+    for (int round = 0; round < 4; ++round)
+    {
+        Graph g = randomGraph(300, 150 + 150 * round, round);
+        vector<vector<bool>> reach = reachable(g);
+        vector<uint32_t> tarjan, kosaraju;
+        uint32_t count = tarjanScc(g, tarjan);
+        checkScc(g, reach, tarjan, count, false);
+        if (kosarajuScc(g, g.transpose(), kosaraju) != count)
+            cout << "Kosaraju count error!" << endl;
+        checkScc(g, reach, kosaraju, count, true);
+
+        Graph dag = condensation(g, tarjan, count);
+        vector<uint32_t> order;
+        if (dag.vertexCount() != count || !topologicalSort(dag, order))
+            cout << "Condensation error!" << endl;
+        // 无环 <=> 每个分量只有一个顶点且没有自环
+        bool acyclic = count == g.vertexCount();
+        for (uint32_t u = 0; u < g.vertexCount(); ++u)
+            for (uint32_t v : g.neighbors(u))
+                acyclic = acyclic && u != v;
+        vector<uint32_t> ignored;
+        if (topologicalSort(g, ignored) != acyclic)
+            cout << "Cycle detection error!" << endl;
+    }
+
+    // 拓扑排序与分层: 第i层的顶点距最远的源点i条边
+    for (int round = 0; round < 3; ++round)
+    {
+        Graph g = randomDag(1000, 500 + 2000 * round, 10 + round);
+        vector<uint32_t> order;
+        if (!topologicalSort(g, order))
+            cout << "Acyclic error!" << endl;
+        checkOrder(g, order);
+
+        vector<uint32_t> depth(g.vertexCount(), 0);
+        for (uint32_t u : order)
+            for (uint32_t v : g.neighbors(u))
+                depth[v] = max(depth[v], depth[u] + 1);
+        for (unsigned threads = 1; threads <= 4; ++threads)
+        {
+            TopologicalLevels levels = topologicalLevels(g, threads);
+            checkOrder(g, levels.order);
+            for (size_t i = 0; i < levels.levelCount(); ++i)
+                for (uint32_t v : levels.level(i))
+                    if (depth[v] != i)
+                        cout << "Level error!" << endl;
+        }
+
+        // 关键路径: 与按拓扑序的串行递推比较
+        UniformRandom r{round};
+        vector<uint64_t> cost(g.vertexCount());
+        for (auto& c : cost)
+            c = r.nextInt(1, 100);
+        vector<uint64_t> expect(g.vertexCount(), 0);
+        for (uint32_t u : order)
+        {
+            expect[u] += cost[u];
+            for (uint32_t v : g.neighbors(u))
+                expect[v] = max(expect[v], expect[u]);
+        }
+        Graph reverse = g.transpose();
+        vector<uint32_t> parent;
+        vector<uint64_t> finish = earliestFinish(reverse, topologicalLevels(g, 3), cost, parent, 3);
+        if (finish != expect)
+            cout << "Finish time error!" << endl;
+        vector<uint32_t> path = criticalPath(finish, parent);
+        uint64_t total = 0;
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            total += cost[path[i]];
+            if (i > 0)
+            {
+                auto nbrs = g.neighbors(path[i - 1]);
+                if (find(nbrs.begin(), nbrs.end(), path[i]) == nbrs.end())
+                    cout << "Critical path edge error!" << endl;
+            }
+        }
+        if (path.empty() || reverse.degree(path.front()) != 0
+            || total != *max_element(expect.begin(), expect.end()))
+            cout << "Critical path error!" << endl;
+    }
+
+    // 每层10000个顶点，宽度超过LEVEL_GRAIN时才会用多个线程
+    {
+        const uint32_t WIDTH = 10000, DEPTH = 4;
+        UniformRandom r{7};
+        vector<pair<uint32_t, uint32_t>> edges;
+        for (uint32_t d = 1; d < DEPTH; ++d)
+            for (uint32_t i = 0; i < WIDTH; ++i)
+                for (int k = 0; k < 3; ++k)
+                    edges.emplace_back((d - 1) * WIDTH + r.nextInt(0, WIDTH - 1), d * WIDTH + i);
+        Graph g = Graph::fromEdges(WIDTH * DEPTH, edges);
+        TopologicalLevels levels = topologicalLevels(g, 4);
+        if (levels.levelCount() != DEPTH)
+            cout << "Wide level count error!" << endl;
+        for (size_t i = 0; i < levels.levelCount(); ++i)
+            for (uint32_t v : levels.level(i))
+                if (v / WIDTH != i)
+                    cout << "Wide level error!" << endl;
+        vector<uint32_t> parent;
+        vector<uint64_t> finish = earliestFinish(g.transpose(), levels, vector<uint64_t>(g.vertexCount(), 1), parent, 4);
+        for (uint32_t v = 0; v < g.vertexCount(); ++v)
+            if (finish[v] != v / WIDTH + 1)
+                cout << "Wide finish error!" << endl;
+    }
+
+    // 有环时分层只包含环之前的顶点: 0 -> 1 -> 2 -> 3 -> 1, 0 -> 4
+    Graph cyclic = Graph::fromEdges(5, vector<pair<uint32_t, uint32_t>>{{0, 1}, {1, 2}, {2, 3}, {3, 1}, {0, 4}});
+    TopologicalLevels partial = topologicalLevels(cyclic, 2);
+    if (partial.order.size() != 2 || partial.levelCount() != 2 || partial.level(1)[0] != 4)
+        cout << "Cyclic levels error!" << endl;
+
+    // 很长的链，递归实现会栈溢出
+    const uint32_t N = 1000000;
+    vector<pair<uint32_t, uint32_t>> chain;
+    for (uint32_t i = 0; i + 1 < N; ++i)
+        chain.emplace_back(i, i + 1);
+    chain.emplace_back(N - 1, 0);
+    Graph ring = Graph::fromEdges(N, chain);
+    vector<uint32_t> component;
+    if (tarjanScc(ring, component) != 1 || kosarajuScc(ring, ring.transpose(), component) != 1)
+        cout << "Long cycle error!" << endl;
+    chain.pop_back();
+    Graph line = Graph::fromEdges(N, chain);
+    if (tarjanScc(line, component) != N || component[0] != N - 1)
+        cout << "Long chain error!" << endl;
+
+    try
+    {
+        vector<uint32_t> parent;
+        earliestFinish(line, topologicalLevels(line), vector<uint64_t>(3, 1), parent);
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+
+    cout << "Test finished" << endl;
+    return 0;
+}
@@ -0,0 +1,399 @@
+#ifndef GRAPH_HPP
+#define GRAPH_HPP
+
+// 压缩稀疏行(CSR)存储的图
+// 顶点为 0 ~ n-1 的整数，顶点v的出边终点为 targets[offsets[v], offsets[v + 1])，
+// 带权图的权重存在weights的相同位置；所有邻接表连续存放，遍历邻居就是扫描一段数组
+//
+// VertexTable<Key>     把关键字(如单词)映射为连续的编号，哈希表只存编号，关键字只存一份
+// GraphBuilder<Weight> 逐条加边，build时按起点计数排序生成CsrGraph
+// 图算法(bfs, ...)只依赖CsrGraph的数组；带权的最短路径在shortest_path.hpp
+//
+// CsrGraph<Weight>
+// ******************PUBLIC OPERATIONS*********************
+// uint32_t vertexCount( )     --> Return the number of vertices
+// uint64_t edgeCount( )       --> Return the number of (directed) edges
+// uint32_t degree( v )        --> Return the out-degree of v
+// neighbors( v )              --> Range of the targets of v's edges
+// weights( v )                --> Range of the weights of v's edges, same order as neighbors
+// bool weighted( )            --> Return true if the graph has weights
+// CsrGraph transpose( )       --> Return the graph with every edge reversed
+// fromEdges( n, edges, undirected )  --> Build from an edge list, kept in input order per vertex
+// ******************ERRORS********************************
+// Throws IllegalArgumentException if an edge refers to a vertex >= n
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include "../lib/dsexceptions.h"
+
+namespace DS
+{
+    const uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+    // 一段连续数组，可用于范围for
+    template <typename Object>
+    class ArrayRange
+    {
+    public:
+        ArrayRange(const Object* begin, const Object* end)
+        : begin_{begin}, end_{end}
+        {}
+
+        const Object* begin() const
+        { return begin_; }
+
+        const Object* end() const
+        { return end_; }
+
+        std::size_t size() const
+        { return end_ - begin_; }
+
+        const Object& operator[](std::size_t i) const
+        { return begin_[i]; }
+
+    private:
+        const Object* begin_;
+        const Object* end_;
+    };
+
+    template <typename Weight = uint32_t>
+    class CsrGraph
+    {
+    public:
+        struct Edge
+        {
+            uint32_t u;
+            uint32_t v;
+            Weight w;
+        };
+
+        CsrGraph()
+        : offsets_(1, 0)
+        {}
+
+        // offsets为 n + 1 项，weights为空表示不带权
+        CsrGraph(std::vector<uint64_t> offsets, std::vector<uint32_t> targets, std::vector<Weight> weights)
+        : offsets_(std::move(offsets)), targets_(std::move(targets)), weights_(std::move(weights))
+        {
+            if(offsets_.empty() || offsets_.back() != targets_.size() ||
+               (!weights_.empty() && weights_.size() != targets_.size()))
+                throw IllegalArgumentException{};
+        }
+
+        uint32_t vertexCount() const
+        { return static_cast<uint32_t>(offsets_.size() - 1); }
+
+        uint64_t edgeCount() const
+        { return targets_.size(); }
+
+        bool weighted() const
+        { return !weights_.empty(); }
+
+        uint32_t degree(uint32_t v) const
+        { return static_cast<uint32_t>(offsets_[v + 1] - offsets_[v]); }
+
+        ArrayRange<uint32_t> neighbors(uint32_t v) const
+        { return ArrayRange<uint32_t>(targets_.data() + offsets_[v], targets_.data() + offsets_[v + 1]); }
+
+        ArrayRange<Weight> weights(uint32_t v) const
+        { return ArrayRange<Weight>(weights_.data() + offsets_[v], weights_.data() + offsets_[v + 1]); }
+
+        // 原始数组，供需要直接按下标访问的算法使用
+        const std::vector<uint64_t>& offsets() const
+        { return offsets_; }
+
+        const std::vector<uint32_t>& targets() const
+        { return targets_; }
+
+        const std::vector<Weight>& weightArray() const
+        { return weights_; }
+
+        CsrGraph transpose() const
+        {
+            uint32_t n = vertexCount();
+            std::vector<uint64_t> offsets(n + 1, 0);
+            for(uint32_t v : targets_)
+                ++offsets[v + 1];
+            for(uint32_t v = 0; v < n; ++v)
+                offsets[v + 1] += offsets[v];
+            std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+            std::vector<uint32_t> targets(targets_.size());
+            std::vector<Weight> weights(weights_.size());
+            for(uint32_t u = 0; u < n; ++u)
+            {
+                for(uint64_t e = offsets_[u]; e < offsets_[u + 1]; ++e)
+                {
+                    uint64_t pos = next[targets_[e]]++;
+                    targets[pos] = u;
+                    if(weighted())
+                        weights[pos] = weights_[e];
+                }
+            }
+            return CsrGraph(std::move(offsets), std::move(targets), std::move(weights));
+        }
+
+        // 无权边表
+        static CsrGraph fromEdges(uint32_t n, const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                                  bool undirected = false)
+        {
+            return build(n, edges.size(), undirected, false,
+                         [&edges](std::size_t i) { return Edge{edges[i].first, edges[i].second, Weight()}; });
+        }
+
+        // 带权边表
+        static CsrGraph fromEdges(uint32_t n, const std::vector<Edge>& edges, bool undirected = false)
+        {
+            return build(n, edges.size(), undirected, true, [&edges](std::size_t i) { return edges[i]; });
+        }
+
+    private:
+        std::vector<uint64_t> offsets_; // n + 1 项
+        std::vector<uint32_t> targets_;
+        std::vector<Weight> weights_;
+
+        // 两遍计数排序: 先数每个起点的出度，再把边放到各自的位置，同一起点的边保持输入顺序
+        template <typename EdgeAt>
+        static CsrGraph build(uint32_t n, std::size_t m, bool undirected, bool weighted, EdgeAt edgeAt)
+        {
+            std::vector<uint64_t> offsets(static_cast<std::size_t>(n) + 1, 0);
+            for(std::size_t i = 0; i < m; ++i)
+            {
+                Edge e = edgeAt(i);
+                if(e.u >= n || e.v >= n)
+                    throw IllegalArgumentException{};
+                ++offsets[e.u + 1];
+                if(undirected && e.u != e.v)
+                    ++offsets[e.v + 1];
+            }
+            for(uint32_t v = 0; v < n; ++v)
+                offsets[v + 1] += offsets[v];
+            std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+            std::vector<uint32_t> targets(offsets[n]);
+            std::vector<Weight> weights(weighted ? offsets[n] : 0);
+            for(std::size_t i = 0; i < m; ++i)
+            {
+                Edge e = edgeAt(i);
+                uint64_t pos = next[e.u]++;
+                targets[pos] = e.v;
+                if(weighted)
+                    weights[pos] = e.w;
+                if(undirected && e.u != e.v)
+                {
+                    pos = next[e.v]++;
+                    targets[pos] = e.u;
+                    if(weighted)
+                        weights[pos] = e.w;
+                }
+            }
+            return CsrGraph(std::move(offsets), std::move(targets), std::move(weights));
+        }
+    };
+
+    // VertexTable class
+    // 关键字按编号顺序存在数组中，开放定址(线性探测)的哈希表只存编号
+    //
+    // ******************PUBLIC OPERATIONS*********************
+    // uint32_t intern( key )     --> Return the id of key, adding it if absent
+    // uint32_t find( key )       --> Return the id of key, NO_VERTEX if absent
+    // const Key& key( id )       --> Return the key with the given id
+    // uint32_t size( )           --> Return the number of keys
+    template <typename Key = std::string, typename Hash = std::hash<Key>>
+    class VertexTable
+    {
+    public:
+        VertexTable()
+        : slots_(16, NO_VERTEX)
+        {}
+
+        uint32_t size() const
+        { return static_cast<uint32_t>(keys_.size()); }
+
+        const Key& key(uint32_t id) const
+        { return keys_[id]; }
+
+        const std::vector<Key>& keys() const
+        { return keys_; }
+
+        uint32_t find(const Key& key) const
+        {
+            std::size_t slot = probe(key);
+            return slots_[slot];
+        }
+
+        uint32_t intern(const Key& key)
+        {
+            std::size_t slot = probe(key);
+            if(slots_[slot] != NO_VERTEX)
+                return slots_[slot];
+            if(keys_.size() >= NO_VERTEX - 1)
+                throw IllegalArgumentException{};
+            uint32_t id = static_cast<uint32_t>(keys_.size());
+            keys_.push_back(key);
+            slots_[slot] = id;
+            if(2 * keys_.size() > slots_.size()) // 装填因子不超过1/2
+                rehash();
+            return id;
+        }
+
+        void reserve(std::size_t n)
+        {
+            keys_.reserve(n);
+            std::size_t capacity = slots_.size();
+            while(capacity < 2 * n)
+                capacity *= 2;
+            if(capacity != slots_.size())
+            {
+                slots_.assign(capacity, NO_VERTEX);
+                for(uint32_t id = 0; id < keys_.size(); ++id)
+                    slots_[probe(keys_[id])] = id;
+            }
+        }
+
+    private:
+        std::vector<Key> keys_;
+        std::vector<uint32_t> slots_; // 容量为2的幂，空位为NO_VERTEX
+        Hash hash_;
+
+        // key所在的位置，不存在时为应插入的空位
+        std::size_t probe(const Key& key) const
+        {
+            std::size_t mask = slots_.size() - 1;
+            std::size_t slot = hash_(key) & mask;
+            while(slots_[slot] != NO_VERTEX && !(keys_[slots_[slot]] == key))
+                slot = (slot + 1) & mask;
+            return slot;
+        }
+
+        void rehash()
+        {
+            slots_.assign(slots_.size() * 2, NO_VERTEX);
+            for(uint32_t id = 0; id < keys_.size(); ++id)
+                slots_[probe(keys_[id])] = id;
+        }
+    };
+
+    // GraphBuilder class
+    //
+    // ******************PUBLIC OPERATIONS*********************
+    // uint32_t addVertex( )         --> Add a vertex, return its id
+    // void reserveVertices( n )     --> Make sure vertices 0 ~ n-1 exist
+    // void addEdge( u, v, w )       --> Add the directed edge u -> v
+    // void addUndirectedEdge( u, v, w ) --> Add u -> v and v -> u
+    // CsrGraph build( dedupe )      --> Build the graph; dedupe sorts each adjacency list and
+    //                                   keeps one edge per (u, v), the lightest
+    template <typename Weight = uint32_t>
+    class GraphBuilder
+    {
+    public:
+        typedef typename CsrGraph<Weight>::Edge Edge;
+
+        explicit GraphBuilder(bool weighted = false)
+        : n_{0}, weighted_{weighted}
+        {}
+
+        uint32_t addVertex()
+        { return n_++; }
+
+        void reserveVertices(uint32_t n)
+        { n_ = std::max(n_, n); }
+
+        uint32_t vertexCount() const
+        { return n_; }
+
+        std::size_t edgeCount() const
+        { return edges_.size(); }
+
+        void addEdge(uint32_t u, uint32_t v, Weight w = Weight())
+        {
+            reserveVertices(std::max(u, v) + 1);
+            edges_.push_back(Edge{u, v, w});
+        }
+
+        void addUndirectedEdge(uint32_t u, uint32_t v, Weight w = Weight())
+        {
+            addEdge(u, v, w);
+            if(u != v)
+                edges_.push_back(Edge{v, u, w});
+        }
+
+        CsrGraph<Weight> build(bool dedupe = false)
+        {
+            if(dedupe)
+            {
+                std::sort(edges_.begin(), edges_.end(), [](const Edge& a, const Edge& b) {
+                    return a.u != b.u ? a.u < b.u : (a.v != b.v ? a.v < b.v : a.w < b.w);
+                });
+                edges_.erase(std::unique(edges_.begin(), edges_.end(), [](const Edge& a, const Edge& b) {
+                    return a.u == b.u && a.v == b.v;
+                }), edges_.end());
+            }
+            if(weighted_)
+                return CsrGraph<Weight>::fromEdges(n_, edges_);
+            std::vector<std::pair<uint32_t, uint32_t>> pairs(edges_.size());
+            for(std::size_t i = 0; i < edges_.size(); ++i)
+                pairs[i] = std::make_pair(edges_[i].u, edges_[i].v);
+            return CsrGraph<Weight>::fromEdges(n_, pairs);
+        }
+
+    private:
+        uint32_t n_;
+        bool weighted_;
+        std::vector<Edge> edges_;
+    };
+
+    // 广度优先搜索，返回每个顶点到source的边数，不可达为NO_VERTEX
+    // parent[v]为BFS树中v的父节点，source与不可达的顶点为NO_VERTEX
+    // target不是NO_VERTEX时，访问到target后停止
+    template <typename Weight>
+    std::vector<uint32_t> bfs(const CsrGraph<Weight>& g, uint32_t source, std::vector<uint32_t>& parent,
+                              uint32_t target = NO_VERTEX)
+    {
+        uint32_t n = g.vertexCount();
+        std::vector<uint32_t> dist(n, NO_VERTEX);
+        parent.assign(n, NO_VERTEX);
+        // 队列就是访问顺序的数组，head之前的顶点已出队
+        std::vector<uint32_t> queue;
+        queue.reserve(n);
+        dist[source] = 0;
+        queue.push_back(source);
+        if(source == target)
+            return dist;
+        for(std::size_t head = 0; head < queue.size(); ++head)
+        {
+            uint32_t u = queue[head];
+            for(uint32_t v : g.neighbors(u))
+            {
+                if(dist[v] == NO_VERTEX)
+                {
+                    dist[v] = dist[u] + 1;
+                    parent[v] = u;
+                    if(v == target)
+                        return dist;
+                    queue.push_back(v);
+                }
+            }
+        }
+        return dist;
+    }
+
+    // 由parent数组得到source到target的路径，不可达时为空
+    inline std::vector<uint32_t> pathTo(const std::vector<uint32_t>& parent, uint32_t source, uint32_t target)
+    {
+        std::vector<uint32_t> path;
+        if(target != source && parent[target] == NO_VERTEX)
+            return path;
+        for(uint32_t v = target; v != NO_VERTEX && v != source; v = parent[v])
+            path.push_back(v);
+        path.push_back(source);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+}
+
+#endif //GRAPH_HPP
@@ -0,0 +1,61 @@
+#ifndef GRAPH_GENERATOR_HPP
+#define GRAPH_GENERATOR_HPP
+
+// 性能测试用的随机图
+//
+// XorShift                      很快的64位伪随机数，同一个seed总是生成同一个图
+// rmatEdges( n, m, r, add )     R-MAT(a=0.57, b=c=0.19)的m条边，对每条边调用add(u, v)；
+//                               每一位按概率选择邻接矩阵的四个象限之一，n不是2的幂时丢弃超出的边
+//                               度数分布很不均匀，直径小，类似社交网络
+
+#include <cstdint>
+
+namespace DS
+{
+    struct XorShift
+    {
+        uint64_t state;
+
+        // 相近的seed也得到差别很大的状态，状态不能为0
+        explicit XorShift(uint64_t seed)
+        : state{seed * 0x9e3779b97f4a7c15ull + 1}
+        {}
+
+        uint64_t next()
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+
+        // [0, 1)
+        double nextDouble()
+        { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+    };
+
+    template <typename Add>
+    void rmatEdges(uint32_t n, uint64_t m, XorShift& r, Add add)
+    {
+        int bits = 0;
+        while((uint64_t(1) << bits) < n)
+            ++bits;
+        for(uint64_t count = 0; count < m;)
+        {
+            uint32_t u = 0, v = 0;
+            for(int b = 0; b < bits; ++b)
+            {
+                double p = r.nextDouble();
+                u = u << 1 | (p >= 0.57 + 0.19);
+                v = v << 1 | ((p >= 0.57 && p < 0.57 + 0.19) || p >= 0.57 + 0.19 + 0.19);
+            }
+            if(u < n && v < n)
+            {
+                add(u, v);
+                ++count;
+            }
+        }
+    }
+}
+
+#endif //GRAPH_GENERATOR_HPP
@@ -0,0 +1,299 @@
+#ifndef GRAPH_SNAPSHOT_HPP
+#define GRAPH_SNAPSHOT_HPP
+
+// GraphSnapshot class
+// 不带权的CSR图与每个顶点的字符串关键字(如单词)的二进制快照，写入一次，之后用mmap直接使用:
+// 载入时只检查文件头，数组就是映射的文件内容，不解析、不复制，查找关键字用文件中保存的哈希表
+//
+// 文件格式(小端，每一段按8字节对齐):
+//   文件头(64字节)   magic "DSGRAPH\0", version, flags(0), n, 哈希表槽数, m, 字符串字节数,
+//                    校验和(文件头之后的所有内容), 文件大小, 保留(0)
+//   offsets          n + 1 个 uint64，顶点v的出边为 targets[offsets[v], offsets[v + 1])
+//   targets          m 个 uint32
+//   key_offsets      n + 1 个 uint64，顶点v的关键字为 strings[key_offsets[v], key_offsets[v + 1])
+//   slots            哈希表槽数(2的幂，至少为n的两倍)个 uint32，线性探测，空位为NO_VERTEX
+//   strings          所有关键字依次相连
+// 哈希函数(FNV-1a)与校验和都在这里定义，与编译器和标准库无关；只支持小端的机器
+//
+// CONSTRUCTION: with the path of a snapshot file, optionally skipping the checksum
+//
+// ******************PUBLIC OPERATIONS*********************
+// write( path, g, table )    --> Write graph g whose vertex v has key table.key( v )
+// uint32_t vertexCount( )    --> Return the number of vertices
+// uint64_t edgeCount( )      --> Return the number of (directed) edges
+// uint32_t degree( v )       --> Return the out-degree of v
+// neighbors( v )             --> Range of the targets of v's edges
+// std::string key( v )       --> Return the key of v
+// keyChars( v )              --> Range of the characters of v's key, without copying
+// uint32_t find( key )       --> Return the id of key, NO_VERTEX if absent
+// size_t fileSize( )         --> Return the size of the mapped file in bytes
+// ******************ERRORS********************************
+// Throws IllegalArgumentException if the file cannot be written, opened or mapped,
+// or if its header, size or checksum is wrong
+//
+// verify = false 时跳过校验和(不读整个文件)，此时文件内容被信任，只检查文件头与大小
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "graph.hpp"
+#include "../lib/dsexceptions.h"
+
+namespace DS
+{
+    class GraphSnapshot
+    {
+    public:
+        static const uint32_t VERSION = 1;
+
+        explicit GraphSnapshot(const std::string& path, bool verify = true)
+        : data_{nullptr}, size_{0}
+        {
+            if(!littleEndian())
+                throw IllegalArgumentException{};
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0)
+                throw IllegalArgumentException{};
+            struct stat st;
+            if(::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(Header))
+            {
+                ::close(fd);
+                throw IllegalArgumentException{};
+            }
+            size_ = static_cast<std::size_t>(st.st_size);
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if(data == MAP_FAILED)
+                throw IllegalArgumentException{};
+            data_ = static_cast<const char*>(data);
+            try
+            {
+                open(verify);
+            }
+            catch(...)
+            {
+                ::munmap(const_cast<char*>(data_), size_);
+                throw;
+            }
+        }
+
+        GraphSnapshot(const GraphSnapshot& rhs) = delete;
+
+        GraphSnapshot& operator=(const GraphSnapshot& rhs) = delete;
+
+        ~GraphSnapshot()
+        { ::munmap(const_cast<char*>(data_), size_); }
+
+        static void write(const std::string& path, const CsrGraph<>& g, const VertexTable<std::string>& table)
+        {
+            if(!littleEndian() || g.weighted() || table.size() != g.vertexCount())
+                throw IllegalArgumentException{};
+            uint32_t n = g.vertexCount();
+            Header header = makeHeader(n, slotCount(n), g.edgeCount(), 0);
+
+            std::vector<uint64_t> key_offsets(n + 1, 0);
+            for(uint32_t v = 0; v < n; ++v)
+                key_offsets[v + 1] = key_offsets[v] + table.key(v).size();
+            header.string_bytes_ = key_offsets[n];
+            std::string strings;
+            strings.reserve(header.string_bytes_);
+            for(uint32_t v = 0; v < n; ++v)
+                strings += table.key(v);
+
+            std::vector<uint32_t> slots(header.slots_, NO_VERTEX);
+            for(uint32_t v = 0; v < n; ++v)
+            {
+                std::size_t slot = hash(strings.data() + key_offsets[v], key_offsets[v + 1] - key_offsets[v]);
+                for(slot &= header.slots_ - 1; slots[slot] != NO_VERTEX; slot = (slot + 1) & (header.slots_ - 1))
+                    ;
+                slots[slot] = v;
+            }
+
+            // 各段依次相连，不足8字节的部分补0
+            std::string body;
+            append(body, g.offsets().data(), g.offsets().size() * sizeof(uint64_t));
+            append(body, g.targets().data(), g.targets().size() * sizeof(uint32_t));
+            append(body, key_offsets.data(), key_offsets.size() * sizeof(uint64_t));
+            append(body, slots.data(), slots.size() * sizeof(uint32_t));
+            append(body, strings.data(), strings.size());
+            header.checksum_ = checksum(body.data(), body.size());
+            header.file_size_ = sizeof(Header) + body.size();
+
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            if(file == nullptr)
+                throw IllegalArgumentException{};
+            bool ok = std::fwrite(&header, sizeof(Header), 1, file) == 1 &&
+                      std::fwrite(body.data(), 1, body.size(), file) == body.size();
+            if(std::fclose(file) != 0 || !ok)
+                throw IllegalArgumentException{};
+        }
+
+        uint32_t vertexCount() const
+        { return header_->n_; }
+
+        uint64_t edgeCount() const
+        { return header_->m_; }
+
+        uint32_t degree(uint32_t v) const
+        { return static_cast<uint32_t>(offsets_[v + 1] - offsets_[v]); }
+
+        ArrayRange<uint32_t> neighbors(uint32_t v) const
+        { return ArrayRange<uint32_t>(targets_ + offsets_[v], targets_ + offsets_[v + 1]); }
+
+        ArrayRange<char> keyChars(uint32_t v) const
+        { return ArrayRange<char>(strings_ + key_offsets_[v], strings_ + key_offsets_[v + 1]); }
+
+        std::string key(uint32_t v) const
+        { return std::string(strings_ + key_offsets_[v], strings_ + key_offsets_[v + 1]); }
+
+        uint32_t find(const std::string& key) const
+        {
+            uint32_t mask = header_->slots_ - 1;
+            for(std::size_t slot = hash(key.data(), key.size()) & mask;; slot = (slot + 1) & mask)
+            {
+                uint32_t v = slots_[slot];
+                if(v == NO_VERTEX)
+                    return NO_VERTEX;
+                if(key_offsets_[v + 1] - key_offsets_[v] == key.size() &&
+                   std::memcmp(strings_ + key_offsets_[v], key.data(), key.size()) == 0)
+                    return v;
+            }
+        }
+
+        std::size_t fileSize() const
+        { return size_; }
+
+    private:
+        struct Header
+        {
+            char magic_[8];
+            uint32_t version_;
+            uint32_t flags_;
+            uint32_t n_;
+            uint32_t slots_;
+            uint64_t m_;
+            uint64_t string_bytes_;
+            uint64_t checksum_;
+            uint64_t file_size_;
+            uint64_t reserved_;
+        };
+        static_assert(sizeof(Header) == 64, "snapshot header must be 64 bytes");
+
+        const char* data_;
+        std::size_t size_;
+        const Header* header_;
+        const uint64_t* offsets_;
+        const uint32_t* targets_;
+        const uint64_t* key_offsets_;
+        const uint32_t* slots_;
+        const char* strings_;
+
+        static bool littleEndian()
+        {
+            uint32_t one = 1;
+            char first;
+            std::memcpy(&first, &one, 1);
+            return first == 1;
+        }
+
+        static uint32_t slotCount(uint32_t n)
+        {
+            uint64_t slots = 16;
+            while(slots < 2 * static_cast<uint64_t>(n))
+                slots *= 2;
+            if(slots > NO_VERTEX)
+                throw IllegalArgumentException{};
+            return static_cast<uint32_t>(slots);
+        }
+
+        static Header makeHeader(uint32_t n, uint32_t slots, uint64_t m, uint64_t string_bytes)
+        {
+            Header header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic_, "DSGRAPH", 8);
+            header.version_ = VERSION;
+            header.n_ = n;
+            header.slots_ = slots;
+            header.m_ = m;
+            header.string_bytes_ = string_bytes;
+            return header;
+        }
+
+        static uint64_t padded(uint64_t bytes)
+        { return (bytes + 7) / 8 * 8; }
+
+        static void append(std::string& body, const void* data, std::size_t bytes)
+        {
+            body.append(static_cast<const char*>(data), bytes);
+            body.append(padded(bytes) - bytes, '\0');
+        }
+
+        // FNV-1a
+        static uint64_t hash(const char* key, std::size_t length)
+        {
+            uint64_t h = 0xcbf29ce484222325ull;
+            for(std::size_t i = 0; i < length; ++i)
+                h = (h ^ static_cast<unsigned char>(key[i])) * 0x100000001b3ull;
+            return h;
+        }
+
+        // 按8字节一组混合，bytes为8的倍数
+        static uint64_t checksum(const char* data, uint64_t bytes)
+        {
+            uint64_t h = 0x9e3779b97f4a7c15ull ^ bytes;
+            for(uint64_t i = 0; i < bytes; i += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, data + i, 8);
+                h ^= word * 0xbf58476d1ce4e5b9ull;
+                h = (h << 31 | h >> 33) * 0x94d049bb133111ebull;
+            }
+            return h ^ (h >> 29);
+        }
+
+        // 检查文件头与各段的大小，计算各段的位置
+        void open(bool verify)
+        {
+            header_ = reinterpret_cast<const Header*>(data_);
+            const Header& h = *header_;
+            if(std::memcmp(h.magic_, "DSGRAPH", 8) != 0 || h.version_ != VERSION || h.flags_ != 0 ||
+               h.file_size_ != size_ || h.n_ == NO_VERTEX || h.slots_ != slotCount(h.n_))
+                throw IllegalArgumentException{};
+            // 各段大小都不超过文件大小时才计算总和，不会溢出
+            uint64_t limit = size_;
+            if(h.m_ > limit || h.string_bytes_ > limit)
+                throw IllegalArgumentException{};
+            uint64_t n = h.n_;
+            uint64_t offsets_bytes = padded((n + 1) * 8);
+            uint64_t targets_bytes = padded(h.m_ * 4);
+            uint64_t slots_bytes = padded(static_cast<uint64_t>(h.slots_) * 4);
+            uint64_t strings_bytes = padded(h.string_bytes_);
+            if(sizeof(Header) + 2 * offsets_bytes + targets_bytes + slots_bytes + strings_bytes != size_)
+                throw IllegalArgumentException{};
+
+            const char* p = data_ + sizeof(Header);
+            offsets_ = reinterpret_cast<const uint64_t*>(p);
+            p += offsets_bytes;
+            targets_ = reinterpret_cast<const uint32_t*>(p);
+            p += targets_bytes;
+            key_offsets_ = reinterpret_cast<const uint64_t*>(p);
+            p += offsets_bytes;
+            slots_ = reinterpret_cast<const uint32_t*>(p);
+            p += slots_bytes;
+            strings_ = p;
+            if(offsets_[0] != 0 || offsets_[n] != h.m_ || key_offsets_[0] != 0 || key_offsets_[n] != h.string_bytes_)
+                throw IllegalArgumentException{};
+            if(verify && checksum(data_ + sizeof(Header), size_ - sizeof(Header)) != h.checksum_)
+                throw IllegalArgumentException{};
+        }
+    };
+}
+
+#endif //GRAPH_SNAPSHOT_HPP
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include "graph_snapshot.hpp"
+#include "path_query.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+using namespace DS;
+
+typedef CsrGraph<uint32_t> Graph;
+
+const char* SNAPSHOT_FILE = "graph_snapshot_test.graph";
+
+// 载入应当失败
+void expectFailure(const string& path, const string& what)
+{
+    try
+    {
+        GraphSnapshot snapshot(path);
+        cout << what << " not detected!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+}
+
+// 修改文件中的一个字节
+void patchByte(const string& path, long position, char value)
+{
+    fstream file(path, ios::in | ios::out | ios::binary);
+    file.seekp(position);
+    file.put(value);
+}
+
+int main()
+{
+    cout << "Checking... (no more output means success)" << endl;
+
+    // 随机的关键字与无向图
+    UniformRandom r{9};
+    VertexTable<string> table;
+    while (table.size() < 3000)
+    {
+        string key;
+        for (int i = r.nextInt(1, 9); i > 0; --i)
+            key += static_cast<char>('a' + r.nextInt(0, 25));
+        table.intern(key);
+    }
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (int i = 0; i < 4000; ++i)
+        edges.emplace_back(r.nextInt(0, 2999), r.nextInt(0, 2999));
+    Graph g = Graph::fromEdges(3000, edges, true);
+    GraphSnapshot::write(SNAPSHOT_FILE, g, table);
+
+    {
+        GraphSnapshot snapshot(SNAPSHOT_FILE);
+        if (snapshot.vertexCount() != g.vertexCount() || snapshot.edgeCount() != g.edgeCount())
+            cout << "Size error!" << endl;
+        for (uint32_t v = 0; v < g.vertexCount(); ++v)
+        {
+            vector<uint32_t> a(g.neighbors(v).begin(), g.neighbors(v).end());
+            vector<uint32_t> b(snapshot.neighbors(v).begin(), snapshot.neighbors(v).end());
+            if (a != b || snapshot.degree(v) != g.degree(v))
+                cout << "Neighbor error at " << v << "!" << endl;
+            if (snapshot.key(v) != table.key(v) || snapshot.keyChars(v).size() != table.key(v).size() ||
+                snapshot.find(table.key(v)) != v)
+                cout << "Key error at " << v << "!" << endl;
+        }
+        if (snapshot.find("notakey!") != NO_VERTEX || snapshot.find("") != NO_VERTEX)
+            cout << "Find error!" << endl;
+
+        // 快照上的查询与内存中的图结果相同
+        PathQuery<Graph> memory_query(g);
+        PathQuery<GraphSnapshot> snapshot_query(snapshot);
+        for (int i = 0; i < 100; ++i)
+        {
+            uint32_t s = r.nextInt(0, 2999), t = r.nextInt(0, 2999);
+            if (memory_query.bidirectional(s, t).size() != snapshot_query.bidirectional(s, t).size())
+                cout << "Query error!" << endl;
+        }
+    }
+
+    // 空图
+    GraphSnapshot::write(SNAPSHOT_FILE, Graph(), VertexTable<string>());
+    {
+        GraphSnapshot empty(SNAPSHOT_FILE);
+        if (empty.vertexCount() != 0 || empty.edgeCount() != 0 || empty.find("a") != NO_VERTEX)
+            cout << "Empty snapshot error!" << endl;
+    }
+
+    // 损坏的文件: 内容、magic、版本、长度
+    GraphSnapshot::write(SNAPSHOT_FILE, g, table);
+    patchByte(SNAPSHOT_FILE, 64 + 8 * 100 + 3, 'x');
+    expectFailure(SNAPSHOT_FILE, "Corruption");
+    {
+        GraphSnapshot unchecked(SNAPSHOT_FILE, false);
+        if (unchecked.vertexCount() != 3000)
+            cout << "Unverified load error!" << endl;
+    }
+    GraphSnapshot::write(SNAPSHOT_FILE, g, table);
+    patchByte(SNAPSHOT_FILE, 0, 'X');
+    expectFailure(SNAPSHOT_FILE, "Bad magic");
+    GraphSnapshot::write(SNAPSHOT_FILE, g, table);
+    patchByte(SNAPSHOT_FILE, 8, 2);
+    expectFailure(SNAPSHOT_FILE, "Bad version");
+    {
+        ofstream longer(SNAPSHOT_FILE, ios::binary | ios::app);
+        longer.put('\0');
+    }
+    expectFailure(SNAPSHOT_FILE, "Bad size");
+    expectFailure("no_such_dir/none.graph", "Missing file");
+    std::remove(SNAPSHOT_FILE);
+
+    try
+    {
+        GraphSnapshot::write(SNAPSHOT_FILE, g, VertexTable<string>());
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+
+    cout << "Test finished" << endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <limits>
+#include "graph.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+using namespace DS;
+
+typedef CsrGraph<uint32_t> Graph;
+
+// Bellman-Ford 求最短距离(每条边长为1)，用来检查bfs
+vector<uint64_t> bellmanFord(const Graph& g, uint32_t source)
+{
+    const uint64_t INF = numeric_limits<uint64_t>::max();
+    vector<uint64_t> dist(g.vertexCount(), INF);
+    dist[source] = 0;
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        for (uint32_t u = 0; u < g.vertexCount(); ++u)
+        {
+            if (dist[u] == INF)
+                continue;
+            for (size_t i = 0; i < g.degree(u); ++i)
+            {
+                uint64_t d = dist[u] + 1;
+                if (d < dist[g.neighbors(u)[i]])
+                {
+                    dist[g.neighbors(u)[i]] = d;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return dist;
+}
+
+// 检查parent给出的路径是图中的边，且边数等于距离
+template <typename Distance>
+void checkPath(const Graph& g, const vector<uint32_t>& parent, const vector<Distance>& dist, uint32_t source,
+               uint32_t target)
+{
+    vector<uint32_t> path = pathTo(parent, source, target);
+    if (dist[target] == numeric_limits<Distance>::max())
+    {
+        if (!path.empty())
+            cout << "Path error!" << endl;
+        return;
+    }
+    uint64_t length = 0;
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+    {
+        bool found = false;
+        for (size_t j = 0; j < g.degree(path[i]); ++j)
+            found = found || g.neighbors(path[i])[j] == path[i + 1];
+        length += found ? 1 : numeric_limits<uint32_t>::max();
+    }
+    if (path.front() != source || path.back() != target || length != static_cast<uint64_t>(dist[target]))
+        cout << "Path length error!" << endl;
+}
+
+int main()
+{
+    cout << "Checking... (no more output means success)" << endl;
+
+    // 无向带权图与转置
+    vector<Graph::Edge> edges{{0, 1, 5}, {1, 2, 1}, {0, 2, 9}, {2, 3, 2}, {4, 4, 7}};
+    Graph g = Graph::fromEdges(5, edges, true);
+    if (g.vertexCount() != 5 || g.edgeCount() != 9 || g.degree(0) != 2 || g.degree(4) != 1 || !g.weighted())
+        cout << "Build error!" << endl;
+    vector<uint32_t> parent;
+    try
+    {
+        Graph::fromEdges(2, vector<pair<uint32_t, uint32_t>>{{0, 2}});
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+
+    // 随机有向图: bfs与Bellman-Ford比较，转置两次不变
+    UniformRandom r{5};
+    const uint32_t N = 300;
+    GraphBuilder<uint32_t> builder(true);
+    for (int i = 0; i < 900; ++i)
+        builder.addEdge(r.nextInt(0, N - 1), r.nextInt(0, N - 1), r.nextInt(1, 50));
+    builder.reserveVertices(N);
+    Graph h = builder.build();
+    Graph tt = h.transpose().transpose();
+    if (tt.offsets() != h.offsets() || tt.edgeCount() != h.edgeCount())
+        cout << "Transpose error!" << endl;
+    for (uint32_t s = 0; s < N; s += 37)
+    {
+        vector<uint64_t> expect = bellmanFord(h, s);
+        vector<uint32_t> hops = bfs(h, s, parent);
+        for (uint32_t t = 0; t < N; ++t)
+            if ((hops[t] == NO_VERTEX ? numeric_limits<uint64_t>::max() : hops[t]) != expect[t])
+                cout << "BFS distance error!" << endl;
+        for (uint32_t t = 0; t < N; t += 7)
+        {
+            checkPath(h, parent, hops, s, t);
+            vector<uint32_t> early_parent;
+            vector<uint32_t> early = bfs(h, s, early_parent, t);
+            if (early[t] != hops[t] || pathTo(early_parent, s, t).size() != pathTo(parent, s, t).size())
+                cout << "BFS target error!" << endl;
+        }
+    }
+
+    // 去重: 每对顶点只保留最轻的边，邻接表有序
+    GraphBuilder<uint32_t> dup(true);
+    dup.addUndirectedEdge(0, 1, 3);
+    dup.addUndirectedEdge(1, 0, 2);
+    dup.addEdge(0, 0, 1);
+    Graph d = dup.build(true);
+    if (d.edgeCount() != 3 || d.neighbors(0)[0] != 0 || d.neighbors(0)[1] != 1 || d.weights(0)[1] != 2)
+        cout << "Dedupe error!" << endl;
+
+    // 顶点表
+    VertexTable<string> table;
+    for (int i = 0; i < 10000; ++i)
+        if (table.intern("v" + to_string(i * 7 % 10000)) != static_cast<uint32_t>(i))
+            cout << "Intern error!" << endl;
+    for (int i = 0; i < 10000; ++i)
+        if (table.intern("v" + to_string(i)) != table.find("v" + to_string(i)) ||
+            table.key(table.find("v" + to_string(i))) != "v" + to_string(i))
+            cout << "Find error!" << endl;
+    if (table.size() != 10000 || table.find("w1") != NO_VERTEX)
+        cout << "Table size error!" << endl;
+
+    cout << "Test finished" << endl;
+    return 0;
+}
@@ -0,0 +1,297 @@
+#ifndef PARALLEL_BFS_HPP
+#define PARALLEL_BFS_HPP
+
+// ParallelBfs class
+// 方向优化的并行广度优先搜索(Beamer)，每一层在两种做法中选一种:
+//   自顶向下   扫描当前层每个顶点的出边，用CAS在原子的parent数组中认领未访问的顶点
+//   自底向上   每个未访问的顶点扫描入边，只要有一个入边起点在当前层(位图)就认领并停止扫描
+// 当前层的出边多于未访问顶点入边的1/ALPHA时改为自底向上，当前层顶点少于n/BETA且在缩小时改回自顶向下
+// 自顶向下时当前层是顶点数组，自底向上时是位图；自底向上按64个顶点一组划分给线程，位图不需要原子操作
+// 线程是对象自己的WorkerTeam，多次run之间不再创建；每个线程分不到GRAIN个顶点的层只由当前线程处理
+//
+// 有向图的自底向上需要反向图(入边)，无向图(对称的CSR)传入同一个图
+// 可以有多个源点，每个顶点的层数为到最近源点的边数，源点的parent为自己
+//
+// CONSTRUCTION: with the graph, its reverse (or nothing for symmetric graphs) and the number of threads
+//
+// ******************PUBLIC OPERATIONS*********************
+// void run( source )         --> BFS from one source
+// void run( sources )        --> BFS from several sources at level 0
+// uint32_t level( v )        --> Return the level of v, NO_VERTEX if unreached
+// uint32_t parent( v )       --> Return the BFS parent of v, NO_VERTEX if unreached
+// levels( ) / parents( )     --> Return all levels / parents
+// path( target )             --> Return the vertices from a source to target, empty if unreached
+// uint32_t depth( )          --> Return the number of levels of the last run
+// unsigned bottomUpSteps( )  --> Return how many levels of the last run were bottom-up
+//
+// 同一个对象上不能同时run，不同对象可以共享同一个图
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "graph.hpp"
+#include "../lib/fork_join.h"
+
+namespace DS
+{
+    template <typename Weight = uint32_t>
+    class ParallelBfs
+    {
+    public:
+        static const uint64_t ALPHA = 14;
+        static const uint64_t BETA = 24;
+        static const std::size_t GRAIN = 1024;
+
+        ParallelBfs(const CsrGraph<Weight>& g, const CsrGraph<Weight>& reverse, unsigned n_threads = 1)
+        : g_(g), reverse_(reverse), n_threads_{std::max(1u, n_threads)}, team_(n_threads_),
+          level_(g.vertexCount(), NO_VERTEX), parent_(g.vertexCount()),
+          frontier_bits_((g.vertexCount() + 63) / 64), next_bits_(frontier_bits_.size()),
+          local_next_(n_threads_), stats_(n_threads_), depth_{0}, bottom_up_steps_{0}
+        {
+            if(reverse.vertexCount() != g.vertexCount() || reverse.edgeCount() != g.edgeCount())
+                throw IllegalArgumentException{};
+            for(auto& p : parent_)
+                p.store(NO_VERTEX, std::memory_order_relaxed);
+        }
+
+        explicit ParallelBfs(const CsrGraph<Weight>& symmetric, unsigned n_threads = 1)
+        : ParallelBfs(symmetric, symmetric, n_threads)
+        {}
+
+        ParallelBfs(const ParallelBfs& rhs) = delete;
+
+        ParallelBfs& operator=(const ParallelBfs& rhs) = delete;
+
+        void run(uint32_t source)
+        { run(std::vector<uint32_t>(1, source)); }
+
+        void run(const std::vector<uint32_t>& sources)
+        {
+            uint32_t n = g_.vertexCount();
+            // 清空一个顶点只有两次写，每个线程分到更多顶点才值得
+            team_.parallelFor(grainThreads(n_threads_, n, 16 * GRAIN), n, [this](unsigned, std::size_t begin, std::size_t end) {
+                std::fill(level_.begin() + begin, level_.begin() + end, NO_VERTEX);
+                for(std::size_t v = begin; v < end; ++v)
+                    parent_[v].store(NO_VERTEX, std::memory_order_relaxed);
+            });
+
+            // 第0层: 源点
+            Step step{0, 0, 0};
+            frontier_.clear();
+            for(uint32_t s : sources)
+            {
+                if(level_[s] != NO_VERTEX)
+                    continue;
+                level_[s] = 0;
+                parent_[s].store(s, std::memory_order_relaxed);
+                frontier_.push_back(s);
+                record(step, s);
+            }
+
+            // 未访问顶点的入边数
+            uint64_t unexplored_edges = reverse_.edgeCount() - step.in_edges_;
+            std::size_t previous_count = 0;
+            bool bottom_up = false;
+            depth_ = 0;
+            bottom_up_steps_ = 0;
+            while(step.count_ > 0)
+            {
+                if(!bottom_up && step.out_edges_ > unexplored_edges / ALPHA)
+                {
+                    bottom_up = true;
+                    queueToBits();
+                } else if(bottom_up && step.count_ < n / BETA && step.count_ < previous_count)
+                {
+                    bottom_up = false;
+                    bitsToQueue();
+                }
+                previous_count = step.count_;
+                ++depth_;
+                if(bottom_up)
+                {
+                    step = bottomUpStep(depth_);
+                    ++bottom_up_steps_;
+                } else
+                    step = topDownStep(depth_);
+                unexplored_edges -= step.in_edges_;
+            }
+        }
+
+        uint32_t level(uint32_t v) const
+        { return level_[v]; }
+
+        uint32_t parent(uint32_t v) const
+        { return parent_[v].load(std::memory_order_relaxed); }
+
+        const std::vector<uint32_t>& levels() const
+        { return level_; }
+
+        std::vector<uint32_t> parents() const
+        {
+            std::vector<uint32_t> result(parent_.size());
+            for(std::size_t v = 0; v < result.size(); ++v)
+                result[v] = parent(static_cast<uint32_t>(v));
+            return result;
+        }
+
+        std::vector<uint32_t> path(uint32_t target) const
+        {
+            std::vector<uint32_t> result;
+            if(level_[target] == NO_VERTEX)
+                return result;
+            uint32_t v = target;
+            for(; parent(v) != v; v = parent(v))
+                result.push_back(v);
+            result.push_back(v);
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+
+        uint32_t depth() const
+        { return depth_; }
+
+        unsigned bottomUpSteps() const
+        { return bottom_up_steps_; }
+
+    private:
+        // 一层新访问的顶点数以及它们的出边、入边总数
+        struct Step
+        {
+            std::size_t count_;
+            uint64_t out_edges_;
+            uint64_t in_edges_;
+        };
+
+        const CsrGraph<Weight>& g_;
+        const CsrGraph<Weight>& reverse_;
+        unsigned n_threads_;
+        WorkerTeam team_;
+        std::vector<uint32_t> level_; // 只由认领该顶点的线程写入
+        std::vector<std::atomic<uint32_t>> parent_;
+        std::vector<uint64_t> frontier_bits_;
+        std::vector<uint64_t> next_bits_;
+        std::vector<uint32_t> frontier_;
+        std::vector<std::vector<uint32_t>> local_next_; // 各线程自顶向下时发现的顶点
+        std::vector<Step> stats_; // 各线程的统计，每层只在结束时写一次；只有这一层用到的前几个有效
+        uint32_t depth_;
+        unsigned bottom_up_steps_;
+
+        void record(Step& step, uint32_t v) const
+        {
+            ++step.count_;
+            step.out_edges_ += g_.degree(v);
+            step.in_edges_ += reverse_.degree(v);
+        }
+
+        Step sumStats(unsigned threads) const
+        {
+            Step total{0, 0, 0};
+            for(unsigned id = 0; id < threads; ++id)
+            {
+                total.count_ += stats_[id].count_;
+                total.out_edges_ += stats_[id].out_edges_;
+                total.in_edges_ += stats_[id].in_edges_;
+            }
+            return total;
+        }
+
+        Step topDownStep(uint32_t depth)
+        {
+            const auto& offsets = g_.offsets();
+            const auto& targets = g_.targets();
+            unsigned threads = grainThreads(n_threads_, frontier_.size(), GRAIN);
+            team_.parallelFor(threads, frontier_.size(), [&](unsigned id, std::size_t begin, std::size_t end) {
+                std::vector<uint32_t>& next = local_next_[id];
+                Step step{0, 0, 0};
+                next.clear();
+                for(std::size_t i = begin; i < end; ++i)
+                {
+                    uint32_t u = frontier_[i];
+                    for(uint64_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                    {
+                        uint32_t v = targets[e];
+                        uint32_t expected = NO_VERTEX;
+                        if(parent_[v].load(std::memory_order_relaxed) == NO_VERTEX &&
+                           parent_[v].compare_exchange_strong(expected, u, std::memory_order_relaxed))
+                        {
+                            level_[v] = depth;
+                            next.push_back(v);
+                            record(step, v);
+                        }
+                    }
+                }
+                stats_[id] = step;
+            });
+            frontier_.clear();
+            for(unsigned id = 0; id < threads; ++id)
+                frontier_.insert(frontier_.end(), local_next_[id].begin(), local_next_[id].end());
+            return sumStats(threads);
+        }
+
+        Step bottomUpStep(uint32_t depth)
+        {
+            uint32_t n = g_.vertexCount();
+            const auto& offsets = reverse_.offsets();
+            const auto& sources = reverse_.targets();
+            // 位图的一个字是64个顶点
+            unsigned threads = grainThreads(n_threads_, frontier_bits_.size(), GRAIN / 64);
+            team_.parallelFor(threads, frontier_bits_.size(), [&](unsigned id, std::size_t begin, std::size_t end) {
+                Step step{0, 0, 0};
+                for(std::size_t w = begin; w < end; ++w)
+                {
+                    uint64_t bits = 0;
+                    uint32_t last = static_cast<uint32_t>(std::min<std::size_t>(n, 64 * (w + 1)));
+                    for(uint32_t v = static_cast<uint32_t>(64 * w); v < last; ++v)
+                    {
+                        if(level_[v] != NO_VERTEX)
+                            continue;
+                        for(uint64_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                        {
+                            uint32_t u = sources[e];
+                            if(frontier_bits_[u >> 6] >> (u & 63) & 1)
+                            {
+                                parent_[v].store(u, std::memory_order_relaxed);
+                                level_[v] = depth;
+                                bits |= uint64_t(1) << (v & 63);
+                                record(step, v);
+                                break;
+                            }
+                        }
+                    }
+                    next_bits_[w] = bits;
+                }
+                stats_[id] = step;
+            });
+            frontier_bits_.swap(next_bits_);
+            return sumStats(threads);
+        }
+
+        void queueToBits()
+        {
+            std::fill(frontier_bits_.begin(), frontier_bits_.end(), 0);
+            for(uint32_t v : frontier_)
+                frontier_bits_[v >> 6] |= uint64_t(1) << (v & 63);
+        }
+
+        void bitsToQueue()
+        {
+            frontier_.clear();
+            for(std::size_t w = 0; w < frontier_bits_.size(); ++w)
+                for(uint64_t bits = frontier_bits_[w]; bits != 0; bits &= bits - 1)
+                    frontier_.push_back(static_cast<uint32_t>(64 * w + __builtin_ctzll(bits)));
+        }
+    };
+
+    template <typename Weight>
+    const uint64_t ParallelBfs<Weight>::ALPHA;
+
+    template <typename Weight>
+    const uint64_t ParallelBfs<Weight>::BETA;
+
+    template <typename Weight>
+    const std::size_t ParallelBfs<Weight>::GRAIN;
+}
+
+#endif //PARALLEL_BFS_HPP
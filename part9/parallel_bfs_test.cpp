@@ -0,0 +1,143 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "parallel_bfs.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+using namespace DS;
+
+typedef CsrGraph<uint32_t> Graph;
+
+Graph randomGraph(uint32_t n, uint32_t m, bool undirected, int seed)
+{
+    UniformRandom r{seed};
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < m; ++i)
+        edges.emplace_back(r.nextInt(0, n - 1), r.nextInt(0, n - 1));
+    return Graph::fromEdges(n, edges, undirected);
+}
+
+// 与串行bfs比较层数，检查每个parent在上一层且有边指向该顶点，path的长度等于层数
+void check(const Graph& g, const ParallelBfs<uint32_t>& engine, const vector<uint32_t>& expect)
+{
+    for (uint32_t v = 0; v < g.vertexCount(); ++v)
+    {
+        if (engine.level(v) != expect[v])
+        {
+            cout << "Level error at " << v << "!" << endl;
+            return;
+        }
+        if (expect[v] == NO_VERTEX)
+        {
+            if (engine.parent(v) != NO_VERTEX || !engine.path(v).empty())
+                cout << "Unreached error!" << endl;
+            continue;
+        }
+        uint32_t p = engine.parent(v);
+        if (expect[v] == 0)
+        {
+            if (p != v)
+                cout << "Source parent error!" << endl;
+            continue;
+        }
+        auto nbrs = g.neighbors(p);
+        if (expect[p] + 1 != expect[v] || find(nbrs.begin(), nbrs.end(), v) == nbrs.end())
+            cout << "Parent error at " << v << "!" << endl;
+    }
+    // 最远的已访问顶点
+    uint32_t far = 0;
+    for (uint32_t v = 0; v < g.vertexCount(); ++v)
+        if (expect[v] != NO_VERTEX && (expect[far] == NO_VERTEX || expect[v] > expect[far]))
+            far = v;
+    if (engine.path(far).size() != expect[far] + 1 || engine.depth() != expect[far] + 1)
+        cout << "Path error!" << endl;
+}
+
+int main()
+{
+    cout << "Checking... (no more output means success)" << endl;
+
+    vector<uint32_t> parent;
+    for (unsigned threads = 1; threads <= 4; ++threads)
+    {
+        // 稠密的无向图会用到自底向上，稀疏的有向图一直自顶向下
+        Graph dense = randomGraph(5000, 40000, true, 7);
+        ParallelBfs<uint32_t> dense_bfs(dense, threads);
+        for (uint32_t s = 0; s < dense.vertexCount(); s += 997)
+        {
+            dense_bfs.run(s);
+            check(dense, dense_bfs, bfs(dense, s, parent));
+        }
+        if (dense_bfs.bottomUpSteps() == 0)
+            cout << "Bottom-up not used!" << endl;
+
+        Graph sparse = randomGraph(3000, 3300, false, 11);
+        Graph reverse = sparse.transpose();
+        ParallelBfs<uint32_t> sparse_bfs(sparse, reverse, threads);
+        for (uint32_t s = 0; s < sparse.vertexCount(); s += 401)
+        {
+            sparse_bfs.run(s);
+            check(sparse, sparse_bfs, bfs(sparse, s, parent));
+        }
+
+        // 有向图反复切换方向: 出度较大的有向图
+        Graph directed = randomGraph(4000, 48000, false, 13);
+        Graph directed_reverse = directed.transpose();
+        ParallelBfs<uint32_t> directed_bfs(directed, directed_reverse, threads);
+        directed_bfs.run(3);
+        check(directed, directed_bfs, bfs(directed, 3, parent));
+        if (directed_bfs.bottomUpSteps() == 0)
+            cout << "Directed bottom-up not used!" << endl;
+
+        // 多源: 层数为到各源点距离的最小值，重复的源点只算一次
+        vector<uint32_t> sources{5, 1234, 2999, 5};
+        vector<uint32_t> expect(sparse.vertexCount(), NO_VERTEX);
+        for (uint32_t s : sources)
+        {
+            vector<uint32_t> single = bfs(sparse, s, parent);
+            for (uint32_t v = 0; v < sparse.vertexCount(); ++v)
+                expect[v] = min(expect[v], single[v]);
+        }
+        sparse_bfs.run(sources);
+        check(sparse, sparse_bfs, expect);
+        vector<uint32_t> parents = sparse_bfs.parents();
+        for (uint32_t v = 0; v < sparse.vertexCount(); ++v)
+            if (parents[v] != sparse_bfs.parent(v) || sparse_bfs.levels()[v] != expect[v])
+                cout << "Parents error!" << endl;
+    }
+
+    // 顶点多的稀疏图: 切换到自底向上之前有几层超过GRAIN个顶点，自顶向下也用多个线程
+    {
+        Graph big = randomGraph(300000, 600000, false, 17);
+        Graph big_reverse = big.transpose();
+        vector<uint32_t> expect = bfs(big, 0, parent);
+        for (unsigned threads = 1; threads <= 4; threads += 3)
+        {
+            ParallelBfs<uint32_t> big_bfs(big, big_reverse, threads);
+            big_bfs.run(0);
+            check(big, big_bfs, expect);
+        }
+    }
+
+    // 边界: 没有边的图，孤立的源点
+    Graph empty = Graph::fromEdges(70, vector<pair<uint32_t, uint32_t>>{});
+    ParallelBfs<uint32_t> empty_bfs(empty, 2);
+    empty_bfs.run(69);
+    if (empty_bfs.depth() != 1 || empty_bfs.path(69).size() != 1 || empty_bfs.level(0) != NO_VERTEX)
+        cout << "Empty graph error!" << endl;
+
+    try
+    {
+        Graph g = randomGraph(10, 20, false, 1);
+        Graph other = randomGraph(11, 20, false, 1);
+        ParallelBfs<uint32_t> bad(g, other);
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+
+    cout << "Test finished" << endl;
+    return 0;
+}
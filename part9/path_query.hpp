@@ -0,0 +1,204 @@
+#ifndef PATH_QUERY_HPP
+#define PATH_QUERY_HPP
+
+// PathQuery class
+// 点到点的最短路径查询(边数)，同一个图上反复查询时不重新分配、也不清空O(V)的数组:
+// 每个顶点记一个访问标记stamp，每次查询使用新的标记值(epoch)，stamp不等于当前值的顶点就是未访问的，
+// 标记值用完时才清空一次
+//
+// bidirectional( source, target )   双向BFS，每次把顶点较少的一侧扩展一整层，
+//                                   扩展时遇到另一侧访问过的顶点就得到一条路径，取这一层中最短的
+// aStar( source, target, h )        A*搜索，h(v)为v到target边数的下界，且相邻顶点的h最多相差1(一致的)；
+//                                   h越接近真实距离访问的顶点越少，h恒为0时就是BFS
+//
+// 有向图的双向BFS需要反向图，无向图(对称的CSR)传入同一个图；
+// 一个对象不能被多个线程同时使用，每个线程用自己的PathQuery，共享同一个图
+// Graph只需要vertexCount, edgeCount与neighbors(v)，CsrGraph与GraphSnapshot都可以
+//
+// CONSTRUCTION: with the graph and its reverse (or nothing for symmetric graphs)
+//
+// ******************PUBLIC OPERATIONS*********************
+// bidirectional( source, target )    --> Return a shortest path, empty if unreachable
+// aStar( source, target, h )         --> Return a shortest path, empty if unreachable
+// uint32_t visited( )                --> Return the number of vertices visited by the last query
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include "graph.hpp"
+#include "../part6/binary_heap.hpp"
+
+namespace DS
+{
+    template <typename Graph = CsrGraph<>>
+    class PathQuery
+    {
+    public:
+        PathQuery(const Graph& g, const Graph& reverse)
+        : g_(g), reverse_(reverse), stamp_(g.vertexCount(), 0), dist_(g.vertexCount()),
+          parent_(g.vertexCount()), epoch_{0}, visited_{0}
+        {
+            if(reverse.vertexCount() != g.vertexCount() || reverse.edgeCount() != g.edgeCount())
+                throw IllegalArgumentException{};
+        }
+
+        explicit PathQuery(const Graph& symmetric)
+        : PathQuery(symmetric, symmetric)
+        {}
+
+        PathQuery(const PathQuery& rhs) = delete;
+
+        PathQuery& operator=(const PathQuery& rhs) = delete;
+
+        std::vector<uint32_t> bidirectional(uint32_t source, uint32_t target)
+        {
+            newQuery();
+            const uint32_t FORWARD = epoch_, BACKWARD = epoch_ + 1;
+            visit(source, FORWARD, source, 0);
+            if(source == target)
+                return std::vector<uint32_t>(1, source);
+            visit(target, BACKWARD, target, 0);
+            forward_.assign(1, source);
+            backward_.assign(1, target);
+
+            // 最短路径经过的边(meet_from, meet_to)，meet_from在正向一侧
+            uint32_t best = NO_VERTEX, meet_from = NO_VERTEX, meet_to = NO_VERTEX;
+            while(best == NO_VERTEX && !forward_.empty() && !backward_.empty())
+            {
+                bool forward = forward_.size() <= backward_.size();
+                std::vector<uint32_t>& frontier = forward ? forward_ : backward_;
+                const Graph& graph = forward ? g_ : reverse_;
+                uint32_t mine = forward ? FORWARD : BACKWARD;
+                uint32_t other = forward ? BACKWARD : FORWARD;
+                next_.clear();
+                for(uint32_t u : frontier)
+                {
+                    for(uint32_t v : graph.neighbors(u))
+                    {
+                        if(stamp_[v] == other)
+                        {
+                            uint32_t length = dist_[u] + 1 + dist_[v];
+                            if(length < best)
+                            {
+                                best = length;
+                                meet_from = forward ? u : v;
+                                meet_to = forward ? v : u;
+                            }
+                        } else if(stamp_[v] != mine)
+                        {
+                            visit(v, mine, u, dist_[u] + 1);
+                            next_.push_back(v);
+                        }
+                    }
+                }
+                frontier.swap(next_);
+            }
+
+            std::vector<uint32_t> path;
+            if(best == NO_VERTEX)
+                return path;
+            // 正向一侧的parent指向source，反向一侧的parent指向target
+            for(uint32_t v = meet_from; v != source; v = parent_[v])
+                path.push_back(v);
+            path.push_back(source);
+            std::reverse(path.begin(), path.end());
+            for(uint32_t v = meet_to; v != target; v = parent_[v])
+                path.push_back(v);
+            path.push_back(target);
+            return path;
+        }
+
+        template <typename Heuristic>
+        std::vector<uint32_t> aStar(uint32_t source, uint32_t target, Heuristic h)
+        {
+            newQuery();
+            // OPEN: 已发现，dist_为目前的最短距离；CLOSED: 已确定最短距离
+            const uint32_t OPEN = epoch_, CLOSED = epoch_ + 1;
+            heap_.clear();
+            visit(source, OPEN, source, 0);
+            heap_.insert(Item{static_cast<uint32_t>(h(source)), 0, source});
+            while(!heap_.empty())
+            {
+                Item item;
+                heap_.pop(item);
+                uint32_t u = item.vertex_;
+                if(stamp_[u] == CLOSED || item.dist_ != dist_[u])
+                    continue;
+                stamp_[u] = CLOSED;
+                if(u == target)
+                    break;
+                for(uint32_t v : g_.neighbors(u))
+                {
+                    if(stamp_[v] == CLOSED || (stamp_[v] == OPEN && dist_[v] <= dist_[u] + 1))
+                        continue;
+                    if(stamp_[v] != OPEN)
+                        visit(v, OPEN, u, dist_[u] + 1);
+                    else
+                    {
+                        dist_[v] = dist_[u] + 1;
+                        parent_[v] = u;
+                    }
+                    heap_.insert(Item{dist_[v] + static_cast<uint32_t>(h(v)), dist_[v], v});
+                }
+            }
+
+            std::vector<uint32_t> path;
+            if(stamp_[target] != CLOSED)
+                return path;
+            for(uint32_t v = target; v != source; v = parent_[v])
+                path.push_back(v);
+            path.push_back(source);
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        uint32_t visited() const
+        { return visited_; }
+
+    private:
+        // A*的堆项，估计总长相同时先取已走得更远的
+        struct Item
+        {
+            uint32_t estimate_;
+            uint32_t dist_;
+            uint32_t vertex_;
+
+            bool operator<(const Item& rhs) const
+            { return estimate_ < rhs.estimate_ || (estimate_ == rhs.estimate_ && dist_ > rhs.dist_); }
+        };
+
+        const Graph& g_;
+        const Graph& reverse_;
+        std::vector<uint32_t> stamp_;
+        std::vector<uint32_t> dist_;   // stamp_为当前查询的标记时有效
+        std::vector<uint32_t> parent_; // 同上
+        std::vector<uint32_t> forward_;
+        std::vector<uint32_t> backward_;
+        std::vector<uint32_t> next_;
+        BinaryHeap<Item> heap_;
+        uint32_t epoch_;   // 当前查询使用epoch_与epoch_ + 1两个标记值
+        uint32_t visited_;
+
+        void newQuery()
+        {
+            if(epoch_ >= std::numeric_limits<uint32_t>::max() - 3)
+            {
+                std::fill(stamp_.begin(), stamp_.end(), 0);
+                epoch_ = 0;
+            }
+            epoch_ += 2;
+            visited_ = 0;
+        }
+
+        void visit(uint32_t v, uint32_t mark, uint32_t parent, uint32_t dist)
+        {
+            stamp_[v] = mark;
+            parent_[v] = parent;
+            dist_[v] = dist;
+            ++visited_;
+        }
+    };
+}
+
+#endif //PATH_QUERY_HPP
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "path_query.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+using namespace DS;
+
+typedef CsrGraph<uint32_t> Graph;
+
+Graph randomGraph(uint32_t n, uint32_t m, bool undirected, int seed)
+{
+    UniformRandom r{seed};
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < m; ++i)
+        edges.emplace_back(r.nextInt(0, n - 1), r.nextInt(0, n - 1));
+    return Graph::fromEdges(n, edges, undirected);
+}
+
+// 检查路径的两端、每一步都是图中的边，长度等于bfs的距离
+void checkPath(const Graph& g, const vector<uint32_t>& path, uint32_t source, uint32_t target, uint32_t expect)
+{
+    if (expect == NO_VERTEX)
+    {
+        if (!path.empty())
+            cout << "Unreachable error!" << endl;
+        return;
+    }
+    if (path.size() != expect + 1 || path.front() != source || path.back() != target)
+    {
+        cout << "Path length error!" << endl;
+        return;
+    }
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+    {
+        auto nbrs = g.neighbors(path[i]);
+        if (find(nbrs.begin(), nbrs.end(), path[i + 1]) == nbrs.end())
+            cout << "Path edge error!" << endl;
+    }
+}
+
+int main()
+{
+    cout << "Checking... (no more output means success)" << endl;
+
+    vector<uint32_t> parent;
+    auto zero = [](uint32_t) { return 0u; };
+
+    // 随机的有向图与无向图，同一个对象上反复查询
+    for (int round = 0; round < 2; ++round)
+    {
+        bool undirected = round == 0;
+        Graph g = randomGraph(2000, 2600, undirected, 3 + round);
+        Graph reverse = g.transpose();
+        PathQuery<Graph> query(g, reverse);
+        UniformRandom r{17};
+        for (int i = 0; i < 300; ++i)
+        {
+            uint32_t s = r.nextInt(0, 1999), t = r.nextInt(0, 1999);
+            if (i % 50 == 0)
+                t = s;
+            uint32_t expect = bfs(g, s, parent)[t];
+            checkPath(g, query.bidirectional(s, t), s, t, expect);
+            checkPath(g, query.aStar(s, t, zero), s, t, expect);
+        }
+    }
+
+    // 网格上A*用曼哈顿距离，访问的顶点比双向BFS与不带启发的A*少
+    const uint32_t W = 60;
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (uint32_t y = 0; y < W; ++y)
+        for (uint32_t x = 0; x < W; ++x)
+        {
+            if (x + 1 < W && !(x == 30 && y > 5)) // 中间有一道墙
+                edges.emplace_back(y * W + x, y * W + x + 1);
+            if (y + 1 < W)
+                edges.emplace_back(y * W + x, (y + 1) * W + x);
+        }
+    Graph grid = Graph::fromEdges(W * W, edges, true);
+    PathQuery<Graph> grid_query(grid);
+    uint32_t s = 40 * W + 2, t = 45 * W + 57;
+    auto manhattan = [t](uint32_t v) {
+        return static_cast<uint32_t>(abs(int(v % W) - int(t % W)) + abs(int(v / W) - int(t / W)));
+    };
+    uint32_t expect = bfs(grid, s, parent)[t];
+    checkPath(grid, grid_query.aStar(s, t, manhattan), s, t, expect);
+    uint32_t guided = grid_query.visited();
+    checkPath(grid, grid_query.aStar(s, t, zero), s, t, expect);
+    uint32_t blind = grid_query.visited();
+    checkPath(grid, grid_query.bidirectional(s, t), s, t, expect);
+    if (guided >= blind)
+        cout << "Heuristic error!" << endl;
+
+    try
+    {
+        Graph g = randomGraph(10, 20, false, 1);
+        Graph other = randomGraph(10, 21, false, 1);
+        PathQuery<Graph> bad(g, other);
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+
+    cout << "Test finished" << endl;
+    return 0;
+}
@@ -0,0 +1,269 @@
+#ifndef SHORTEST_PATH_HPP
+#define SHORTEST_PATH_HPP
+
+// 带权图(非负整数权重)的单源最短路径
+//
+// dijkstraWith<Queue>( g, source, parent )
+// 优先队列可以替换的Dijkstra，队列的元素为(距离, 顶点):
+//   BinaryHeapQueue    BinaryHeap，距离变小时重新插入，弹出过期项时跳过(惰性删除)
+//   RadixHeapQueue     RadixHeap，同样惰性删除；Dijkstra弹出的距离单调不减，正好满足基数堆的要求
+//   PairingHeapQueue   PairingHeap，每个顶点在堆中最多一个节点，距离变小时decreaseKey
+// 返回每个顶点的距离，不可达为UNREACHABLE；parent同graph.hpp中的bfs
+// dijkstra( g, source, parent )        默认的Dijkstra，即dijkstraWith<BinaryHeapQueue>
+//
+// deltaStepping( g, source, delta, n_threads )
+// 桶宽为delta的并行delta-stepping(Meyer-Sanders，不区分轻边与重边的简化版):
+// 距离在[i * delta, (i + 1) * delta)的顶点在第i个桶中，每轮处理编号最小的非空桶，
+// 桶中的顶点分给各线程并行松弛出边，距离用CAS取最小值，变小的顶点放入线程自己的桶中；
+// 当前桶又有新顶点时再处理一轮，否则转到下一个非空桶；
+// 整个计算使用同一个WorkerTeam，每轮结束时同步；顶点少于 FRONTIER_GRAIN * 2 的轮只由当前线程处理
+// delta越小越接近Dijkstra(每轮可并行的顶点少)，越大越接近Bellman-Ford(重复松弛多)
+// 新的距离不超过当前桶的上界加最大权重，每个线程的桶用长度不小于 最大权重/delta + 2 的循环数组；
+// 这个长度超过RING_LIMIT时更远的桶放在map中，只保存非空的桶，内存与距离的范围无关；只返回距离，不记录parent
+//
+// 权重必须是无符号整数；图不带权时抛出IllegalArgumentException
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <map>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include "graph.hpp"
+#include "../part6/binary_heap.hpp"
+#include "../part6/radix_heap.hpp"
+#include "../part12/pairing_heap.hpp"
+#include "../lib/fork_join.h"
+#include "../lib/dsexceptions.h"
+
+namespace DS
+{
+    const uint64_t UNREACHABLE = std::numeric_limits<uint64_t>::max();
+
+    typedef std::pair<uint64_t, uint32_t> DistanceItem;
+
+    // delta-stepping每个线程至少分到的顶点数
+    const std::size_t FRONTIER_GRAIN = 1024;
+
+    // 惰性删除的队列，Heap的元素为DistanceItem
+    template <typename Heap>
+    class LazyQueue
+    {
+    public:
+        explicit LazyQueue(uint32_t)
+        {}
+
+        bool empty() const
+        { return heap_.empty(); }
+
+        // 加入或减小v的距离
+        void push(uint32_t v, uint64_t d)
+        { heap_.insert(DistanceItem(d, v)); }
+
+        // 可能弹出过期项，由调用者与当前距离比较后跳过
+        void pop(uint32_t& v, uint64_t& d)
+        {
+            DistanceItem item;
+            heap_.pop(item);
+            d = item.first;
+            v = item.second;
+        }
+
+    private:
+        Heap heap_;
+    };
+
+    // decreaseKey的队列，pos_记录每个顶点在堆中的位置
+    class PairingHeapQueue
+    {
+    public:
+        typedef PairingHeap<DistanceItem> Heap;
+
+        explicit PairingHeapQueue(uint32_t n)
+        : pos_(n, NO_VERTEX)
+        {}
+
+        bool empty() const
+        { return heap_.empty(); }
+
+        void push(uint32_t v, uint64_t d)
+        {
+            if(pos_[v] == NO_VERTEX)
+                pos_[v] = heap_.insert(DistanceItem(d, v));
+            else
+                heap_.decreaseKey(pos_[v], DistanceItem(d, v));
+        }
+
+        void pop(uint32_t& v, uint64_t& d)
+        {
+            DistanceItem item;
+            heap_.pop(item);
+            d = item.first;
+            v = item.second;
+            pos_[v] = NO_VERTEX;
+        }
+
+    private:
+        Heap heap_;
+        std::vector<Heap::Position> pos_; // 不在堆中为NO_VERTEX
+    };
+
+    typedef LazyQueue<BinaryHeap<DistanceItem>> BinaryHeapQueue;
+    typedef LazyQueue<RadixHeap<DistanceItem>> RadixHeapQueue;
+
+    template <typename Queue, typename Weight>
+    std::vector<uint64_t> dijkstraWith(const CsrGraph<Weight>& g, uint32_t source, std::vector<uint32_t>& parent)
+    {
+        static_assert(std::is_unsigned<Weight>::value, "shortest paths need unsigned integer weights");
+        if(!g.weighted() && g.edgeCount() != 0)
+            throw IllegalArgumentException{};
+        uint32_t n = g.vertexCount();
+        std::vector<uint64_t> dist(n, UNREACHABLE);
+        parent.assign(n, NO_VERTEX);
+        Queue queue(n);
+        dist[source] = 0;
+        queue.push(source, 0);
+        const auto& offsets = g.offsets();
+        const auto& targets = g.targets();
+        const auto& weights = g.weightArray();
+        while(!queue.empty())
+        {
+            uint32_t u;
+            uint64_t d;
+            queue.pop(u, d);
+            if(d != dist[u])
+                continue;
+            for(uint64_t e = offsets[u]; e < offsets[u + 1]; ++e)
+            {
+                uint64_t candidate = d + weights[e];
+                uint32_t v = targets[e];
+                if(candidate < dist[v])
+                {
+                    dist[v] = candidate;
+                    parent[v] = u;
+                    queue.push(v, candidate);
+                }
+            }
+        }
+        return dist;
+    }
+
+    template <typename Weight>
+    std::vector<uint64_t> dijkstra(const CsrGraph<Weight>& g, uint32_t source, std::vector<uint32_t>& parent)
+    { return dijkstraWith<BinaryHeapQueue>(g, source, parent); }
+
+    template <typename Weight>
+    std::vector<uint64_t> deltaStepping(const CsrGraph<Weight>& g, uint32_t source, uint64_t delta,
+                                        unsigned n_threads = 1)
+    {
+        static_assert(std::is_unsigned<Weight>::value, "shortest paths need unsigned integer weights");
+        if((!g.weighted() && g.edgeCount() != 0) || delta == 0)
+            throw IllegalArgumentException{};
+        n_threads = std::max(1u, n_threads);
+        uint32_t n = g.vertexCount();
+        WorkerTeam team(n_threads);
+        std::vector<std::atomic<uint64_t>> dist(n);
+        team.parallelFor(grainThreads(n_threads, n, FRONTIER_GRAIN), n, [&dist](unsigned, std::size_t begin, std::size_t end) {
+            for(std::size_t v = begin; v < end; ++v)
+                dist[v].store(UNREACHABLE, std::memory_order_relaxed);
+        });
+        dist[source].store(0, std::memory_order_relaxed);
+
+        const auto& offsets = g.offsets();
+        const auto& targets = g.targets();
+        const auto& weights = g.weightArray();
+        // 松弛得到的距离不超过 当前桶的上界 + 最大权重，桶编号在[bin, bin + ring)之内，
+        // 这些桶放在长为ring的循环数组中；ring超过RING_LIMIT时(权重相对delta很大)更远的桶放在map中
+        Weight max_weight = 0;
+        for(Weight w : weights)
+            max_weight = std::max(max_weight, w);
+        const uint64_t RING_LIMIT = 4096;
+        uint64_t ring = 1; // 取2的幂，用位与代替取模
+        while(ring < RING_LIMIT && ring < max_weight / delta + 2)
+            ring *= 2;
+        const uint64_t MASK = ring - 1;
+        struct Bins
+        {
+            std::vector<std::vector<uint32_t>> near;         // 编号为i的桶在near[i & MASK]
+            std::map<uint64_t, std::vector<uint32_t>> far;   // 放入时编号不小于bin + ring的桶，只保存非空的
+        };
+        std::vector<Bins> bins(n_threads); // 每个线程自己的桶
+        for(auto& local : bins)
+            local.near.resize(ring);
+        std::vector<uint32_t> frontier(1, source);
+        uint64_t bin = 0;
+        while(true)
+        {
+            std::size_t size = frontier.size();
+            team.parallelFor(grainThreads(n_threads, size, FRONTIER_GRAIN), size, [&](unsigned id, std::size_t begin, std::size_t end) {
+                Bins& local = bins[id];
+                for(std::size_t i = begin; i < end; ++i)
+                {
+                    uint32_t u = frontier[i];
+                    uint64_t du = dist[u].load(std::memory_order_relaxed);
+                    if(du / delta != bin) // 距离已经变小，在之前的桶中处理过
+                        continue;
+                    for(uint64_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                    {
+                        uint32_t v = targets[e];
+                        uint64_t candidate = du + weights[e];
+                        uint64_t old = dist[v].load(std::memory_order_relaxed);
+                        while(candidate < old)
+                        {
+                            if(dist[v].compare_exchange_weak(old, candidate, std::memory_order_relaxed))
+                            {
+                                uint64_t index = candidate / delta;
+                                if(index - bin < ring)
+                                    local.near[index & MASK].push_back(v);
+                                else
+                                    local.far[index].push_back(v);
+                                break;
+                            }
+                        }
+                    }
+                }
+            });
+
+            // 下一个桶: 各线程中编号不小于bin的最小非空桶
+            uint64_t next = UNREACHABLE;
+            for(auto& local : bins)
+            {
+                for(uint64_t b = bin; b < bin + ring && b < next; ++b)
+                    if(!local.near[b & MASK].empty())
+                    {
+                        next = b;
+                        break;
+                    }
+                if(!local.far.empty())
+                    next = std::min(next, local.far.begin()->first);
+            }
+            if(next == UNREACHABLE)
+                break;
+            // [bin, next)的桶都是空的，循环数组中的位置可以留给[bin + ring, next + ring)
+            bin = next;
+            frontier.clear();
+            for(auto& local : bins)
+            {
+                std::vector<uint32_t>& slot = local.near[bin & MASK];
+                frontier.insert(frontier.end(), slot.begin(), slot.end());
+                slot.clear();
+                auto it = local.far.find(bin);
+                if(it != local.far.end())
+                {
+                    frontier.insert(frontier.end(), it->second.begin(), it->second.end());
+                    local.far.erase(it);
+                }
+            }
+        }
+
+        std::vector<uint64_t> result(n);
+        for(uint32_t v = 0; v < n; ++v)
+            result[v] = dist[v].load(std::memory_order_relaxed);
+        return result;
+    }
+}
+
+#endif //SHORTEST_PATH_HPP
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <vector>
+#include "shortest_path.hpp"
+#include "../lib/uniform_random.h"
+
+using namespace std;
+using namespace DS;
+
+typedef CsrGraph<uint32_t> Graph;
+
+// Bellman-Ford 求最短距离
+vector<uint64_t> bellmanFord(const Graph& g, uint32_t source)
+{
+    vector<uint64_t> dist(g.vertexCount(), UNREACHABLE);
+    dist[source] = 0;
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        for (uint32_t u = 0; u < g.vertexCount(); ++u)
+        {
+            if (dist[u] == UNREACHABLE)
+                continue;
+            for (size_t i = 0; i < g.degree(u); ++i)
+            {
+                uint64_t d = dist[u] + g.weights(u)[i];
+                if (d < dist[g.neighbors(u)[i]])
+                {
+                    dist[g.neighbors(u)[i]] = d;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return dist;
+}
+
+// parent给出的每一步都是图中的边，且距离之差等于边的权重
+void checkParents(const Graph& g, const vector<uint64_t>& dist, const vector<uint32_t>& parent, uint32_t source)
+{
+    for (uint32_t v = 0; v < g.vertexCount(); ++v)
+    {
+        if (v == source || dist[v] == UNREACHABLE)
+        {
+            if (parent[v] != NO_VERTEX)
+                cout << "Parent error!" << endl;
+            continue;
+        }
+        uint32_t u = parent[v];
+        bool found = false;
+        for (size_t i = 0; i < g.degree(u) && !found; ++i)
+            found = g.neighbors(u)[i] == v && dist[u] + g.weights(u)[i] == dist[v];
+        if (!found)
+            cout << "Parent edge error at " << v << "!" << endl;
+    }
+}
+
+int main()
+{
+    cout << "Checking... (no more output means success)" << endl;
+
+    // 无向图，4只有自环不可达
+    {
+        Graph g = Graph::fromEdges(5, vector<Graph::Edge>{{0, 1, 5}, {1, 2, 1}, {0, 2, 9}, {2, 3, 2}, {4, 4, 7}}, true);
+        vector<uint32_t> parent;
+        vector<uint64_t> dist = dijkstra(g, 0, parent);
+        if (dist != vector<uint64_t>{0, 5, 6, 8, UNREACHABLE} || pathTo(parent, 0, 3) != vector<uint32_t>{0, 1, 2, 3})
+            cout << "Dijkstra error!" << endl;
+    }
+
+    // 随机有向图，权重包括0，不是所有顶点都可达
+    // 最后一轮权重到100000，delta小时一部分桶超出循环数组
+    UniformRandom r{21};
+    const int MAX_WEIGHT[] = {3, 1000, 1000, 100000};
+    for (int round = 0; round < 4; ++round)
+    {
+        const uint32_t N = 400;
+        vector<Graph::Edge> edges;
+        for (int i = 0; i < 1600; ++i)
+            edges.push_back(Graph::Edge{static_cast<uint32_t>(r.nextInt(0, N - 1)),
+                                        static_cast<uint32_t>(r.nextInt(0, N - 1)),
+                                        static_cast<uint32_t>(r.nextInt(0, MAX_WEIGHT[round]))});
+        Graph g = Graph::fromEdges(N, edges, round == 2);
+        for (uint32_t s = 0; s < N; s += 57)
+        {
+            vector<uint64_t> expect = bellmanFord(g, s);
+            vector<uint32_t> parent;
+            vector<uint64_t> dist = dijkstraWith<BinaryHeapQueue>(g, s, parent);
+            if (dist != expect)
+                cout << "BinaryHeap error!" << endl;
+            checkParents(g, dist, parent, s);
+            dist = dijkstraWith<PairingHeapQueue>(g, s, parent);
+            if (dist != expect)
+                cout << "PairingHeap error!" << endl;
+            checkParents(g, dist, parent, s);
+            dist = dijkstraWith<RadixHeapQueue>(g, s, parent);
+            if (dist != expect)
+                cout << "RadixHeap error!" << endl;
+            checkParents(g, dist, parent, s);
+            for (uint64_t delta : {1, 7, 100, 5000})
+                for (unsigned threads = 1; threads <= 4; threads += 3)
+                    if (deltaStepping(g, s, delta, threads) != expect)
+                        cout << "Delta-stepping error (delta " << delta << ", " << threads << " threads)!" << endl;
+        }
+    }
+
+    // 顶点多、delta大时每轮的顶点超过FRONTIER_GRAIN，多个线程一起松弛
+    {
+        const uint32_t N = 30000;
+        vector<Graph::Edge> edges;
+        for (int i = 0; i < 240000; ++i)
+            edges.push_back(Graph::Edge{static_cast<uint32_t>(r.nextInt(0, N - 1)),
+                                        static_cast<uint32_t>(r.nextInt(0, N - 1)),
+                                        static_cast<uint32_t>(r.nextInt(1, 100))});
+        Graph g = Graph::fromEdges(N, edges, true);
+        vector<uint32_t> parent;
+        vector<uint64_t> expect = dijkstraWith<RadixHeapQueue>(g, 0, parent);
+        for (unsigned threads = 1; threads <= 4; ++threads)
+            if (deltaStepping(g, 0, 50, threads) != expect)
+                cout << "Wide delta-stepping error (" << threads << " threads)!" << endl;
+    }
+
+    // 权重很大、delta很小时桶的编号很大，只有非空的桶占内存
+    {
+        Graph g = Graph::fromEdges(3, vector<Graph::Edge>{{0, 1, 4000000000u}, {1, 2, 4000000000u}});
+        vector<uint64_t> expect{0, 4000000000ull, 8000000000ull};
+        for (unsigned threads = 1; threads <= 2; ++threads)
+            if (deltaStepping(g, 0, 1, threads) != expect)
+                cout << "Large weight delta-stepping error!" << endl;
+    }
+
+    // 不带权的图与delta为0
+    Graph unweighted = Graph::fromEdges(3, vector<pair<uint32_t, uint32_t>>{{0, 1}});
+    vector<uint32_t> parent;
+    try
+    {
+        dijkstraWith<BinaryHeapQueue>(unweighted, 0, parent);
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+    try
+    {
+        Graph g = Graph::fromEdges(2, vector<Graph::Edge>{{0, 1, 1}});
+        deltaStepping(g, 0, 0);
+        cout << "Exception error!" << endl;
+    }
+    catch (const IllegalArgumentException&)
+    {
+    }
+
+    cout << "Test finished" << endl;
+    return 0;
+}
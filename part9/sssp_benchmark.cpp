@@ -0,0 +1,147 @@
+// 单源最短路径
+// 两种带权无向图:
+//   grid       side*side的网格，每个顶点与上下左右相连，权重1~1000，直径大(类似道路网)
+//   rmat       R-MAT(a=0.57, b=c=0.19)，n=side*side个顶点、约degree*n/2条边，权重1~255，度数分布很不均匀
+// 对每个图从同一组源点出发:
+//   dijkstra          dijkstra，即dijkstraWith<BinaryHeapQueue>(惰性删除)
+//   pairing/radix     dijkstraWith的另两种队列
+//   delta xT          deltaStepping，T个线程，线程数从1翻倍到threads
+// 报告平均每次的时间，距离与dijkstra比较
+// delta为0时每个图使用 权重上限 * 2 / 平均度数 (至少为1)
+//
+// 用法: sssp_benchmark [side] [degree] [threads] [sources] [delta] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "shortest_path.hpp"
+#include "graph_generator.hpp"
+
+typedef DS::CsrGraph<uint32_t> Graph;
+using DS::XorShift;
+
+template <typename Func>
+double seconds(Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+Graph gridGraph(uint32_t side, uint32_t max_weight, XorShift& r)
+{
+    std::vector<Graph::Edge> edges;
+    edges.reserve(2 * static_cast<std::size_t>(side) * side);
+    for(uint32_t y = 0; y < side; ++y)
+        for(uint32_t x = 0; x < side; ++x)
+        {
+            uint32_t v = y * side + x;
+            if(x + 1 < side)
+                edges.push_back(Graph::Edge{v, v + 1, static_cast<uint32_t>(1 + r.next() % max_weight)});
+            if(y + 1 < side)
+                edges.push_back(Graph::Edge{v, v + side, static_cast<uint32_t>(1 + r.next() % max_weight)});
+        }
+    return Graph::fromEdges(side * side, edges, true);
+}
+
+Graph rmatGraph(uint32_t n, uint64_t m, uint32_t max_weight, XorShift& r)
+{
+    std::vector<Graph::Edge> edges;
+    edges.reserve(m);
+    DS::rmatEdges(n, m, r, [&](uint32_t u, uint32_t v) {
+        edges.push_back(Graph::Edge{u, v, static_cast<uint32_t>(1 + r.next() % max_weight)});
+    });
+    return Graph::fromEdges(n, edges, true);
+}
+
+void report(const std::string& name, double t, bool ok)
+{
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << t * 1000 << " ms" << (ok ? "" : "  MISMATCH!") << std::endl;
+}
+
+template <typename Queue>
+void benchmarkQueue(const std::string& name, const Graph& g, const std::vector<uint32_t>& sources,
+                    const std::vector<std::vector<uint64_t>>& expect)
+{
+    std::vector<uint32_t> parent;
+    bool ok = true;
+    double t = 0;
+    for(std::size_t i = 0; i < sources.size(); ++i)
+    {
+        std::vector<uint64_t> dist;
+        t += seconds([&]() { dist = DS::dijkstraWith<Queue>(g, sources[i], parent); });
+        ok = ok && dist == expect[i];
+    }
+    report(name, t / sources.size(), ok);
+}
+
+void benchmark(const std::string& name, const Graph& g, uint32_t max_weight, unsigned max_threads,
+               int n_sources, uint64_t delta, XorShift& r)
+{
+    if(delta == 0)
+        delta = std::max<uint64_t>(1, 2 * max_weight * g.vertexCount() / std::max<uint64_t>(1, g.edgeCount()));
+    std::cout << name << ": " << g.vertexCount() << " vertices, " << g.edgeCount() << " directed edges, delta "
+              << delta << std::endl;
+    std::vector<uint32_t> sources;
+    while(static_cast<int>(sources.size()) < n_sources)
+    {
+        uint32_t s = static_cast<uint32_t>(r.next() % g.vertexCount());
+        if(g.degree(s) > 0)
+            sources.push_back(s);
+    }
+
+    std::vector<std::vector<uint64_t>> expect(sources.size());
+    std::vector<uint32_t> parent;
+    double t = seconds([&]() {
+        for(std::size_t i = 0; i < sources.size(); ++i)
+            expect[i] = DS::dijkstra(g, sources[i], parent);
+    });
+    report("dijkstra", t / n_sources, true);
+
+    benchmarkQueue<DS::PairingHeapQueue>("pairing", g, sources, expect);
+    benchmarkQueue<DS::RadixHeapQueue>("radix", g, sources, expect);
+
+    for(unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        bool ok = true;
+        t = 0;
+        for(std::size_t i = 0; i < sources.size(); ++i)
+        {
+            std::vector<uint64_t> dist;
+            t += seconds([&]() { dist = DS::deltaStepping(g, sources[i], delta, threads); });
+            ok = ok && dist == expect[i];
+        }
+        report("delta x" + std::to_string(threads), t / n_sources, ok);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t side = argc > 1 ? static_cast<std::size_t>(atol(argv[1])) : 1000;
+    std::size_t degree = argc > 2 ? static_cast<std::size_t>(atol(argv[2])) : 16;
+    unsigned hardware = std::thread::hardware_concurrency();
+    unsigned threads = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : (hardware == 0 ? 4 : hardware);
+    int n_sources = argc > 4 ? atoi(argv[4]) : 4;
+    uint64_t delta = argc > 5 ? static_cast<uint64_t>(atol(argv[5])) : 0;
+    int seed = argc > 6 ? atoi(argv[6]) : 1;
+    if(side < 2 || side > 46340 || degree < 2 || threads < 1 || n_sources < 1)
+    {
+        std::cout << "usage: " << argv[0]
+                  << " [2 <= side <= 46340] [degree >= 2] [threads >= 1] [sources >= 1] [delta] [seed]" << std::endl;
+        return 1;
+    }
+
+    XorShift r{static_cast<uint64_t>(seed)};
+    uint32_t n = static_cast<uint32_t>(side * side);
+    benchmark("grid", gridGraph(static_cast<uint32_t>(side), 1000, r), 1000, threads, n_sources, delta, r);
+    benchmark("rmat", rmatGraph(n, degree * n / 2, 255, r), 255, threads, n_sources, delta, r);
+    return 0;
+}
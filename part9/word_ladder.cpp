@@ -2,6 +2,26 @@
 // Created by DDRHb on 2019/10/7.
 //
 
+// 单词阶梯: 每次改变一个字母，求从一个单词变到另一个单词的最短变换
+// 两种邻接表的对比:
+//   map版   map<string, vector<string>>，每条边都是一个字符串副本，BFS每一步都是按字符串比较的map查找
+//   CSR版   单词映射为连续编号(VertexTable)，邻接表为CsrGraph，BFS在整数数组上进行
+// CSR图还可以用哈希版computeAdjacentGraphHashed建立: 屏蔽一个字母的64位哈希键，基数排序分组，多线程
+// 启动时分别对两种做法计时: 建立邻接表、随机选取的同长单词对的findChain，并检查两者的路径长度相同
+// CSR图上的findChain还有多线程版: 方向优化的ParallelBfs，从起点搜完整个分量(不在找到终点时提前停止)，
+// 词典图中一层的单词不多，主要用来与串行BFS对比
+// 点到点查询在CSR图上还有两种做法(PathQuery，查询之间复用访问标记，不清空O(V)的数组):
+//   双向BFS       从两端同时搜索，每次扩展较小的一侧
+//   A*            以到目标单词的汉明距离为启发函数
+// 报告每种做法单次查询的延迟，以及每个线程一个PathQuery时的多线程吞吐量；交互查询使用双向BFS
+//
+// 给出snapshot_path时把CSR图与单词表写成二进制快照(GraphSnapshot)；
+// 用 --load 启动时mmap载入快照，不读词典也不建图，只做查询
+//
+// 用法: word_ladder [dict_path] [queries] [snapshot_path]
+//       word_ladder --load snapshot_path [queries]
+// 然后每次输入两个单词，输入结束时退出
+
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -10,8 +30,21 @@
 #include <ctime>
 #include <queue>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include "graph.hpp"
+#include "parallel_bfs.hpp"
+#include "path_query.hpp"
+#include "graph_snapshot.hpp"
+#include "../part7/sort.hpp"
+#include "../lib/fork_join.h"
+#include "../lib/uniform_random.h"
 
 using namespace std;
+using DS::CsrGraph;
+using DS::VertexTable;
 
 void readWords(ifstream& in, vector<string>& container)
 {
@@ -68,23 +101,6 @@ void computeAdjacentWords(const vector<string>& words, map<string, vector<string
     }
 }
 
-void printHighChangeables(const map<string, vector<string>>& adj_word, int min_words = 15)
-{
-    if(min_words <= 0)
-        return;
-    for(auto & entry : adj_word)
-    {
-        const vector<string>& words = entry.second;
-        if(words.size() >= min_words)
-        {
-            cout << entry.first << " (" << words.size() << "):";
-            for(auto & str : words)
-                cout << " " << str;
-            cout << endl;
-        }
-    }
-}
-
 vector<string> getChainFromPreviousMap(const map<string,string>& previous,
         const string& first, const string& second)
 {
@@ -132,16 +148,354 @@ vector<string> findChain(const map<string, vector<string>>& adjacent_words,
         return vector<string>{};
 }
 
-int main()
+// CSR版: 与computeAdjacentWords相同的分组方法，分组中存单词编号，边直接加入GraphBuilder
+CsrGraph<> computeAdjacentGraph(const vector<string>& words, VertexTable<string>& table)
+{
+    map<int, vector<uint32_t>> ids_by_length;
+
+    table.reserve(words.size());
+    for(auto & word : words)
+    {
+        uint32_t id = table.intern(word);
+        if(id + 1 == table.size()) // 重复的单词只加入一次
+            ids_by_length[word.size()].push_back(id);
+    }
+
+    DS::GraphBuilder<> builder;
+    builder.reserveVertices(table.size());
+    for(auto & entry : ids_by_length)
+    {
+        const vector<uint32_t> & group_ids{entry.second};
+        int word_length = entry.first;
+
+        for(int i = 0; i < word_length; ++i)
+        {
+            map<string, vector<uint32_t>> rep_to_ids;
+            for(uint32_t id : group_ids)
+            {
+                string rep = table.key(id);
+                rep.erase(i, 1);
+                rep_to_ids[rep].push_back(id);
+            }
+
+            for(auto & entry_rep : rep_to_ids)
+            {
+                const vector<uint32_t> & clique = entry_rep.second;
+                for(size_t p = 0; p < clique.size(); ++p)
+                    for(size_t q = p + 1; q < clique.size(); ++q)
+                        builder.addUndirectedEdge(clique[p], clique[q]);
+            }
+        }
+    }
+    return builder.build();
+}
+
+// 屏蔽一个位置后的单词哈希与单词编号
+struct MaskedKey
+{
+    uint64_t key;
+    uint32_t id;
+};
+
+// a与b除位置i之外都相同
+bool sameExcept(const string& a, const string& b, size_t i)
+{
+    return a.compare(0, i, b, 0, i) == 0 && a.compare(i + 1, string::npos, b, i + 1, string::npos) == 0;
+}
+
+// 哈希版: 不生成去掉一个字母的字符串
+// 每个单词算一次多项式哈希 h = sum(c[j] * BASE^j) (mod 2^64)，屏蔽位置i的键为 h - c[i] * BASE^i，O(1)得到
+// 每个(长度, 位置)为一个任务: 键与编号的数组按键基数排序，键相同的一段就是一个团，
+// 团中的单词与第一个单词逐个比较以排除哈希冲突；任务按分组大小从大到小由各线程动态领取，
+// 每个线程把边存到自己的数组中，最后一起生成CsrGraph
+CsrGraph<> computeAdjacentGraphHashed(const vector<string>& words, VertexTable<string>& table, unsigned n_threads)
+{
+    const uint64_t BASE = 0x100000001b3ull;
+    vector<vector<uint32_t>> ids_by_length;
+
+    table.reserve(words.size());
+    for(auto & word : words)
+    {
+        uint32_t id = table.intern(word);
+        if(id + 1 == table.size())
+        {
+            if(word.size() >= ids_by_length.size())
+                ids_by_length.resize(word.size() + 1);
+            ids_by_length[word.size()].push_back(id);
+        }
+    }
+
+    vector<uint64_t> powers(ids_by_length.size() + 1, 1);
+    for(size_t i = 1; i < powers.size(); ++i)
+        powers[i] = powers[i - 1] * BASE;
+    vector<uint64_t> hashes(table.size());
+    DS::parallelFor(n_threads, table.size(), [&](unsigned, size_t first, size_t last) {
+        for(size_t v = first; v < last; ++v)
+        {
+            uint64_t h = 0;
+            const string& word = table.key(static_cast<uint32_t>(v));
+            for(size_t j = word.size(); j-- > 0;)
+                h = h * BASE + static_cast<unsigned char>(word[j]);
+            hashes[v] = h;
+        }
+    });
+
+    vector<pair<uint32_t, uint32_t>> tasks; // (长度, 位置)
+    for(uint32_t length = 0; length < ids_by_length.size(); ++length)
+        if(ids_by_length[length].size() > 1)
+            for(uint32_t i = 0; i < length; ++i)
+                tasks.push_back(make_pair(length, i));
+    stable_sort(tasks.begin(), tasks.end(), [&](const pair<uint32_t, uint32_t>& a, const pair<uint32_t, uint32_t>& b) {
+        return ids_by_length[a.first].size() > ids_by_length[b.first].size();
+    });
+
+    atomic<size_t> next_task{0};
+    vector<vector<pair<uint32_t, uint32_t>>> local_edges(n_threads);
+    DS::parallelFor(n_threads, n_threads, [&](unsigned thread_id, size_t, size_t) {
+        vector<MaskedKey> keys;
+        vector<pair<uint32_t, uint32_t>>& edges = local_edges[thread_id];
+        for(size_t t; (t = next_task.fetch_add(1)) < tasks.size();)
+        {
+            const vector<uint32_t>& group_ids = ids_by_length[tasks[t].first];
+            uint32_t i = tasks[t].second;
+            keys.clear();
+            for(uint32_t id : group_ids)
+                keys.push_back(MaskedKey{hashes[id] - static_cast<unsigned char>(table.key(id)[i]) * powers[i], id});
+            DS::radixSort(keys.begin(), keys.end(), [](const MaskedKey& k) { return k.key; });
+
+            for(size_t begin = 0, end; begin < keys.size(); begin = end)
+            {
+                for(end = begin + 1; end < keys.size() && keys[end].key == keys[begin].key; ++end)
+                    ;
+                if(end - begin < 2)
+                    continue;
+                const string& first = table.key(keys[begin].id);
+                bool clique = true;
+                for(size_t p = begin + 1; p < end && clique; ++p)
+                    clique = sameExcept(first, table.key(keys[p].id), i);
+                for(size_t p = begin; p < end; ++p)
+                    for(size_t q = p + 1; q < end; ++q)
+                        if(clique || sameExcept(table.key(keys[p].id), table.key(keys[q].id), i))
+                            edges.push_back(make_pair(keys[p].id, keys[q].id));
+            }
+        }
+    });
+
+    vector<pair<uint32_t, uint32_t>> edges;
+    for(auto & local : local_edges)
+        edges.insert(edges.end(), local.begin(), local.end());
+    return CsrGraph<>::fromEdges(table.size(), edges, true);
+}
+
+// 两个图的每个邻接表排序后相同
+bool sameGraph(const CsrGraph<>& a, const CsrGraph<>& b)
+{
+    if(a.vertexCount() != b.vertexCount() || a.edgeCount() != b.edgeCount())
+        return false;
+    for(uint32_t v = 0; v < a.vertexCount(); ++v)
+    {
+        vector<uint32_t> x(a.neighbors(v).begin(), a.neighbors(v).end());
+        vector<uint32_t> y(b.neighbors(v).begin(), b.neighbors(v).end());
+        sort(x.begin(), x.end());
+        sort(y.begin(), y.end());
+        if(x != y)
+            return false;
+    }
+    return true;
+}
+
+void printHighChangeables(const CsrGraph<>& graph, const VertexTable<string>& table, uint32_t min_words = 15)
+{
+    if(min_words == 0)
+        return;
+    for(uint32_t v = 0; v < graph.vertexCount(); ++v)
+    {
+        if(graph.degree(v) >= min_words)
+        {
+            cout << table.key(v) << " (" << graph.degree(v) << "):";
+            for(uint32_t w : graph.neighbors(v))
+                cout << " " << table.key(w);
+            cout << endl;
+        }
+    }
+}
+
+// CSR版的BFS，找到second后停止
+vector<string> findChain(const CsrGraph<>& graph, const VertexTable<string>& table,
+        const string& first, const string& second)
+{
+    uint32_t source = table.find(first);
+    uint32_t target = table.find(second);
+    vector<string> result;
+    if(source == DS::NO_VERTEX || target == DS::NO_VERTEX)
+        return result;
+    vector<uint32_t> parent;
+    DS::bfs(graph, source, parent, target);
+    for(uint32_t v : DS::pathTo(parent, source, target))
+        result.push_back(table.key(v));
+    return result;
+}
+
+// ParallelBfs版，bfs在多次查询间复用
+vector<string> findChain(DS::ParallelBfs<>& bfs, const VertexTable<string>& table,
+        const string& first, const string& second)
+{
+    uint32_t source = table.find(first);
+    uint32_t target = table.find(second);
+    vector<string> result;
+    if(source == DS::NO_VERTEX || target == DS::NO_VERTEX)
+        return result;
+    bfs.run(source);
+    for(uint32_t v : bfs.path(target))
+        result.push_back(table.key(v));
+    return result;
+}
+
+// 同长单词的汉明距离；每一步只改变一个字母，所以是到目标步数的一致下界
+uint32_t hamming(const string& a, const string& b)
+{
+    uint32_t distance = 0;
+    for(size_t i = 0; i < a.size(); ++i)
+        distance += a[i] != b[i];
+    return distance;
+}
+
+// Table为VertexTable或GraphSnapshot，都有find与key
+template <typename Table>
+vector<string> toWords(const vector<uint32_t>& path, const Table& table)
+{
+    vector<string> result;
+    for(uint32_t v : path)
+        result.push_back(table.key(v));
+    return result;
+}
+
+// 双向BFS，长度不同的单词不在同一分量中
+template <typename Graph, typename Table>
+vector<string> findChainBidirectional(DS::PathQuery<Graph>& query, const Table& table,
+        const string& first, const string& second)
+{
+    uint32_t source = table.find(first);
+    uint32_t target = table.find(second);
+    if(source == DS::NO_VERTEX || target == DS::NO_VERTEX || first.size() != second.size())
+        return vector<string>{};
+    return toWords(query.bidirectional(source, target), table);
+}
+
+// A*，启发函数为到second的汉明距离
+template <typename Graph, typename Table>
+vector<string> findChainAStar(DS::PathQuery<Graph>& query, const Table& table,
+        const string& first, const string& second)
+{
+    uint32_t source = table.find(first);
+    uint32_t target = table.find(second);
+    if(source == DS::NO_VERTEX || target == DS::NO_VERTEX || first.size() != second.size())
+        return vector<string>{};
+    return toWords(query.aStar(source, target, [&](uint32_t v) { return hamming(table.key(v), second); }), table);
+}
+
+// 随机选取queries对长度为5的单词
+vector<pair<string, string>> randomPairs(const vector<string>& five, int queries)
+{
+    vector<pair<string, string>> pairs;
+    DS::UniformRandom r{1};
+    for(int i = 0; i < queries && !five.empty(); ++i)
+        pairs.push_back(make_pair(five[r.nextInt(0, five.size() - 1)], five[r.nextInt(0, five.size() - 1)]));
+    return pairs;
+}
+
+// 交互查询，使用双向BFS
+template <typename Graph, typename Table>
+void interact(DS::PathQuery<Graph>& query, const Table& table)
+{
+    string w1, w2;
+    while(cout << "Enter two words:" && cin >> w1 >> w2)
+    {
+        vector<string> path = findChainBidirectional(query, table, w1, w2);
+        cout << path.size() << " (" << query.visited() << " words visited)" << endl;
+        for(string& word : path)
+            cout << word << " ";
+        cout << endl;
+    }
+    cout << endl;
+}
+
+// 执行一次查询，把用时(微秒)加入latency
+template <typename Func>
+vector<string> timeQuery(vector<double>& latency, Func func)
+{
+    auto begin = chrono::steady_clock::now();
+    vector<string> result = func();
+    auto end = chrono::steady_clock::now();
+    latency.push_back(chrono::duration<double, micro>(end - begin).count());
+    return result;
+}
+
+// 延迟的平均值、中位数、99%分位与最大值；visited不为0时报告平均访问的单词数
+void reportLatency(const string& name, vector<double> latency, const vector<size_t>& found,
+        const vector<size_t>& expect, uint64_t visited)
 {
+    if(latency.empty())
+        return;
+    sort(latency.begin(), latency.end());
+    double total = 0;
+    for(double t : latency)
+        total += t;
+    cout << "  " << name << " latency (us): mean " << total / latency.size()
+         << ", p50 " << latency[latency.size() / 2]
+         << ", p99 " << latency[latency.size() * 99 / 100]
+         << ", max " << latency.back();
+    if(visited > 0)
+        cout << ", " << visited / latency.size() << " words visited";
+    cout << (found == expect ? "" : "  MISMATCH!") << endl;
+}
+
+// 从快照启动: mmap载入后直接查询，不读词典、不建图
+int serveSnapshot(const string& path, int queries)
+{
+    auto load_start = chrono::steady_clock::now();
+    DS::GraphSnapshot snapshot(path);
+    double load_time = chrono::duration<double, milli>(chrono::steady_clock::now() - load_start).count();
+    cout << "Elapsed time LOAD: " << load_time << " ms (" << snapshot.vertexCount() << " words, "
+         << snapshot.edgeCount() << " edges, " << snapshot.fileSize() << " bytes)" << endl;
+
+    vector<string> five;
+    for(uint32_t v = 0; v < snapshot.vertexCount(); ++v)
+        if(snapshot.keyChars(v).size() == 5)
+            five.push_back(snapshot.key(v));
+    vector<pair<string, string>> pairs = randomPairs(five, queries);
+
+    DS::PathQuery<DS::GraphSnapshot> query(snapshot);
+    vector<size_t> found;
+    vector<double> latency;
+    uint64_t visited = 0;
+    for(auto & p : pairs)
+    {
+        found.push_back(timeQuery(latency, [&]() {
+            return findChainBidirectional(query, snapshot, p.first, p.second); }).size());
+        visited += query.visited();
+    }
+    cout << pairs.size() << " findChain queries on the snapshot" << endl;
+    reportLatency("bidirectional", latency, found, found, visited);
+
+    interact(query, snapshot);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc > 2 && string(argv[1]) == "--load")
+        return serveSnapshot(argv[2], argc > 3 ? atoi(argv[3]) : 100);
+
     clock_t start, end;
-    ifstream file("../dict.txt");
+    ifstream file(argc > 1 ? argv[1] : "../dict.txt");
     if (!file.is_open())
     {
         cout << "Error opening file";
         exit (1);
     }
-    vector<string> words(32, string{});
+    int queries = argc > 2 ? atoi(argv[2]) : 100;
+    vector<string> words;
     // read words from dict.txt
     readWords(file, words);
 
@@ -152,18 +506,103 @@ int main()
     end = clock();
     cout << "Elapsed time FAST: " << double(end - start) / CLOCKS_PER_SEC << endl;
 
-    printHighChangeables(adjacent_words, 15);
+    VertexTable<string> table;
+    start = clock();
+    CsrGraph<> graph = computeAdjacentGraph(words, table);
+    end = clock();
+    cout << "Elapsed time CSR: " << double(end - start) / CLOCKS_PER_SEC << " ("
+         << graph.vertexCount() << " words, " << graph.edgeCount() << " edges)" << endl;
 
-    while(true)
+    for(unsigned n_threads = 1; n_threads <= max(1u, thread::hardware_concurrency()); n_threads *= 2)
     {
-        cout << "Enter two words:";
-        string w1, w2;
-        cin >> w1 >> w2;
-        vector<string> path = findChain(adjacent_words, w1, w2);
-        cout << path.size() << endl;
-        for(string& word : path)
-            cout << word << " ";
-        cout << endl;
+        VertexTable<string> hashed_table;
+        auto hashed_start = chrono::steady_clock::now();
+        CsrGraph<> hashed = computeAdjacentGraphHashed(words, hashed_table, n_threads);
+        double hashed_time = chrono::duration<double>(chrono::steady_clock::now() - hashed_start).count();
+        cout << "Elapsed time HASH x" << n_threads << ": " << hashed_time
+             << (sameGraph(graph, hashed) ? "" : "  MISMATCH!") << endl;
     }
+
+    printHighChangeables(graph, table, 15);
+
+    // 随机选取长度为5的单词对
+    vector<string> five;
+    for(auto & word : words)
+        if(word.size() == 5)
+            five.push_back(word);
+    vector<pair<string, string>> pairs = randomPairs(five, queries);
+
+    // 每种做法逐个计时，报告单次查询的延迟，路径长度与map版比较
+    vector<size_t> lengths;
+    vector<double> latency;
+    start = clock();
+    for(auto & p : pairs)
+        lengths.push_back(timeQuery(latency, [&]() { return findChain(adjacent_words, p.first, p.second); }).size());
+    end = clock();
+    cout << pairs.size() << " findChain queries, map total: " << double(end - start) / CLOCKS_PER_SEC << " s" << endl;
+    reportLatency("map BFS", latency, lengths, lengths, 0);
+
+    vector<size_t> found;
+    latency.clear();
+    for(auto & p : pairs)
+        found.push_back(timeQuery(latency, [&]() { return findChain(graph, table, p.first, p.second); }).size());
+    reportLatency("CSR BFS", latency, found, lengths, 0);
+
+    for(unsigned n_threads = 1; n_threads <= max(1u, thread::hardware_concurrency()); n_threads *= 2)
+    {
+        DS::ParallelBfs<> bfs(graph, n_threads);
+        found.clear();
+        latency.clear();
+        for(auto & p : pairs)
+            found.push_back(timeQuery(latency, [&]() { return findChain(bfs, table, p.first, p.second); }).size());
+        reportLatency("parallel BFS x" + to_string(n_threads), latency, found, lengths, 0);
+    }
+
+    // 双向BFS与A*共用一个PathQuery，查询之间不清空访问标记
+    DS::PathQuery<> query(graph);
+    uint64_t visited = 0;
+    found.clear();
+    latency.clear();
+    for(auto & p : pairs)
+    {
+        found.push_back(timeQuery(latency, [&]() {
+            return findChainBidirectional(query, table, p.first, p.second); }).size());
+        visited += query.visited();
+    }
+    reportLatency("bidirectional", latency, found, lengths, visited);
+
+    visited = 0;
+    found.clear();
+    latency.clear();
+    for(auto & p : pairs)
+    {
+        found.push_back(timeQuery(latency, [&]() { return findChainAStar(query, table, p.first, p.second); }).size());
+        visited += query.visited();
+    }
+    reportLatency("A* (Hamming)", latency, found, lengths, visited);
+
+    // 多线程: 每个线程一个PathQuery，共享图与顶点表
+    unsigned n_threads = max(1u, thread::hardware_concurrency());
+    found.assign(pairs.size(), 0);
+    auto wall_start = chrono::steady_clock::now();
+    DS::parallelFor(n_threads, pairs.size(), [&](unsigned, size_t begin, size_t end) {
+        DS::PathQuery<> local(graph);
+        for(size_t i = begin; i < end; ++i)
+            found[i] = findChainBidirectional(local, table, pairs[i].first, pairs[i].second).size();
+    });
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - wall_start).count();
+    cout << "  bidirectional x" << n_threads << ": " << pairs.size() / wall << " queries/s"
+         << (found == lengths ? "" : "  MISMATCH!") << endl;
+
+    // 保存快照，之后用 --load 启动
+    if(argc > 3)
+    {
+        auto write_start = chrono::steady_clock::now();
+        DS::GraphSnapshot::write(argv[3], graph, table);
+        cout << "Snapshot written to " << argv[3] << " in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - write_start).count() << " ms" << endl;
+    }
+
+    interact(query, table);
     return 0;
-}
\ No newline at end of file
+}